@@ -1,8 +1,10 @@
 #ifndef __algorithm_intersect__
 #define __algorithm_intersect__
 
+#include "intersect/box_line_batch_intersect.h"
 #include "intersect/box_line_intersect.h"
 #include "intersect/line_intersect.h"
+#include "intersect/segments_intersect.h"
 
 namespace CMTL {
 namespace algorithm {}  // namespace algorithm
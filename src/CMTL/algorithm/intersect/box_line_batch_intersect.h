@@ -0,0 +1,265 @@
+#ifndef __algorithm_box_line_batch_intersect__
+#define __algorithm_box_line_batch_intersect__
+
+#include "box_line_intersect.h"
+
+#include <cstddef>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace CMTL {
+namespace algorithm {
+
+namespace internal {
+
+/* vector lanes used by the batch intersections, size is 1 if the number type
+ * has no vector instructions */
+template <typename T>
+struct BoxLineLanes {
+  static constexpr unsigned size = 1;
+};
+
+#if defined(__AVX__)
+
+template <>
+struct BoxLineLanes<float> {
+  typedef __m256 Vec;
+  static constexpr unsigned size = 8;
+  static Vec load(const float* p) { return _mm256_loadu_ps(p); }
+  static void store(float* p, Vec a) { _mm256_storeu_ps(p, a); }
+  static Vec set1(float a) { return _mm256_set1_ps(a); }
+  static Vec sub(Vec a, Vec b) { return _mm256_sub_ps(a, b); }
+  static Vec div(Vec a, Vec b) { return _mm256_div_ps(a, b); }
+  static Vec min(Vec a, Vec b) { return _mm256_min_ps(a, b); }
+  static Vec max(Vec a, Vec b) { return _mm256_max_ps(a, b); }
+  static Vec eq(Vec a, Vec b) { return _mm256_cmp_ps(a, b, _CMP_EQ_OQ); }
+  static Vec lt(Vec a, Vec b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+  static Vec le(Vec a, Vec b) { return _mm256_cmp_ps(a, b, _CMP_LE_OQ); }
+  static Vec bit_or(Vec a, Vec b) { return _mm256_or_ps(a, b); }
+  static Vec bit_and(Vec a, Vec b) { return _mm256_and_ps(a, b); }
+  static Vec bit_andnot(Vec a, Vec b) { return _mm256_andnot_ps(a, b); }
+  static int mask(Vec a) { return _mm256_movemask_ps(a); }
+};
+
+template <>
+struct BoxLineLanes<double> {
+  typedef __m256d Vec;
+  static constexpr unsigned size = 4;
+  static Vec load(const double* p) { return _mm256_loadu_pd(p); }
+  static void store(double* p, Vec a) { _mm256_storeu_pd(p, a); }
+  static Vec set1(double a) { return _mm256_set1_pd(a); }
+  static Vec sub(Vec a, Vec b) { return _mm256_sub_pd(a, b); }
+  static Vec div(Vec a, Vec b) { return _mm256_div_pd(a, b); }
+  static Vec min(Vec a, Vec b) { return _mm256_min_pd(a, b); }
+  static Vec max(Vec a, Vec b) { return _mm256_max_pd(a, b); }
+  static Vec eq(Vec a, Vec b) { return _mm256_cmp_pd(a, b, _CMP_EQ_OQ); }
+  static Vec lt(Vec a, Vec b) { return _mm256_cmp_pd(a, b, _CMP_LT_OQ); }
+  static Vec le(Vec a, Vec b) { return _mm256_cmp_pd(a, b, _CMP_LE_OQ); }
+  static Vec bit_or(Vec a, Vec b) { return _mm256_or_pd(a, b); }
+  static Vec bit_and(Vec a, Vec b) { return _mm256_and_pd(a, b); }
+  static Vec bit_andnot(Vec a, Vec b) { return _mm256_andnot_pd(a, b); }
+  static int mask(Vec a) { return _mm256_movemask_pd(a); }
+};
+
+#elif defined(__SSE2__)
+
+template <>
+struct BoxLineLanes<float> {
+  typedef __m128 Vec;
+  static constexpr unsigned size = 4;
+  static Vec load(const float* p) { return _mm_loadu_ps(p); }
+  static void store(float* p, Vec a) { _mm_storeu_ps(p, a); }
+  static Vec set1(float a) { return _mm_set1_ps(a); }
+  static Vec sub(Vec a, Vec b) { return _mm_sub_ps(a, b); }
+  static Vec div(Vec a, Vec b) { return _mm_div_ps(a, b); }
+  static Vec min(Vec a, Vec b) { return _mm_min_ps(a, b); }
+  static Vec max(Vec a, Vec b) { return _mm_max_ps(a, b); }
+  static Vec eq(Vec a, Vec b) { return _mm_cmpeq_ps(a, b); }
+  static Vec lt(Vec a, Vec b) { return _mm_cmplt_ps(a, b); }
+  static Vec le(Vec a, Vec b) { return _mm_cmple_ps(a, b); }
+  static Vec bit_or(Vec a, Vec b) { return _mm_or_ps(a, b); }
+  static Vec bit_and(Vec a, Vec b) { return _mm_and_ps(a, b); }
+  static Vec bit_andnot(Vec a, Vec b) { return _mm_andnot_ps(a, b); }
+  static int mask(Vec a) { return _mm_movemask_ps(a); }
+};
+
+template <>
+struct BoxLineLanes<double> {
+  typedef __m128d Vec;
+  static constexpr unsigned size = 2;
+  static Vec load(const double* p) { return _mm_loadu_pd(p); }
+  static void store(double* p, Vec a) { _mm_storeu_pd(p, a); }
+  static Vec set1(double a) { return _mm_set1_pd(a); }
+  static Vec sub(Vec a, Vec b) { return _mm_sub_pd(a, b); }
+  static Vec div(Vec a, Vec b) { return _mm_div_pd(a, b); }
+  static Vec min(Vec a, Vec b) { return _mm_min_pd(a, b); }
+  static Vec max(Vec a, Vec b) { return _mm_max_pd(a, b); }
+  static Vec eq(Vec a, Vec b) { return _mm_cmpeq_pd(a, b); }
+  static Vec lt(Vec a, Vec b) { return _mm_cmplt_pd(a, b); }
+  static Vec le(Vec a, Vec b) { return _mm_cmple_pd(a, b); }
+  static Vec bit_or(Vec a, Vec b) { return _mm_or_pd(a, b); }
+  static Vec bit_and(Vec a, Vec b) { return _mm_and_pd(a, b); }
+  static Vec bit_andnot(Vec a, Vec b) { return _mm_andnot_pd(a, b); }
+  static int mask(Vec a) { return _mm_movemask_pd(a); }
+};
+
+#endif
+
+/* one slab of the vector Liang-Barsky algorithm, lanes with a zero direction
+ * keep their range and are missed if they are outside of the slab */
+template <typename Lanes, typename Vec>
+void clip_slab_lanes(Vec lo, Vec hi, Vec ori, Vec dir, Vec& t0, Vec& t1,
+                     Vec& miss) {
+  Vec parallel = Lanes::eq(dir, Lanes::set1(0));
+  Vec ta = Lanes::div(Lanes::sub(lo, ori), dir);
+  Vec tb = Lanes::div(Lanes::sub(hi, ori), dir);
+  // the quotients of parallel lanes are inf or nan, they are masked out
+  Vec t_enter = Lanes::bit_andnot(parallel, Lanes::min(ta, tb));
+  Vec t_leave = Lanes::bit_andnot(parallel, Lanes::max(ta, tb));
+  t0 = Lanes::max(t0, Lanes::bit_or(t_enter, Lanes::bit_and(parallel, t0)));
+  t1 = Lanes::min(t1, Lanes::bit_or(t_leave, Lanes::bit_and(parallel, t1)));
+  Vec outside = Lanes::bit_or(Lanes::lt(ori, lo), Lanes::lt(hi, ori));
+  miss = Lanes::bit_or(miss, Lanes::bit_and(parallel, outside));
+}
+
+/* clip the segment (x0, y0) + t * (dx, dy), t in [0, 1], against a box */
+template <typename T>
+bool clip_segment(const T& left, const T& right, const T& bottom,
+                  const T& top, const T& x0, const T& y0, const T& dx,
+                  const T& dy, T& t0, T& t1) {
+  bool has_t0 = true, has_t1 = true;
+  t0 = T(0);
+  t1 = T(1);
+  return clip_slab(left, right, x0, dx, t0, has_t0, t1, has_t1) &&
+         clip_slab(bottom, top, y0, dy, t0, has_t0, t1, has_t1);
+}
+
+/* clip n segment/box pairs, get(i) loads the lanes of the pair i */
+template <typename T, typename Get, typename ScalarGet>
+size_t clip_segments_batch(size_t n, const Get& get, const ScalarGet& scalar,
+                           T* t0, T* t1, unsigned char* hit) {
+  typedef BoxLineLanes<T> Lanes;
+  size_t n_hits = 0, i = 0;
+  if constexpr (Lanes::size > 1) {
+    typedef typename Lanes::Vec Vec;
+    for (; i + Lanes::size <= n; i += Lanes::size) {
+      Vec left, right, bottom, top, x0, y0, x1, y1;
+      get(i, left, right, bottom, top, x0, y0, x1, y1);
+      Vec lo = Lanes::set1(0), hi = Lanes::set1(1), miss = Lanes::set1(0);
+      clip_slab_lanes<Lanes>(left, right, x0, Lanes::sub(x1, x0), lo, hi,
+                             miss);
+      clip_slab_lanes<Lanes>(bottom, top, y0, Lanes::sub(y1, y0), lo, hi,
+                             miss);
+      Lanes::store(t0 + i, lo);
+      Lanes::store(t1 + i, hi);
+      int mask = Lanes::mask(Lanes::bit_andnot(miss, Lanes::le(lo, hi)));
+      for (unsigned k = 0; k < Lanes::size; ++k) {
+        hit[i + k] = (mask >> k) & 1;
+        n_hits += hit[i + k];
+      }
+    }
+  }
+  for (; i < n; ++i) {
+    hit[i] = scalar(i, t0[i], t1[i]);
+    n_hits += hit[i];
+  }
+  return n_hits;
+}
+
+}  // namespace internal
+
+/**
+ * @brief clip an array of segments against a box, the segments are given as
+ * structure of arrays, float and double use SSE or AVX lanes
+ * @tparam T number type
+ * @param x0, y0 first end points of the segments
+ * @param x1, y1 second end points of the segments
+ * @param n number of segments
+ * @param t0 first intersect parameter on each segment, undefined if missed
+ * @param t1 second intersect parameter on each segment, undefined if missed
+ * @param hit 1 if the segment intersects the box, otherwise 0
+ * @return number of segments intersecting the box
+ */
+template <typename T>
+size_t intersect_segments(const geo2d::Box<T>& box, const T* x0, const T* y0,
+                          const T* x1, const T* y1, size_t n, T* t0, T* t1,
+                          unsigned char* hit) {
+  typedef internal::BoxLineLanes<T> Lanes;
+  auto scalar = [&](size_t i, T& s0, T& s1) {
+    return internal::clip_segment<T>(box.left(), box.right(), box.bottom(),
+                                  box.top(), x0[i], y0[i], x1[i] - x0[i],
+                                  y1[i] - y0[i], s0, s1);
+  };
+  if constexpr (Lanes::size > 1) {
+    typedef typename Lanes::Vec Vec;
+    Vec left = Lanes::set1(box.left()), right = Lanes::set1(box.right());
+    Vec bottom = Lanes::set1(box.bottom()), top = Lanes::set1(box.top());
+    auto get = [&](size_t i, Vec& l, Vec& r, Vec& b, Vec& t, Vec& sx0,
+                   Vec& sy0, Vec& sx1, Vec& sy1) {
+      l = left;
+      r = right;
+      b = bottom;
+      t = top;
+      sx0 = Lanes::load(x0 + i);
+      sy0 = Lanes::load(y0 + i);
+      sx1 = Lanes::load(x1 + i);
+      sy1 = Lanes::load(y1 + i);
+    };
+    return internal::clip_segments_batch(n, get, scalar, t0, t1, hit);
+  } else {
+    return internal::clip_segments_batch(n, nullptr, scalar, t0, t1, hit);
+  }
+}
+
+/**
+ * @brief clip a segment against an array of boxes, the boxes are given as
+ * structure of arrays, float and double use SSE or AVX lanes
+ * @tparam T number type
+ * @param left, right, bottom, top bounds of the boxes
+ * @param n number of boxes
+ * @param t0 first intersect parameter in each box, undefined if missed
+ * @param t1 second intersect parameter in each box, undefined if missed
+ * @param hit 1 if the segment intersects the box, otherwise 0
+ * @return number of boxes intersecting the segment
+ */
+template <typename T>
+size_t intersect_boxes(const geo2d::Segment<T>& segment, const T* left,
+                       const T* right, const T* bottom, const T* top, size_t n,
+                       T* t0, T* t1, unsigned char* hit) {
+  typedef internal::BoxLineLanes<T> Lanes;
+  const T &x0 = segment.first().x(), &y0 = segment.first().y();
+  const T &x1 = segment.second().x(), &y1 = segment.second().y();
+  T dx = x1 - x0, dy = y1 - y0;
+  auto scalar = [&](size_t i, T& s0, T& s1) {
+    return internal::clip_segment<T>(left[i], right[i], bottom[i], top[i], x0,
+                                  y0, dx, dy, s0, s1);
+  };
+  if constexpr (Lanes::size > 1) {
+    typedef typename Lanes::Vec Vec;
+    Vec vx0 = Lanes::set1(x0), vy0 = Lanes::set1(y0);
+    Vec vx1 = Lanes::set1(x1), vy1 = Lanes::set1(y1);
+    auto get = [&](size_t i, Vec& l, Vec& r, Vec& b, Vec& t, Vec& sx0,
+                   Vec& sy0, Vec& sx1, Vec& sy1) {
+      l = Lanes::load(left + i);
+      r = Lanes::load(right + i);
+      b = Lanes::load(bottom + i);
+      t = Lanes::load(top + i);
+      sx0 = vx0;
+      sy0 = vy0;
+      sx1 = vx1;
+      sy1 = vy1;
+    };
+    return internal::clip_segments_batch(n, get, scalar, t0, t1, hit);
+  } else {
+    return internal::clip_segments_batch(n, nullptr, scalar, t0, t1, hit);
+  }
+}
+
+}  // namespace algorithm
+}  // namespace CMTL
+
+#endif  // __algorithm_box_line_batch_intersect__
@@ -4,84 +4,53 @@
 #include "../../geo2d/box.h"
 #include "../../geo2d/segment.h"
 
+#include <utility>
+
 namespace CMTL {
 namespace algorithm {
 
+namespace internal {
+
+/* clip the parameter range [t0, t1] of ori + t * dir against the slab
+ * lo <= x <= hi, an unbounded end becomes bounded once clipped */
+template <typename T>
+bool clip_slab(const T& lo, const T& hi, const T& ori, const T& dir, T& t0,
+               bool& has_t0, T& t1, bool& has_t1) {
+  if (dir == 0) return ori >= lo && ori <= hi;
+  T t_enter = (lo - ori) / dir;
+  T t_leave = (hi - ori) / dir;
+  if (dir < 0) std::swap(t_enter, t_leave);
+  if ((has_t0 && t_leave < t0) || (has_t1 && t_enter > t1)) return false;
+  if (!has_t0 || t_enter > t0) t0 = t_enter;
+  if (!has_t1 || t_leave < t1) t1 = t_leave;
+  has_t0 = has_t1 = true;
+  return true;
+}
+
+}  // namespace internal
+
+/**
+ * @brief clip the parameter range of the line ori + t * dir against a box
+ * with the Liang-Barsky algorithm
+ * @tparam T number type
+ * @param t0 first intersect parameter, only used as a bound if has_t0
+ * @param has_t0 whether t0 bounds the range, true if the range is clipped
+ * @param t1 second intersect parameter, only used as a bound if has_t1
+ * @param has_t1 whether t1 bounds the range, true if the range is clipped
+ * @return true if intersect, otherwise false
+ */
 template <typename T>
 bool intersect(const geo2d::Box<T>& box, const geo2d::Point<T>& ori,
-               const geo2d::Point<T>& dir, T*& t0, T*& t1) {
-  // https://en.wikipedia.org/wiki/Liang%E2%80%93Barsky_algorith
+               const geo2d::Point<T>& dir, T& t0, bool& has_t0, T& t1,
+               bool& has_t1) {
+  // https://en.wikipedia.org/wiki/Liang%E2%80%93Barsky_algorithm
 
   assert(dir != geo2d::Point<T>::Origin);
 
-  T p1 = -dir.x(), p2 = dir.x(), p3 = -dir.y(), p4 = dir.y();
-  T q1 = ori.x() - box.left(), q2 = box.right() - ori.x(),
-    q3 = ori.y() - box.bottom(), q4 = box.top() - ori.y();
-
-  if (p1 == 0 && (q1 < 0 || q2 < 0)) return false;
-  if (p3 == 0 && (q3 < 0 || q4 < 0)) return false;
-
-  if (p1 != 0) {
-    T q1_p1 = q1 / p1;
-    T q2_p2 = q2 / p2;
-    if (p1 > 0) {
-      if ((t0 && q1_p1 < *t0) || (t1 && q2_p2 > *t1)) return false;
-
-      if (t1 && q1_p1 < *t1)
-        *t1 = q1_p1;
-      else if (!t1)
-        t1 = new T(q1_p1);
-
-      if (t0 && q2_p2 > *t0)
-        *t0 = q2_p2;
-      else if (!t0)
-        t0 = new T(q2_p2);
-    } else {
-      if ((t0 && q2_p2 < *t0) || (t1 && q1_p1 > *t1)) return false;
-
-      if (t1 && q2_p2 < *t1)
-        *t1 = q2_p2;
-      else if (!t1)
-        t1 = new T(q2_p2);
-
-      if (t0 && q1_p1 > *t0)
-        *t0 = q1_p1;
-      else if (!t0)
-        t0 = new T(q1_p1);
-    }
-  }
-
-  if (p3 != 0) {
-    T q3_p3 = q3 / p3;
-    T q4_p4 = q4 / p4;
-    if (p3 > 0) {
-      if ((t0 && q3_p3 < *t0) || (t1 && q4_p4 > *t1)) return false;
-
-      if (t1 && q3_p3 < *t1)
-        *t1 = q3_p3;
-      else if (!t1)
-        t1 = new T(q3_p3);
-
-      if (t0 && q4_p4 > *t0)
-        *t0 = q4_p4;
-      else if (!t0)
-        t0 = new T(q4_p4);
-    } else {
-      if ((t0 && q4_p4 < *t0) || (t1 && q3_p3 > *t1)) return false;
-
-      if (t1 && q4_p4 < *t1)
-        *t1 = q4_p4;
-      else if (!t1)
-        t1 = new T(q4_p4);
-
-      if (t0 && q3_p3 > *t0)
-        *t0 = q3_p3;
-      else if (!t0)
-        t0 = new T(q3_p3);
-    }
-  }
-
-  return true;
+  return internal::clip_slab(box.left(), box.right(), ori.x(), dir.x(), t0,
+                             has_t0, t1, has_t1) &&
+         internal::clip_slab(box.bottom(), box.top(), ori.y(), dir.y(), t0,
+                             has_t0, t1, has_t1);
 }
 
 /**
@@ -94,17 +63,14 @@ bool intersect(const geo2d::Box<T>& box, const geo2d::Point<T>& ori,
 template <typename T>
 bool intersect(const geo2d::Box<T>& box, const geo2d::Segment<T>& segment,
                T& t0, T& t1) {
-  T* t_min = new T(0);
-  T* t_max = new T(1);
-  bool result =
-      intersect(box, segment.first(), segment.direction(), t_min, t_max);
-  if (result) {
-    t0 = *t_min;
-    t1 = *t_max;
-  }
-  delete t_min;
-  delete t_max;
-  return result;
+  T t_min(0), t_max(1);
+  bool has_t_min = true, has_t_max = true;
+  if (!intersect(box, segment.first(), segment.direction(), t_min, has_t_min,
+                 t_max, has_t_max))
+    return false;
+  t0 = t_min;
+  t1 = t_max;
+  return true;
 }
 
 /**
@@ -130,17 +96,12 @@ bool intersect(const geo2d::Segment<T>& segment, const geo2d::Box<T>& box,
 template <typename T>
 bool intersect(const geo2d::Box<T>& box, const geo2d::Line<T>& line, T& t0,
                T& t1) {
-  T* t_min = nullptr;
-  T* t_max = nullptr;
-  bool result = intersect(box, line.origin(), line.direction(), t_min, t_max);
-  if (t_min) {
-    t0 = *t_min;
-    delete t_min;
-  }
-  if (t_max) {
-    t1 = *t_max;
-    delete t_max;
-  }
+  T t_min, t_max;
+  bool has_t_min = false, has_t_max = false;
+  bool result = intersect(box, line.origin(), line.direction(), t_min,
+                          has_t_min, t_max, has_t_max);
+  if (has_t_min) t0 = t_min;
+  if (has_t_max) t1 = t_max;
   return result;
 }
 
@@ -167,17 +128,12 @@ bool intersect(const geo2d::Line<T>& line, const geo2d::Box<T>& box, T& t0,
 template <typename T>
 bool intersect(const geo2d::Box<T>& box, const geo2d::Ray<T>& ray, T& t0,
                T& t1) {
-  T* t_min = new T(0);
-  T* t_max = nullptr;
-  bool result = intersect(box, ray.origin(), ray.direction(), t_min, t_max);
-  if (t_min) {
-    t0 = *t_min;
-    delete t_min;
-  }
-  if (t_max) {
-    t1 = *t_max;
-    delete t_max;
-  }
+  T t_min(0), t_max;
+  bool has_t_min = true, has_t_max = false;
+  bool result = intersect(box, ray.origin(), ray.direction(), t_min,
+                          has_t_min, t_max, has_t_max);
+  t0 = t_min;
+  if (has_t_max) t1 = t_max;
   return result;
 }
 
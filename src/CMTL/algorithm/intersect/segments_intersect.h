@@ -0,0 +1,239 @@
+#ifndef __algorithm_segments_intersect__
+#define __algorithm_segments_intersect__
+
+#include "../../geo2d/segment.h"
+#include "../predicate.h"
+
+#include <map>
+#include <set>
+#include <utility>
+#include <vector>
+
+namespace CMTL {
+namespace algorithm {
+
+/**
+ * @brief an intersection between two segments of a set
+ * @tparam T number type
+ */
+template <typename T>
+struct SegmentIntersection {
+  /* indices of the two segments, first < second */
+  unsigned first;
+  unsigned second;
+  /* the smallest common point in (x, y) order, exact for exact number types
+   * such as mpq_class, rounded otherwise */
+  geo2d::Point<T> point;
+};
+
+namespace internal {
+
+/* Bentley-Ottmann sweep from left to right, the events are the end points
+ * and the crossings in (x, y) order and the status keeps the segments which
+ * cross the sweep line from bottom to top */
+template <typename T>
+class SegmentSweep {
+ public:
+  typedef geo2d::Point<T> Point;
+
+  SegmentSweep(const std::vector<geo2d::Segment<T>>& segments, bool open)
+      : _open(open), _status(StatusCompare{this}) {
+    _ends.reserve(segments.size());
+    for (unsigned i = 0; i < segments.size(); ++i) {
+      const Point& p = segments[i].first();
+      const Point& q = segments[i].second();
+      _ends.push_back(q < p ? std::make_pair(q, p) : std::make_pair(p, q));
+      _events[_ends[i].first].starting.push_back(i);
+      _events[_ends[i].second];
+    }
+    _crossing.assign(segments.size(), 0);
+  }
+
+ public:
+  bool execute(std::vector<SegmentIntersection<T>>& intersections,
+               bool first_only) {
+    intersections.clear();
+    std::vector<unsigned> through, starting, crossing;
+    while (!_events.empty()) {
+      auto event = _events.begin();
+      _sweep = event->first;
+      starting.swap(event->second.starting);
+      crossing.swap(event->second.crossing);
+      _events.erase(event);
+      for (unsigned s : crossing) _crossing[s] = 1;
+
+      // the segments containing the event point are contiguous
+      auto range = _status.equal_range(_sweep);
+      through.assign(range.first, range.second);
+      _status.erase(range.first, range.second);
+
+      if (report(through, starting, intersections) && first_only)
+        return true;
+
+      // reinsert the segments which continue after the event point, they are
+      // now ordered as just right of it
+      for (unsigned s : through)
+        if (!(_ends[s].second == _sweep)) _status.insert(s);
+      for (unsigned s : starting)
+        if (!(_ends[s].second == _sweep)) _status.insert(s);
+
+      range = _status.equal_range(_sweep);
+      auto above = range.second;
+      if (range.first == range.second) {
+        if (above != _status.begin() && above != _status.end())
+          add_crossing(*std::prev(above), *above);
+      } else {
+        if (range.first != _status.begin())
+          add_crossing(*std::prev(range.first), *range.first);
+        if (above != _status.end()) add_crossing(*std::prev(above), *above);
+      }
+      for (unsigned s : crossing) _crossing[s] = 0;
+    }
+    return !intersections.empty();
+  }
+
+ private:
+  /* position of a segment of the status relative to a point on the sweep
+   * line, -1 below, 0 through and 1 above */
+  int side(unsigned s, const Point& p) const {
+    // the computed crossing point may be rounded off the segments
+    if (_crossing[s] && p == _sweep) return 0;
+    const Point &a = _ends[s].first, &b = _ends[s].second;
+    if (a.x() == b.x()) {
+      if (b.y() < p.y()) return -1;
+      return p.y() < a.y() ? 1 : 0;
+    }
+    return -static_cast<int>(orient_2d(a, b, p));
+  }
+
+  /* order of the status just right of the sweep point */
+  struct StatusCompare {
+    typedef void is_transparent;
+
+    bool operator()(unsigned s, unsigned t) const {
+      if (s == t) return false;
+      const Point& p = sweep->_sweep;
+      int ps = sweep->side(s, p), pt = sweep->side(t, p);
+      if (ps != pt) return ps < pt;
+      if (ps == 0) {
+        // both through the sweep point, the one turning right is below
+        int o = static_cast<int>(
+            orient_2d(p, sweep->_ends[s].second, sweep->_ends[t].second));
+        if (o != 0) return o > 0;
+      }
+      return s < t;
+    }
+
+    bool operator()(unsigned s, const Point& p) const {
+      return sweep->side(s, p) < 0;
+    }
+
+    bool operator()(const Point& p, unsigned s) const {
+      return sweep->side(s, p) > 0;
+    }
+
+    const SegmentSweep* sweep;
+  };
+
+  /* schedule the crossing of two neighbours if it is right of the sweep */
+  void add_crossing(unsigned s, unsigned t) {
+    const Point &a = _ends[s].first, &b = _ends[s].second;
+    const Point &c = _ends[t].first, &d = _ends[t].second;
+    int o1 = static_cast<int>(orient_2d(a, b, c));
+    int o2 = static_cast<int>(orient_2d(a, b, d));
+    int o3 = static_cast<int>(orient_2d(c, d, a));
+    int o4 = static_cast<int>(orient_2d(c, d, b));
+    // touching and overlapping segments meet at an end point, which is
+    // already an event
+    if (o1 * o2 >= 0 || o3 * o4 >= 0) return;
+    // s is below t, they cross ahead only if s is steeper
+    T denominator = (b - a) % (d - c);
+    if (!(denominator < 0)) return;
+    T ratio = ((c - a) % (d - c)) / denominator;
+    Point p = a + (b - a) * ratio;
+    if (!(_sweep < p)) return;
+    Event& event = _events[p];
+    event.crossing.push_back(s);
+    event.crossing.push_back(t);
+  }
+
+  /* whether two segments through the sweep point intersect there, an
+   * overlap is only reported at its first point */
+  bool meet(unsigned s, unsigned t) const {
+    const Point &a = _ends[s].first, &b = _ends[s].second;
+    const Point &c = _ends[t].first, &d = _ends[t].second;
+    bool collinear = orient_2d(a, b, c) == ORIENTATION::ON &&
+                     orient_2d(a, b, d) == ORIENTATION::ON;
+    if (collinear) {
+      const Point& start = a < c ? c : a;
+      const Point& end = b < d ? b : d;
+      if (!(start == _sweep)) return false;
+      return start < end || (!_open && start == end);
+    }
+    if (!_open) return true;
+    return !(a == _sweep || b == _sweep || c == _sweep || d == _sweep);
+  }
+
+  /* report the pairs of segments containing the sweep point */
+  bool report(const std::vector<unsigned>& through,
+              const std::vector<unsigned>& starting,
+              std::vector<SegmentIntersection<T>>& intersections) const {
+    std::vector<unsigned> group(through);
+    group.insert(group.end(), starting.begin(), starting.end());
+    bool found = false;
+    for (unsigned i = 0; i < group.size(); ++i) {
+      for (unsigned j = i + 1; j < group.size(); ++j) {
+        if (!meet(group[i], group[j])) continue;
+        unsigned s = std::min(group[i], group[j]);
+        unsigned t = std::max(group[i], group[j]);
+        intersections.push_back(SegmentIntersection<T>{s, t, _sweep});
+        found = true;
+      }
+    }
+    return found;
+  }
+
+ private:
+  bool _open;
+  /* end points of the segments in (x, y) order */
+  std::vector<std::pair<Point, Point>> _ends;
+  /* segments starting at an event point and pairs crossing there */
+  struct Event {
+    std::vector<unsigned> starting;
+    std::vector<unsigned> crossing;
+  };
+  std::map<Point, Event> _events;
+  Point _sweep;
+  /* whether a segment crosses another one at the sweep point */
+  std::vector<unsigned char> _crossing;
+  std::set<unsigned, StatusCompare> _status;
+};
+
+}  // namespace internal
+
+/**
+ * @brief find all the intersecting pairs of a set of segments with the
+ * Bentley-Ottmann sweep in O((n + k) log n), k the number of intersections
+ * @tparam T number type, the result is exact for exact number types such as
+ * mpq_class, near degenerated cases may be missed otherwise
+ * @param segments input segments
+ * @param intersections intersecting pairs and their smallest common point,
+ * ordered by point
+ * @param open if true, the segments are open, so touching at an end point is
+ * not an intersection, the same as intersect(seg1, seg2, open)
+ * @param first_only stop at the first intersection found, used to check
+ * whether the segments are free of intersections
+ * @return true if some segments intersect, otherwise false
+ */
+template <typename T>
+bool intersect(const std::vector<geo2d::Segment<T>>& segments,
+               std::vector<SegmentIntersection<T>>& intersections,
+               bool open = false, bool first_only = false) {
+  internal::SegmentSweep<T> sweep(segments, open);
+  return sweep.execute(intersections, first_only);
+}
+
+}  // namespace algorithm
+}  // namespace CMTL
+
+#endif  // __algorithm_segments_intersect__
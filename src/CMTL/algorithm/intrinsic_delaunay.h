@@ -0,0 +1,393 @@
+#ifndef __algorithm_intrinsic_delaunay__
+#define __algorithm_intrinsic_delaunay__
+
+#include "../common/numeric_utils.h"
+#include "../geo2d/point.h"
+#include "../geo3d/surface_mesh.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <queue>
+#include <utility>
+
+namespace CMTL {
+namespace algorithm {
+
+/**
+ * @brief intrinsic triangulation of a 3d triangle mesh. the connectivity is a
+ * copy of the input mesh topology and the geometry is given by edge lengths
+ * only, flipping an edge changes the connectivity and lengths without moving
+ * any vertex, the vertices keep the same index as in the input mesh.
+ * @note every edge keeps a direction at both of its end vertices (the angle
+ * from a reference halfedge around the vertex), intrinsic edges are mapped
+ * back to the input mesh by tracing along these directions.
+ */
+template <typename T>
+class IntrinsicTriangulation {
+ public:
+  typedef geo3d::SurfaceMesh<T> SurfaceMesh;
+  typedef halfedge::GraphTopology Topology;
+
+  typedef halfedge::VertexHandle VertexHandle;
+  typedef halfedge::HalfedgeHandle HalfedgeHandle;
+  typedef halfedge::EdgeHandle EdgeHandle;
+  typedef halfedge::FaceHandle FaceHandle;
+
+  typedef geo3d::Point<double> Point;
+
+ public:
+  /**
+   * @brief build the intrinsic triangulation which equals the input mesh
+   * @note the input mesh must be a triangle mesh and must outlive this object
+   */
+  IntrinsicTriangulation(const SurfaceMesh& sm) : _input(sm), _topo(sm) {
+    if (!sm.is_triangle_mesh())
+      std::cerr << "Intrinsic triangulation needs a triangle mesh"
+                << std::endl;
+    _length.resize(_topo.n_edges());
+    _input_edge.resize(_topo.n_edges());
+    for (auto eit = _topo.edges_begin(); eit != _topo.edges_end(); ++eit) {
+      HalfedgeHandle heh = _topo.halfedge_handle(*eit, 0);
+      const auto& p0 = sm.point(_topo.from_vertex_handle(heh));
+      const auto& p1 = sm.point(_topo.to_vertex_handle(heh));
+      double dx = to_double(p1.x()) - to_double(p0.x());
+      double dy = to_double(p1.y()) - to_double(p0.y());
+      double dz = to_double(p1.z()) - to_double(p0.z());
+      _length[eit->idx()] = std::sqrt(dx * dx + dy * dy + dz * dz);
+      _input_edge[eit->idx()] = *eit;
+    }
+    _direction.resize(_topo.n_halfedges(), 0.);
+    _angle_sum.resize(_topo.n_vertices(), 0.);
+    for (auto vit = _topo.vertices_begin(); vit != _topo.vertices_end(); ++vit)
+      update_directions(*vit);
+    _input_length = _length;
+    _input_direction = _direction;
+  }
+
+ public:
+  /** @brief current intrinsic connectivity */
+  const Topology& topology() const { return _topo; }
+
+  /** @brief the input mesh */
+  const SurfaceMesh& input() const { return _input; }
+
+  /** @brief intrinsic length of an edge */
+  double length(EdgeHandle eh) const { return _length[eh.idx()]; }
+
+  /** @brief intrinsic length of a halfedge */
+  double length(HalfedgeHandle heh) const {
+    return _length[_topo.edge_handle(heh).idx()];
+  }
+
+  /** @brief total angle around a vertex */
+  double angle_sum(VertexHandle vh) const { return _angle_sum[vh.idx()]; }
+
+  /**
+   * @brief the input edge which coincides with eh, invalid if eh has been
+   * flipped and crosses the input faces
+   */
+  EdgeHandle input_edge(EdgeHandle eh) const { return _input_edge[eh.idx()]; }
+
+  /**
+   * @brief interior angle of the face of heh at the from vertex of heh
+   */
+  double corner_angle(HalfedgeHandle heh) const {
+    return angle(length(heh), length(_topo.prev_halfedge_handle(heh)),
+                 length(_topo.next_halfedge_handle(heh)));
+  }
+
+  /**
+   * @brief cotangent of the angle opposite to heh in its face, zero if heh is
+   * a boundary halfedge
+   */
+  double cotan(HalfedgeHandle heh) const {
+    if (_topo.is_boundary(heh)) return 0.;
+    double a = length(_topo.next_halfedge_handle(heh));
+    double b = length(_topo.prev_halfedge_handle(heh));
+    double c = length(heh);
+    double area = face_area(a, b, c);
+    if (area <= 0.) return 0.;
+    return (a * a + b * b - c * c) / (4. * area);
+  }
+
+  /**
+   * @brief cotangent laplacian weight of an edge, i.e. half of the sum of
+   * cotangents of the opposite angles
+   */
+  double cotan_weight(EdgeHandle eh) const {
+    return 0.5 * (cotan(_topo.halfedge_handle(eh, 0)) +
+                  cotan(_topo.halfedge_handle(eh, 1)));
+  }
+
+  /**
+   * @brief check whether an edge is intrinsic delaunay, i.e. the opposite
+   * angles sum no more than pi
+   */
+  bool is_delaunay(EdgeHandle eh) const {
+    if (_topo.is_boundary(eh)) return true;
+    return cotan_weight(eh) >= -_tolerance;
+  }
+
+  /**
+   * @brief check whether eh can be flipped, the two adjacent triangles must
+   * form a convex quadrilateral
+   */
+  bool is_flip_ok(EdgeHandle eh) const {
+    if (!_topo.is_flip_ok(eh)) return false;
+    HalfedgeHandle h0 = _topo.halfedge_handle(eh, 0);
+    HalfedgeHandle h1 = _topo.halfedge_handle(eh, 1);
+    // unfold the two triangles, the diagonal must cross the edge inside
+    double l = length(eh);
+    geo2d::Point<double> pa =
+        unfold(geo2d::Point<double>(0., 0.), geo2d::Point<double>(l, 0.),
+               length(_topo.prev_halfedge_handle(h0)),
+               length(_topo.next_halfedge_handle(h0)));
+    geo2d::Point<double> pb =
+        unfold(geo2d::Point<double>(l, 0.), geo2d::Point<double>(0., 0.),
+               length(_topo.prev_halfedge_handle(h1)),
+               length(_topo.next_halfedge_handle(h1)));
+    if (pa.y() <= 0. || pb.y() >= 0.) return false;
+    double x = pa.x() + (pb.x() - pa.x()) * pa.y() / (pa.y() - pb.y());
+    return x > _tolerance * l && x < (1. - _tolerance) * l;
+  }
+
+  /**
+   * @brief flip an edge, its new length is computed with the law of cosines
+   * @return false if the edge can not be flipped
+   */
+  bool flip(EdgeHandle eh) {
+    if (!is_flip_ok(eh)) return false;
+    HalfedgeHandle a0 = _topo.halfedge_handle(eh, 0);
+    HalfedgeHandle b0 = _topo.halfedge_handle(eh, 1);
+    // angles at v0 and v1 of the quadrilateral
+    double alpha =
+        corner_angle(a0) + corner_angle(_topo.next_halfedge_handle(b0));
+    double la = length(_topo.prev_halfedge_handle(a0));
+    double lb = length(_topo.next_halfedge_handle(b0));
+    _length[eh.idx()] = std::sqrt(
+        std::max(0., la * la + lb * lb - 2. * la * lb * std::cos(alpha)));
+    _input_edge[eh.idx()] = EdgeHandle();
+    _topo.flip(eh);
+    // after flip a0 is vb->va, b0 is va->vb
+    update_direction(b0);
+    update_direction(a0);
+    return true;
+  }
+
+  /**
+   * @brief flip non-delaunay edges until the triangulation is intrinsic
+   * delaunay, the most violating edge is flipped first
+   * @return number of flips
+   */
+  unsigned flip_to_delaunay() {
+    std::priority_queue<std::pair<double, EdgeHandle>> queue;
+    std::vector<unsigned char> in_queue(_topo.n_edges(), 0);
+    auto conditional_push = [&](EdgeHandle eh) {
+      if (in_queue[eh.idx()] || _topo.is_boundary(eh)) return;
+      double w = cotan_weight(eh);
+      if (w >= -_tolerance) return;
+      in_queue[eh.idx()] = 1;
+      queue.push(std::make_pair(-w, eh));
+    };
+    for (auto eit = _topo.edges_begin(); eit != _topo.edges_end(); ++eit)
+      conditional_push(*eit);
+
+    unsigned n_flips = 0;
+    while (!queue.empty()) {
+      EdgeHandle eh = queue.top().second;
+      queue.pop();
+      in_queue[eh.idx()] = 0;
+      if (is_delaunay(eh) || !flip(eh)) continue;
+      ++n_flips;
+      HalfedgeHandle h0 = _topo.halfedge_handle(eh, 0);
+      HalfedgeHandle h1 = _topo.halfedge_handle(eh, 1);
+      conditional_push(_topo.edge_handle(_topo.next_halfedge_handle(h0)));
+      conditional_push(_topo.edge_handle(_topo.prev_halfedge_handle(h0)));
+      conditional_push(_topo.edge_handle(_topo.next_halfedge_handle(h1)));
+      conditional_push(_topo.edge_handle(_topo.prev_halfedge_handle(h1)));
+    }
+    return n_flips;
+  }
+
+  /**
+   * @brief map an intrinsic edge back to the input mesh as a polyline, the
+   * first and last points are the end vertices of halfedge 0 of eh, the
+   * points between are the crossings with the input edges
+   */
+  std::vector<Point> trace(EdgeHandle eh) const {
+    HalfedgeHandle heh = _topo.halfedge_handle(eh, 0);
+    VertexHandle v0 = _topo.from_vertex_handle(heh);
+    VertexHandle v1 = _topo.to_vertex_handle(heh);
+    std::vector<Point> polyline;
+    polyline.push_back(input_point(v0));
+    if (!_input_edge[eh.idx()].is_valid()) trace(heh, polyline);
+    polyline.push_back(input_point(v1));
+    return polyline;
+  }
+
+ private:
+  /* angle opposite to c in a triangle of side lengths a, b, c */
+  static double angle(double a, double b, double c) {
+    if (a <= 0. || b <= 0.) return 0.;
+    double cos = (a * a + b * b - c * c) / (2. * a * b);
+    return std::acos(std::min(1., std::max(-1., cos)));
+  }
+
+  /* triangle area by heron's formula */
+  static double face_area(double a, double b, double c) {
+    double s = 0.5 * (a + b + c);
+    return std::sqrt(std::max(0., s * (s - a) * (s - b) * (s - c)));
+  }
+
+  /* place the third vertex of a triangle on the left of p0->p1, given its
+   * distance l0 to p0 and l1 to p1 */
+  static geo2d::Point<double> unfold(const geo2d::Point<double>& p0,
+                                     const geo2d::Point<double>& p1, double l0,
+                                     double l1) {
+    geo2d::Point<double> u = p1 - p0;
+    double d = std::sqrt(u * u);
+    u /= d;
+    double x = (l0 * l0 - l1 * l1 + d * d) / (2. * d);
+    double y = std::sqrt(std::max(0., l0 * l0 - x * x));
+    return geo2d::Point<double>(p0.x() + x * u.x() - y * u.y(),
+                                p0.y() + x * u.y() + y * u.x());
+  }
+
+  static double cross(const geo2d::Point<double>& a,
+                      const geo2d::Point<double>& b) {
+    return a.x() * b.y() - a.y() * b.x();
+  }
+
+  Point input_point(VertexHandle vh) const {
+    const auto& p = _input.point(vh);
+    return Point(to_double(p.x()), to_double(p.y()), to_double(p.z()));
+  }
+
+  /* assign directions to all the outgoing halfedges of a vertex, counter
+   * clockwise from the first halfedge after the boundary */
+  void update_directions(VertexHandle vh) {
+    HalfedgeHandle start = _topo.halfedge_handle(vh);
+    if (!start.is_valid()) return;
+    for (auto voh = _topo.voh_begin(vh); voh != _topo.voh_end(vh); ++voh)
+      if (_topo.is_boundary(_topo.opposite_halfedge_handle(*voh))) start = *voh;
+    double theta = 0.;
+    HalfedgeHandle heh = start;
+    do {
+      _direction[heh.idx()] = theta;
+      if (_topo.is_boundary(heh)) break;
+      theta += corner_angle(heh);
+      heh = _topo.opposite_halfedge_handle(_topo.prev_halfedge_handle(heh));
+    } while (heh != start);
+    _angle_sum[vh.idx()] = theta;
+  }
+
+  /* direction of a flipped halfedge from the halfedge before it */
+  void update_direction(HalfedgeHandle heh) {
+    VertexHandle vh = _topo.from_vertex_handle(heh);
+    HalfedgeHandle before = _topo.next_halfedge_handle(
+        _topo.opposite_halfedge_handle(heh));
+    double theta = _direction[before.idx()] + corner_angle(before);
+    if (!_topo.is_boundary(vh) && theta >= _angle_sum[vh.idx()])
+      theta -= _angle_sum[vh.idx()];
+    _direction[heh.idx()] = theta;
+  }
+
+  /* trace a flipped halfedge through the input faces, append the crossing
+   * points with the input edges */
+  void trace(HalfedgeHandle heh, std::vector<Point>& polyline) const {
+    const Topology& topo = _input;
+    VertexHandle vh = _topo.from_vertex_handle(heh);
+    double theta = _direction[heh.idx()];
+    double l = length(heh);
+
+    // find the input face which contains the start direction
+    HalfedgeHandle first;
+    for (auto voh = topo.voh_begin(vh); voh != topo.voh_end(vh); ++voh) {
+      if (topo.is_boundary(*voh)) continue;
+      if (_input_direction[voh->idx()] <= theta + _tolerance &&
+          (!first.is_valid() ||
+           _input_direction[voh->idx()] > _input_direction[first.idx()]))
+        first = *voh;
+    }
+    if (!first.is_valid()) return;
+
+    // unfold the first face, the trace starts from its corner at origin
+    double phi = theta - _input_direction[first.idx()];
+    geo2d::Point<double> dir(std::cos(phi), std::sin(phi));
+    geo2d::Point<double> p_from(input_length(first), 0.);
+    geo2d::Point<double> p_to =
+        unfold(geo2d::Point<double>(0., 0.), p_from,
+               input_length(topo.prev_halfedge_handle(first)),
+               input_length(topo.next_halfedge_handle(first)));
+    HalfedgeHandle crossing = topo.next_halfedge_handle(first);
+
+    for (unsigned step = 0; step < topo.n_faces(); ++step) {
+      // intersect the ray with the crossing edge
+      geo2d::Point<double> e = p_to - p_from;
+      double denom = cross(dir, e);
+      if (denom == 0.) return;
+      double t = cross(p_from, e) / denom;
+      double s = cross(p_from, dir) / denom;
+      if (t >= l * (1. - _tolerance)) return;
+      s = std::min(1., std::max(0., s));
+      Point q0 = input_point(topo.from_vertex_handle(crossing));
+      Point q1 = input_point(topo.to_vertex_handle(crossing));
+      polyline.push_back(q0 * (1. - s) + q1 * s);
+
+      // unfold the face on the other side
+      HalfedgeHandle twin = topo.opposite_halfedge_handle(crossing);
+      if (topo.is_boundary(twin)) return;
+      geo2d::Point<double> p_opp =
+          unfold(p_to, p_from, input_length(topo.prev_halfedge_handle(twin)),
+                 input_length(topo.next_halfedge_handle(twin)));
+      if ((cross(dir, p_opp) > 0.) == (cross(dir, p_from) > 0.)) {
+        crossing = topo.prev_halfedge_handle(twin);
+        p_from = p_opp;
+      } else {
+        crossing = topo.next_halfedge_handle(twin);
+        p_to = p_opp;
+      }
+    }
+  }
+
+  double input_length(HalfedgeHandle heh) const {
+    return _input_length[_topo.edge_handle(heh).idx()];
+  }
+
+ private:
+  const SurfaceMesh& _input;
+  /* intrinsic connectivity */
+  Topology _topo;
+  /* intrinsic edge lengths */
+  std::vector<double> _length;
+  /* direction of each halfedge around its from vertex */
+  std::vector<double> _direction;
+  /* total angle around each vertex */
+  std::vector<double> _angle_sum;
+  /* input edge of each intrinsic edge, invalid if flipped */
+  std::vector<EdgeHandle> _input_edge;
+  /* edge lengths and halfedge directions of the input mesh */
+  std::vector<double> _input_length;
+  std::vector<double> _input_direction;
+  /* relative tolerance of delaunay and flip tests */
+  static constexpr double _tolerance = 1e-10;
+};
+
+/**
+ * @brief build the intrinsic delaunay triangulation of a 3d triangle mesh
+ * @param sm input triangle mesh, it is not modified
+ * @return the intrinsic triangulation, use its trace() to map the edges back
+ * to sm
+ */
+template <typename T>
+IntrinsicTriangulation<T> intrinsic_delaunay(const geo3d::SurfaceMesh<T>& sm) {
+  IntrinsicTriangulation<T> it(sm);
+  it.flip_to_delaunay();
+  return it;
+}
+
+}  // namespace algorithm
+}  // namespace CMTL
+
+#endif  // __algorithm_intrinsic_delaunay__
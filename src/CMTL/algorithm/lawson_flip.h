@@ -5,10 +5,108 @@
 #include "predicate.h"
 
 #include <queue>
+#include <unordered_set>
 
 namespace CMTL {
 namespace algorithm {
 
+namespace internal {
+
+template <typename T>
+class lawson_flip_modifier {
+ public:
+  typedef typename geo2d::SurfaceMesh<T>::VertexHandle VertexHandle;
+  typedef typename geo2d::SurfaceMesh<T>::HalfedgeHandle HalfedgeHandle;
+  typedef typename geo2d::SurfaceMesh<T>::EdgeHandle EdgeHandle;
+
+  /**
+   * @param dense whether to keep the edge flags in a vector of all the edges,
+   * for a pass over the whole mesh, or in hash sets, for a local pass
+   */
+  lawson_flip_modifier(geo2d::SurfaceMesh<T>& sm,
+                       const std::vector<EdgeHandle>& constrained_edges,
+                       bool dense)
+      : _sm(sm), _dense(dense) {
+    if (_dense) _flags.assign(sm.n_edges(), 0);
+    for (unsigned ce = 0; ce < constrained_edges.size(); ++ce) {
+      if (_dense)
+        _flags[constrained_edges[ce].idx()] |= CONSTRAINED;
+      else
+        _constrained.insert(constrained_edges[ce].idx());
+    }
+  }
+
+ public:
+  /**
+   * @brief queue an edge unless it is constrained or already queued
+   */
+  void push(EdgeHandle eh) {
+    if (_dense) {
+      char& flag = _flags[eh.idx()];
+      if (flag) return;
+      flag = IN_QUEUE;
+    } else {
+      if (_constrained.count(eh.idx())) return;
+      if (!_in_queue.insert(eh.idx()).second) return;
+    }
+    _queue.push(eh);
+  }
+
+  /**
+   * @brief queue all the edges of the faces around a vertex, they are the
+   * edges whose delaunay property may change when the vertex moves
+   */
+  void push(VertexHandle vh) {
+    for (auto voh = _sm.voh_begin(vh); voh != _sm.voh_end(vh); ++voh) {
+      push(_sm.edge_handle(*voh));
+      if (!_sm.is_boundary(*voh))
+        push(_sm.edge_handle(_sm.next_halfedge_handle(*voh)));
+    }
+  }
+
+  void execute() {
+    while (!_queue.empty()) {
+      EdgeHandle eh = _queue.front();
+      _queue.pop();
+      if (_dense)
+        _flags[eh.idx()] &= ~IN_QUEUE;
+      else
+        _in_queue.erase(eh.idx());
+      if (_sm.is_boundary(eh)) continue;
+      HalfedgeHandle h0 = _sm.halfedge_handle(eh, 0);
+      HalfedgeHandle h1 = _sm.halfedge_handle(eh, 1);
+      VertexHandle v0 = _sm.from_vertex_handle(h0);
+      VertexHandle v1 = _sm.to_vertex_handle(h0);
+      VertexHandle va = _sm.to_vertex_handle(_sm.next_halfedge_handle(h0));
+      VertexHandle vb = _sm.to_vertex_handle(_sm.next_halfedge_handle(h1));
+      if (!is_locally_delaunay(_sm.point(va), _sm.point(v0), _sm.point(v1),
+                               _sm.point(vb)) &&
+          _sm.is_flip_ok(eh)) {
+        _sm.flip(eh);
+        push(_sm.edge_handle(_sm.next_halfedge_handle(h0)));
+        push(_sm.edge_handle(_sm.prev_halfedge_handle(h0)));
+        push(_sm.edge_handle(_sm.next_halfedge_handle(h1)));
+        push(_sm.edge_handle(_sm.prev_halfedge_handle(h1)));
+      }
+    }
+  }
+
+ private:
+  enum { CONSTRAINED = 1, IN_QUEUE = 2 };
+
+  geo2d::SurfaceMesh<T>& _sm;
+  bool _dense;
+  /* flags of all the edges in dense mode */
+  std::vector<char> _flags;
+  /* constrained and queued edges by index otherwise, so that a local flip
+   * only costs the size of the region visited */
+  std::unordered_set<int> _constrained;
+  std::unordered_set<int> _in_queue;
+  std::queue<EdgeHandle> _queue;
+};
+
+}  // namespace internal
+
 /**
  * @brief remove locally non-delaunay edges in surface mesh
  * @param sm surface mesh need flip
@@ -18,43 +116,10 @@ template <typename T>
 void lawson_flip(geo2d::SurfaceMesh<T>& sm,
                  const std::vector<typename geo2d::SurfaceMesh<T>::EdgeHandle>&
                      constrained_edges = {}) {
-  typedef typename geo2d::SurfaceMesh<T>::VertexHandle VertexHandle;
-  typedef typename geo2d::SurfaceMesh<T>::HalfedgeHandle HalfedgeHandle;
-  typedef typename geo2d::SurfaceMesh<T>::EdgeHandle EdgeHandle;
-
-  std::vector<unsigned> edge_constrained_flag(sm.n_edges(), 0);
-  for (unsigned ce = 0; ce < constrained_edges.size(); ++ce)
-    edge_constrained_flag[constrained_edges[ce].idx()] = 1;
-
-  auto conditional_push = [&edge_constrained_flag](
-                              std::queue<EdgeHandle>& queue, EdgeHandle eh) {
-    if (edge_constrained_flag[eh.idx()] != 1) queue.push(eh);
-  };
-
-  std::queue<EdgeHandle> queue;
+  internal::lawson_flip_modifier<T> modifier(sm, constrained_edges, true);
   for (auto eit = sm.edges_begin(); eit != sm.edges_end(); ++eit)
-    conditional_push(queue, *eit);
-
-  while (!queue.empty()) {
-    EdgeHandle eh = queue.front();
-    queue.pop();
-    if (sm.is_boundary(eh)) continue;
-    HalfedgeHandle h0 = sm.halfedge_handle(eh, 0);
-    HalfedgeHandle h1 = sm.halfedge_handle(eh, 1);
-    VertexHandle v0 = sm.from_vertex_handle(h0);
-    VertexHandle v1 = sm.to_vertex_handle(h0);
-    VertexHandle va = sm.to_vertex_handle(sm.next_halfedge_handle(h0));
-    VertexHandle vb = sm.to_vertex_handle(sm.next_halfedge_handle(h1));
-    if (!is_locally_delaunay(sm.point(va), sm.point(v0), sm.point(v1),
-                             sm.point(vb)) &&
-        sm.is_flip_ok(eh)) {
-      sm.flip(eh);
-      conditional_push(queue, sm.edge_handle(sm.next_halfedge_handle(h0)));
-      conditional_push(queue, sm.edge_handle(sm.prev_halfedge_handle(h0)));
-      conditional_push(queue, sm.edge_handle(sm.next_halfedge_handle(h1)));
-      conditional_push(queue, sm.edge_handle(sm.prev_halfedge_handle(h1)));
-    }
-  }
+    modifier.push(*eit);
+  modifier.execute();
 
 #if 0
     // check
@@ -73,6 +138,48 @@ void lawson_flip(geo2d::SurfaceMesh<T>& sm,
 #endif
 }
 
+/**
+ * @brief restore the delaunay property of a delaunay surface mesh after some
+ * vertices moved or inserted, only the region around these vertices is visited
+ * @param sm surface mesh need flip, it should be delaunay except around the
+ * seed vertices
+ * @param seed_vertices vertices that have been edited
+ * @param constrained_edges fixed edges
+ */
+template <typename T>
+void lawson_flip_local(
+    geo2d::SurfaceMesh<T>& sm,
+    const std::vector<typename geo2d::SurfaceMesh<T>::VertexHandle>&
+        seed_vertices,
+    const std::vector<typename geo2d::SurfaceMesh<T>::EdgeHandle>&
+        constrained_edges = {}) {
+  internal::lawson_flip_modifier<T> modifier(sm, constrained_edges, false);
+  for (unsigned i = 0; i < seed_vertices.size(); ++i)
+    modifier.push(seed_vertices[i]);
+  modifier.execute();
+}
+
+/**
+ * @brief restore the delaunay property of a delaunay surface mesh after some
+ * edges changed, e.g. split or flipped, only the region around these edges is
+ * visited
+ * @param sm surface mesh need flip, it should be delaunay except around the
+ * seed edges
+ * @param seed_edges edges that have been edited
+ * @param constrained_edges fixed edges
+ */
+template <typename T>
+void lawson_flip_local(
+    geo2d::SurfaceMesh<T>& sm,
+    const std::vector<typename geo2d::SurfaceMesh<T>::EdgeHandle>& seed_edges,
+    const std::vector<typename geo2d::SurfaceMesh<T>::EdgeHandle>&
+        constrained_edges = {}) {
+  internal::lawson_flip_modifier<T> modifier(sm, constrained_edges, false);
+  for (unsigned i = 0; i < seed_edges.size(); ++i)
+    modifier.push(seed_edges[i]);
+  modifier.execute();
+}
+
 }  // namespace algorithm
 }  // namespace CMTL
 
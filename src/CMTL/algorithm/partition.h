@@ -2,5 +2,6 @@
 #define __algorithm_partition__
 
 #include "partition/connected_manifold_partition.h"
+#include "partition/surface_mesh_components.h"
 
 #endif  // __algorithm_partition__
\ No newline at end of file
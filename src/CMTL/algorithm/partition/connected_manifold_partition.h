@@ -1,82 +1,107 @@
 #ifndef __algorithm_connected_manifold_partition__
 #define __algorithm_connected_manifold_partition__
 
-#include <queue>
-#include <unordered_map>
+#include "../../common/parallel.h"
+#include "../../common/radix_sort.h"
+#include "../../common/union_find.h"
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
 #include <vector>
 
 namespace CMTL {
 namespace algorithm {
 
 /**
- * @brief partition the input faces into connected manifolds
+ * @brief partition the input faces into connected manifolds, two faces are
+ * connected if they share an edge used by no other face
  * @param faces input faces, each face is represented by a list of vertex
  * @param groups a list of connected manifolds, each manifold is represented by
- * a list of face indices
- * @tparam VertexIndex vertex index type, must be hashable and comparable
+ * a list of face indices in increasing order, the manifolds are ordered by
+ * their first face
+ * @param n_threads number of threads, 0 to choose from the input size
+ * @tparam VertexIndex vertex index type, an integer less than 2^32
  * @tparam FaceIndex face index type
+ * @note the edges are paired by radix sorting packed 64 bits keys and the
+ * faces are merged by a lock-free union-find shared by the threads
  */
 template <typename VertexIndex, typename FaceIndex>
 void connected_manifold_partition_3d(
     const std::vector<std::vector<VertexIndex>>& faces,
-    std::vector<std::vector<FaceIndex>>& groups) {
-  struct EdgeHash {
-    size_t operator()(const std::pair<VertexIndex, VertexIndex>& edge) const {
-      return std::hash<VertexIndex>()(edge.first) ^
-             std::hash<VertexIndex>()(edge.second);
-    }
-  };
+    std::vector<std::vector<FaceIndex>>& groups, unsigned n_threads = 0) {
+  typedef std::pair<uint64_t, unsigned> EdgeKey;
+  groups.clear();
+  unsigned n_faces = faces.size();
+  if (n_faces == 0) return;
 
-  // first, build edge-face map
-  std::unordered_map<std::pair<VertexIndex, VertexIndex>,
-                     std::vector<FaceIndex>, EdgeHash>
-      edge_face_map;
-  for (std::size_t i = 0; i < faces.size(); ++i) {
-    const std::vector<VertexIndex>& face = faces[i];
-    for (std::size_t j = 0, k = 1; j < face.size();
-         ++j, ++k, k %= face.size()) {
-      VertexIndex v0 = face[j];
-      VertexIndex v1 = face[k];
-      if (v0 > v1) std::swap(v0, v1);
-      edge_face_map[std::make_pair(v0, v1)].push_back(i);
-    }
-  }
+  std::vector<size_t> offsets(n_faces + 1, 0);
+  for (unsigned i = 0; i < n_faces; ++i)
+    offsets[i + 1] = offsets[i] + faces[i].size();
+  size_t n_corners = offsets.back();
+  if (n_threads == 0) n_threads = default_threads(n_corners);
 
-  // then, build face adjacency list, skip non-manifold edges
-  std::vector<std::vector<FaceIndex>> face_adj_list(faces.size());
-  for (const auto& entry : edge_face_map) {
-    if (entry.second.size() == 2) {
-      face_adj_list[entry.second[0]].push_back(entry.second[1]);
-      face_adj_list[entry.second[1]].push_back(entry.second[0]);
+  // one key per corner: the packed undirected edge and the face
+  std::vector<EdgeKey> keys(n_corners);
+  parallel_for(n_faces, n_threads, [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      const std::vector<VertexIndex>& face = faces[i];
+      EdgeKey* out = keys.data() + offsets[i];
+      for (size_t j = 0; j < face.size(); ++j) {
+        uint64_t v0 = static_cast<uint64_t>(face[j]);
+        uint64_t v1 = static_cast<uint64_t>(face[(j + 1) % face.size()]);
+        assert(v0 <= UINT32_MAX && v1 <= UINT32_MAX);
+        if (v0 > v1) std::swap(v0, v1);
+        out[j] = EdgeKey(v0 << 32 | v1, static_cast<unsigned>(i));
+      }
     }
-  }
+  });
 
-  std::vector<bool> visited(faces.size(), false);
-  groups.clear();
+  // only the bits used by the vertex indices are sorted
+  uint64_t max_v = 0;
+  for (const EdgeKey& key : keys)
+    max_v = std::max(max_v, key.first & UINT32_MAX);
+  unsigned n_bits = 0;
+  while (n_bits < 32 && (max_v >> n_bits) != 0) ++n_bits;
+  radix_sort(keys, [&](const EdgeKey& key) {
+    return (key.first >> 32) << n_bits | (key.first & UINT32_MAX);
+  }, 2 * n_bits);
 
-  // ok, now we can extract connected components
-  for (std::size_t i = 0; i < faces.size(); ++i) {
-    if (visited[i]) continue;
-    std::vector<FaceIndex> group;
-    std::queue<FaceIndex> stack;
-    stack.push(i);
-    visited[i] = true;
-    while (!stack.empty()) {
-      FaceIndex curr = stack.front();
-      stack.pop();
-      group.push_back(curr);
-      for (FaceIndex adj : face_adj_list[curr]) {
-        if (!visited[adj]) {
-          visited[adj] = true;
-          stack.push(adj);
-        }
-      }
+  // merge the faces of the manifold edges, each thread starts at the first
+  // edge of a run
+  ConcurrentUnionFind components(n_faces);
+  parallel_for(n_corners, n_threads, [&](size_t begin, size_t end) {
+    while (begin > 0 && begin < end &&
+           keys[begin].first == keys[begin - 1].first)
+      ++begin;
+    for (size_t i = begin, j = begin; i < end; i = j) {
+      while (j < n_corners && keys[j].first == keys[i].first) ++j;
+      if (j - i == 2) components.unite(keys[i].second, keys[i + 1].second);
+    }
+  });
+
+  // the root of a component is its first face
+  std::vector<unsigned> group_of(n_faces);
+  std::vector<unsigned> group_sizes;
+  for (unsigned i = 0; i < n_faces; ++i) {
+    unsigned root = components.find(i);
+    if (root == i) {
+      group_of[i] = group_sizes.size();
+      group_sizes.push_back(0);
+    } else {
+      group_of[i] = group_of[root];
     }
-    groups.push_back(group);
+    ++group_sizes[group_of[i]];
   }
+  groups.resize(group_sizes.size());
+  for (unsigned g = 0; g < groups.size(); ++g)
+    groups[g].reserve(group_sizes[g]);
+  for (unsigned i = 0; i < n_faces; ++i)
+    groups[group_of[i]].push_back(static_cast<FaceIndex>(i));
 }
 
 }  // namespace algorithm
 }  // namespace CMTL
 
-#endif  // __algorithm_connected_manifold_partition__
\ No newline at end of file
+#endif  // __algorithm_connected_manifold_partition__
@@ -0,0 +1,178 @@
+#ifndef __algorithm_surface_mesh_components__
+#define __algorithm_surface_mesh_components__
+
+#include "../../common/parallel.h"
+#include "../../geo3d/surface_mesh.h"
+
+#include <vector>
+
+namespace CMTL {
+namespace algorithm {
+
+/**
+ * @brief label the faces of a surface mesh by connected component, two faces
+ * are connected if they share an edge
+ * @param sm input surface mesh
+ * @param component component index of each face, components are numbered in
+ * the order of their first face
+ * @return number of components
+ */
+template <typename T, class Traits>
+unsigned face_components(const geo3d::SurfaceMesh<T, Traits>& sm,
+                         std::vector<int>& component) {
+  typedef typename geo3d::SurfaceMesh<T, Traits>::FaceHandle FaceHandle;
+  component.assign(sm.n_faces(), -1);
+  unsigned n_components = 0;
+  std::vector<FaceHandle> stack;
+  for (unsigned i = 0; i < sm.n_faces(); ++i) {
+    if (component[i] >= 0) continue;
+    component[i] = n_components;
+    stack.push_back(FaceHandle(i));
+    while (!stack.empty()) {
+      FaceHandle fh = stack.back();
+      stack.pop_back();
+      for (auto fh_it = sm.fh_begin(fh); fh_it != sm.fh_end(fh); ++fh_it) {
+        FaceHandle adj = sm.face_handle(sm.opposite_halfedge_handle(*fh_it));
+        if (adj.is_valid() && component[adj.idx()] < 0) {
+          component[adj.idx()] = n_components;
+          stack.push_back(adj);
+        }
+      }
+    }
+    ++n_components;
+  }
+  return n_components;
+}
+
+/**
+ * @brief collect the boundary loops of a surface mesh
+ * @param sm input surface mesh
+ * @param loops boundary halfedges of each loop, in the order of traversal
+ */
+template <typename T, class Traits>
+void boundary_loops(
+    const geo3d::SurfaceMesh<T, Traits>& sm,
+    std::vector<std::vector<typename geo3d::SurfaceMesh<T, Traits>::
+                                HalfedgeHandle>>& loops) {
+  typedef typename geo3d::SurfaceMesh<T, Traits>::HalfedgeHandle
+      HalfedgeHandle;
+  loops.clear();
+  std::vector<bool> visited(sm.n_halfedges(), false);
+  for (unsigned i = 0; i < sm.n_halfedges(); ++i) {
+    HalfedgeHandle start(i);
+    if (visited[i] || !sm.is_boundary(start)) continue;
+    // edges without any face are not part of a loop
+    if (sm.is_boundary(sm.opposite_halfedge_handle(start))) continue;
+    loops.emplace_back();
+    HalfedgeHandle heh = start;
+    do {
+      visited[heh.idx()] = true;
+      loops.back().push_back(heh);
+      heh = sm.next_halfedge_handle(heh);
+    } while (heh != start && !visited[heh.idx()]);
+  }
+}
+
+/**
+ * @brief copy some faces of a surface mesh into a new surface mesh in one
+ * pass, the vertices are renumbered in the order they are first used and the
+ * points and the vertex, halfedge, edge and face attributes are copied
+ * @param sm input surface mesh
+ * @param faces faces to extract
+ * @param result extracted surface mesh
+ * @return false if some faces could not be added, e.g. faces which only share
+ * a vertex in the input mesh and whose other faces are not extracted
+ */
+template <typename T, class Traits>
+bool extract_submesh(
+    const geo3d::SurfaceMesh<T, Traits>& sm,
+    const std::vector<typename geo3d::SurfaceMesh<T, Traits>::FaceHandle>&
+        faces,
+    geo3d::SurfaceMesh<T, Traits>& result) {
+  typedef geo3d::SurfaceMesh<T, Traits> SurfaceMesh;
+  typedef typename SurfaceMesh::VertexHandle VertexHandle;
+  typedef typename SurfaceMesh::HalfedgeHandle HalfedgeHandle;
+  typedef typename SurfaceMesh::FaceHandle FaceHandle;
+
+  result.clear();
+  result.reserve(faces.size(), 2 * faces.size(), faces.size());
+  std::vector<int> vertex_map(sm.n_vertices(), -1);
+  std::vector<VertexHandle> vhs;
+  std::vector<HalfedgeHandle> hehs;
+  bool valid = true;
+  for (FaceHandle fh : faces) {
+    vhs.clear();
+    hehs.clear();
+    for (auto fh_it = sm.fh_begin(fh); fh_it != sm.fh_end(fh); ++fh_it) {
+      VertexHandle vh = sm.from_vertex_handle(*fh_it);
+      int& mapped = vertex_map[vh.idx()];
+      if (mapped < 0) {
+        mapped = result.add_vertex(sm.point(vh)).idx();
+        if (size_t(vh.idx()) < sm.vertex_attributes().size())
+          result.attribute(VertexHandle(mapped)) = sm.attribute(vh);
+      }
+      vhs.push_back(VertexHandle(mapped));
+      hehs.push_back(*fh_it);
+    }
+    FaceHandle new_fh = result.add_face(vhs);
+    if (!new_fh.is_valid()) {
+      valid = false;
+      continue;
+    }
+    if (size_t(fh.idx()) < sm.face_attributes().size())
+      result.attribute(new_fh) = sm.attribute(fh);
+
+    // the new face may start at another corner
+    HalfedgeHandle new_heh = result.halfedge_handle(new_fh);
+    unsigned k = 0;
+    while (vhs[k] != result.from_vertex_handle(new_heh)) ++k;
+    for (unsigned i = 0; i < hehs.size(); ++i) {
+      HalfedgeHandle heh = hehs[(k + i) % hehs.size()];
+      if (size_t(heh.idx()) < sm.halfedge_attributes().size())
+        result.attribute(new_heh) = sm.attribute(heh);
+      auto eh = sm.edge_handle(heh);
+      if (size_t(eh.idx()) < sm.edge_attributes().size())
+        result.attribute(result.edge_handle(new_heh)) = sm.attribute(eh);
+      new_heh = result.next_halfedge_handle(new_heh);
+    }
+  }
+  return valid;
+}
+
+/**
+ * @brief split a surface mesh into its connected components, the components
+ * are extracted in parallel
+ * @param sm input surface mesh
+ * @param components one surface mesh per component, in the order of
+ * face_components
+ * @param n_threads number of threads, 0 to choose from the mesh size
+ * @return false if some faces could not be extracted
+ */
+template <typename T, class Traits>
+bool extract_components(const geo3d::SurfaceMesh<T, Traits>& sm,
+                        std::vector<geo3d::SurfaceMesh<T, Traits>>& components,
+                        unsigned n_threads = 0) {
+  typedef typename geo3d::SurfaceMesh<T, Traits>::FaceHandle FaceHandle;
+  std::vector<int> component;
+  unsigned n_components = face_components(sm, component);
+  std::vector<std::vector<FaceHandle>> faces(n_components);
+  for (unsigned i = 0; i < sm.n_faces(); ++i)
+    faces[component[i]].push_back(FaceHandle(i));
+
+  components.clear();
+  components.resize(n_components);
+  if (n_threads == 0) n_threads = default_threads(sm.n_faces());
+  std::vector<unsigned char> valid(n_components, 1);
+  parallel_for(n_components, n_threads, [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i)
+      valid[i] = extract_submesh(sm, faces[i], components[i]);
+  });
+  for (unsigned char v : valid)
+    if (!v) return false;
+  return true;
+}
+
+}  // namespace algorithm
+}  // namespace CMTL
+
+#endif  // __algorithm_surface_mesh_components__
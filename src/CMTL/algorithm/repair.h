@@ -0,0 +1,7 @@
+#ifndef __algorithm_repair__
+#define __algorithm_repair__
+
+#include "repair/clean_pslg.h"
+#include "repair/polygon_soup_to_surface_mesh.h"
+
+#endif  // __algorithm_repair__
@@ -0,0 +1,171 @@
+#ifndef __algorithm_clean_pslg__
+#define __algorithm_clean_pslg__
+
+#include "../../geo2d/pslg.h"
+#include "../intersect/segments_intersect.h"
+
+#include <algorithm>
+#include <map>
+#include <numeric>
+#include <set>
+#include <utility>
+#include <vector>
+
+namespace CMTL {
+namespace algorithm {
+
+/**
+ * @brief what clean_pslg changed to make a planar straight line graph valid
+ */
+struct PSLGCleanReport {
+  /* points equal to a previous point, merged into it */
+  unsigned n_merged_points = 0;
+  /* segments with equal end points or equal to a previous segment */
+  unsigned n_removed_segments = 0;
+  /* segments split at intersection points */
+  unsigned n_split_segments = 0;
+  /* intersection points which are not input points */
+  unsigned n_added_points = 0;
+};
+
+/**
+ * @brief clean a planar straight line graph before triangulation: duplicated
+ * points are merged, degenerated and duplicated segments are removed, and
+ * segments are split where they cross or touch each other, so that any two
+ * segments only share end points
+ * @param pslg graph to clean, the remaining points keep their order and the
+ * intersection points are appended, the holes are not changed
+ * @param report what has been changed, ignored if null
+ * @note the intersections are found by a sweep in O((n + k) log n), they are
+ * exact for exact number types such as mpq_class and rounded otherwise
+ */
+template <typename T>
+void clean_pslg(geo2d::PSLG<T>& pslg, PSLGCleanReport* report = nullptr) {
+  typedef geo2d::Point<T> Point;
+  typedef std::pair<unsigned, unsigned> Segment;
+  PSLGCleanReport stats;
+
+  // merge the duplicated points by sorting, the first occurrence is kept
+  unsigned n_points = pslg._points.size();
+  std::vector<unsigned> order(n_points);
+  std::iota(order.begin(), order.end(), 0u);
+  std::stable_sort(order.begin(), order.end(), [&](unsigned i, unsigned j) {
+    return pslg._points[i] < pslg._points[j];
+  });
+  std::vector<unsigned> first(n_points);
+  for (unsigned k = 0; k < n_points; ++k) {
+    unsigned i = order[k];
+    bool duplicated = k > 0 && pslg._points[order[k - 1]] == pslg._points[i];
+    first[i] = duplicated ? first[order[k - 1]] : i;
+  }
+  std::vector<unsigned> point_map(n_points);
+  std::vector<Point> points;
+  points.reserve(n_points);
+  for (unsigned i = 0; i < n_points; ++i) {
+    if (first[i] == i) {
+      point_map[i] = points.size();
+      points.push_back(pslg._points[i]);
+    } else {
+      point_map[i] = point_map[first[i]];
+      ++stats.n_merged_points;
+    }
+  }
+
+  // remove the degenerated and duplicated segments
+  bool has_marks = pslg._segmentmarks.size() == pslg._segments.size();
+  std::vector<Segment> segments;
+  std::vector<int> marks;
+  std::set<Segment> seen;
+  for (unsigned i = 0; i < pslg._segments.size(); ++i) {
+    unsigned a = point_map[pslg._segments[i].first];
+    unsigned b = point_map[pslg._segments[i].second];
+    if (a == b || !seen.insert(std::minmax(a, b)).second) {
+      ++stats.n_removed_segments;
+      continue;
+    }
+    segments.push_back(Segment(a, b));
+    marks.push_back(has_marks ? pslg._segmentmarks[i] : 0);
+  }
+
+  // find the points inside each segment where it meets other segments
+  std::vector<geo2d::Segment<T>> geometry;
+  geometry.reserve(segments.size());
+  for (const Segment& s : segments)
+    geometry.emplace_back(points[s.first], points[s.second]);
+  std::vector<SegmentIntersection<T>> intersections;
+  intersect(geometry, intersections);
+
+  std::map<Point, unsigned> point_index;
+  if (!intersections.empty())
+    for (unsigned i = 0; i < points.size(); ++i) point_index[points[i]] = i;
+  auto index_of = [&](const Point& p) {
+    auto it = point_index.emplace(p, points.size());
+    if (it.second) {
+      points.push_back(p);
+      ++stats.n_added_points;
+    }
+    return it.first->second;
+  };
+  auto is_inside = [&](unsigned s, const Point& p) {
+    return !(p == geometry[s].first() || p == geometry[s].second());
+  };
+  std::vector<std::vector<unsigned>> splits(segments.size());
+  for (const SegmentIntersection<T>& x : intersections) {
+    unsigned s = x.first, t = x.second;
+    const geo2d::Segment<T>& gs = geometry[s];
+    const geo2d::Segment<T>& gt = geometry[t];
+    bool collinear =
+        orient_2d(gs.first(), gs.second(), gt.first()) == ORIENTATION::ON &&
+        orient_2d(gs.first(), gs.second(), gt.second()) == ORIENTATION::ON;
+    if (collinear) {
+      // an overlap splits each segment at the end points of the other one
+      for (unsigned k = 0; k < 2; ++k, std::swap(s, t)) {
+        const Point& lo = std::min(geometry[s].first(), geometry[s].second());
+        const Point& hi = std::max(geometry[s].first(), geometry[s].second());
+        for (const Point* p : {&geometry[t].first(), &geometry[t].second()})
+          if (lo < *p && *p < hi) splits[s].push_back(index_of(*p));
+      }
+      continue;
+    }
+    if (is_inside(s, x.point)) splits[s].push_back(index_of(x.point));
+    if (is_inside(t, x.point)) splits[t].push_back(index_of(x.point));
+  }
+
+  // replace the split segments by their pieces, an overlap yields the same
+  // piece twice
+  pslg._segments.clear();
+  pslg._segmentmarks.clear();
+  seen.clear();
+  auto add_segment = [&](unsigned a, unsigned b, int mark) {
+    if (!seen.insert(std::minmax(a, b)).second) return;
+    pslg._segments.push_back(Segment(a, b));
+    if (has_marks) pslg._segmentmarks.push_back(mark);
+  };
+  for (unsigned s = 0; s < segments.size(); ++s) {
+    std::vector<unsigned>& split = splits[s];
+    if (split.empty()) {
+      add_segment(segments[s].first, segments[s].second, marks[s]);
+      continue;
+    }
+    ++stats.n_split_segments;
+    // order the pieces from the first end point to the second one
+    bool forward = points[segments[s].first] < points[segments[s].second];
+    std::sort(split.begin(), split.end(), [&](unsigned i, unsigned j) {
+      return forward ? points[i] < points[j] : points[j] < points[i];
+    });
+    split.erase(std::unique(split.begin(), split.end()), split.end());
+    unsigned prev = segments[s].first;
+    for (unsigned p : split) {
+      add_segment(prev, p, marks[s]);
+      prev = p;
+    }
+    add_segment(prev, segments[s].second, marks[s]);
+  }
+  pslg._points.swap(points);
+  if (report) *report = stats;
+}
+
+}  // namespace algorithm
+}  // namespace CMTL
+
+#endif  // __algorithm_clean_pslg__
@@ -0,0 +1,221 @@
+#ifndef __algorithm_polygon_soup_to_surface_mesh__
+#define __algorithm_polygon_soup_to_surface_mesh__
+
+#include "../../common/union_find.h"
+#include "../../geo3d/polygon_soup.h"
+#include "../../geo3d/surface_mesh.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <queue>
+#include <vector>
+
+namespace CMTL {
+namespace algorithm {
+
+/**
+ * @brief what polygon_soup_to_surface_mesh changed to make the soup a valid
+ * halfedge mesh
+ */
+struct SoupToMeshReport {
+  /* polygons with less than 3 vertices or repeated vertices, removed */
+  unsigned n_removed_polygons = 0;
+  /* edges shared by more than 2 polygons, cut into boundaries */
+  unsigned n_non_manifold_edges = 0;
+  /* edges that can not be oriented consistently, cut into boundaries */
+  unsigned n_non_orientable_edges = 0;
+  /* polygons whose vertex order is reversed */
+  unsigned n_flipped_polygons = 0;
+  /* vertices added to split non-manifold vertices */
+  unsigned n_duplicated_vertices = 0;
+  /* polygons rejected by the mesh, 0 unless the input is broken */
+  unsigned n_rejected_polygons = 0;
+  /* number of connected components */
+  unsigned n_components = 0;
+};
+
+namespace internal {
+
+/* check whether a polygon has at least 3 distinct vertices */
+template <typename Polygon>
+bool is_valid_soup_polygon(const Polygon& polygon,
+                           std::vector<unsigned>& buffer) {
+  if (polygon.size() < 3) return false;
+  buffer.assign(polygon.begin(), polygon.end());
+  std::sort(buffer.begin(), buffer.end());
+  return std::adjacent_find(buffer.begin(), buffer.end()) == buffer.end();
+}
+
+}  // namespace internal
+
+/**
+ * @brief convert a polygon soup into a manifold surface mesh: degenerated
+ * polygons are removed, edges shared by more than 2 polygons are cut, each
+ * connected component is oriented consistently by a breadth first search
+ * (keeping the orientation of the majority of its polygons), and vertices
+ * whose polygons do not form a single fan are duplicated
+ * @param soup input polygon soup
+ * @param sm output surface mesh, the first points are the soup points in the
+ * same order, followed by the duplicated ones
+ * @param report what has been changed, ignored if null
+ * @note O(n log n) for n polygon corners
+ */
+template <typename T>
+void polygon_soup_to_surface_mesh(const geo3d::PolygonSoup<T>& soup,
+                                  geo3d::SurfaceMesh<T>& sm,
+                                  SoupToMeshReport* report = nullptr) {
+  typedef typename geo3d::SurfaceMesh<T>::VertexHandle VertexHandle;
+  SoupToMeshReport stats;
+
+  // flat copy of the valid polygons
+  std::vector<unsigned> offsets(1, 0), indices, buffer, soup_ids;
+  offsets.reserve(soup.n_polygons() + 1);
+  indices.reserve(soup.indices().size());
+  for (unsigned i = 0; i < soup.n_polygons(); ++i) {
+    auto polygon = soup.polygon(i);
+    if (!internal::is_valid_soup_polygon(polygon, buffer)) {
+      ++stats.n_removed_polygons;
+      continue;
+    }
+    indices.insert(indices.end(), polygon.begin(), polygon.end());
+    offsets.push_back(indices.size());
+  }
+  unsigned n_faces = offsets.size() - 1, n_corners = indices.size();
+
+  // corner c is the halfedge from indices[c] to indices[next[c]]
+  std::vector<unsigned> face_of(n_corners), next(n_corners);
+  for (unsigned f = 0; f < n_faces; ++f) {
+    for (unsigned c = offsets[f]; c < offsets[f + 1]; ++c) {
+      face_of[c] = f;
+      next[c] = c + 1 < offsets[f + 1] ? c + 1 : offsets[f];
+    }
+  }
+
+  // pair the halfedges by sorting packed undirected edge keys
+  std::vector<std::pair<uint64_t, unsigned>> keys(n_corners);
+  for (unsigned c = 0; c < n_corners; ++c) {
+    uint64_t a = indices[c], b = indices[next[c]];
+    keys[c] = std::make_pair(std::min(a, b) << 32 | std::max(a, b), c);
+  }
+  std::sort(keys.begin(), keys.end());
+  const unsigned NONE = ~0u;
+  std::vector<unsigned> partner(n_corners, NONE);
+  for (unsigned i = 0, j = 0; i < n_corners; i = j) {
+    while (j < n_corners && keys[j].first == keys[i].first) ++j;
+    if (j - i == 2) {
+      partner[keys[i].second] = keys[i + 1].second;
+      partner[keys[i + 1].second] = keys[i].second;
+    } else if (j - i > 2) {
+      ++stats.n_non_manifold_edges;
+    }
+  }
+
+  // orient the components, an edge is consistent if its two halfedges
+  // have opposite directions after the flips
+  std::vector<int> component(n_faces, -1);
+  std::vector<unsigned char> flipped(n_faces, 0);
+  std::vector<unsigned> members;
+  std::queue<unsigned> queue;
+  for (unsigned seed = 0; seed < n_faces; ++seed) {
+    if (component[seed] >= 0) continue;
+    int id = stats.n_components++;
+    members.clear();
+    component[seed] = id;
+    queue.push(seed);
+    while (!queue.empty()) {
+      unsigned f = queue.front();
+      queue.pop();
+      members.push_back(f);
+      for (unsigned c = offsets[f]; c < offsets[f + 1]; ++c) {
+        unsigned p = partner[c];
+        if (p == NONE) continue;
+        unsigned g = face_of[p];
+        bool same_direction = indices[c] == indices[p];
+        unsigned char flip = flipped[f] ^ same_direction;
+        if (component[g] < 0) {
+          component[g] = id;
+          flipped[g] = flip;
+          queue.push(g);
+        } else if (flipped[g] != flip) {
+          // non-orientable, e.g. a mobius strip
+          partner[c] = partner[p] = NONE;
+          ++stats.n_non_orientable_edges;
+        }
+      }
+    }
+    // keep the orientation of the majority
+    unsigned n_flipped = 0;
+    for (unsigned f : members) n_flipped += flipped[f];
+    if (2 * n_flipped > members.size())
+      for (unsigned f : members) flipped[f] ^= 1;
+  }
+
+  // group the corners of each vertex into fans connected by paired edges
+  UnionFind fans(n_corners);
+  for (unsigned c = 0; c < n_corners; ++c) {
+    unsigned p = partner[c];
+    if (p == NONE || p < c) continue;
+    if (indices[c] == indices[p]) {
+      fans.unite(c, p);
+      fans.unite(next[c], next[p]);
+    } else {
+      fans.unite(c, next[p]);
+      fans.unite(next[c], p);
+    }
+  }
+
+  // the first fan of a vertex keeps it, the others get copies
+  unsigned n_points = soup.n_points();
+  std::vector<int> fan_vertex(n_corners, -1);
+  std::vector<unsigned char> used(n_points, 0);
+  std::vector<unsigned> copies;
+  std::vector<unsigned> vertex_of(n_corners);
+  for (unsigned c = 0; c < n_corners; ++c) {
+    unsigned root = fans.find(c);
+    if (fan_vertex[root] < 0) {
+      unsigned v = indices[c];
+      if (!used[v]) {
+        used[v] = 1;
+        fan_vertex[root] = v;
+      } else {
+        fan_vertex[root] = n_points + copies.size();
+        copies.push_back(v);
+      }
+    }
+    vertex_of[c] = fan_vertex[root];
+  }
+  stats.n_duplicated_vertices = copies.size();
+
+  // oriented faces on the split vertices
+  std::vector<unsigned> mesh_indices(n_corners);
+  for (unsigned f = 0; f < n_faces; ++f) {
+    unsigned first = offsets[f], last = offsets[f + 1];
+    for (unsigned c = first; c < last; ++c)
+      mesh_indices[c] = vertex_of[c];
+    if (flipped[f]) {
+      std::reverse(mesh_indices.begin() + first, mesh_indices.begin() + last);
+      ++stats.n_flipped_polygons;
+    }
+  }
+
+  sm.clear();
+  unsigned n_vertices = n_points + copies.size();
+  sm.reserve(n_vertices, n_corners / 2 + n_faces, n_faces);
+  for (unsigned v = 0; v < n_points; ++v) sm.add_vertex(soup.point(v));
+  for (unsigned v : copies) sm.add_vertex(soup.point(v));
+  if (!sm.add_faces(offsets, mesh_indices)) {
+    std::vector<VertexHandle> fvhs;
+    for (unsigned f = 0; f < n_faces; ++f) {
+      fvhs.clear();
+      for (unsigned c = offsets[f]; c < offsets[f + 1]; ++c)
+        fvhs.push_back(VertexHandle(mesh_indices[c]));
+      if (!sm.add_face(fvhs).is_valid()) ++stats.n_rejected_polygons;
+    }
+  }
+  if (report) *report = stats;
+}
+
+}  // namespace algorithm
+}  // namespace CMTL
+
+#endif  // __algorithm_polygon_soup_to_surface_mesh__
@@ -0,0 +1,13 @@
+#ifndef __algorithm_spatial__
+#define __algorithm_spatial__
+
+#include "spatial/aabb_tree.h"
+#include "spatial/bvh_2d.h"
+#include "spatial/hash_grid.h"
+#include "spatial/kd_tree.h"
+
+namespace CMTL {
+namespace algorithm {}  // namespace algorithm
+}  // namespace CMTL
+
+#endif  // __algorithm_spatial__
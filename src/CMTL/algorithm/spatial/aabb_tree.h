@@ -0,0 +1,428 @@
+#ifndef __algorithm_aabb_tree__
+#define __algorithm_aabb_tree__
+
+#include "../../geo3d/box.h"
+#include "../../geo3d/surface_mesh.h"
+#include "bvh_builder.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace CMTL {
+namespace algorithm {
+
+/**
+ * @brief result of a ray cast
+ * @tparam T number type
+ */
+template <typename T>
+struct RayHit {
+  /* hit face, invalid if the ray misses the mesh */
+  halfedge::FaceHandle face;
+  /* parameter of the hit point ori + t * dir */
+  T t = T(0);
+};
+
+namespace internal {
+
+/* float box containing a box */
+template <typename T>
+FloatBox<3> outward_box(const geo3d::Box<T>& box) {
+  const geo3d::Point<T>& lo = box.min_corner();
+  const geo3d::Point<T>& hi = box.max_corner();
+  FloatBox<3> result;
+  for (unsigned k = 0; k < 3; ++k) {
+    result.lo[k] = round_down(lo[k]);
+    result.hi[k] = round_up(hi[k]);
+  }
+  return result;
+}
+
+/* ray sheared and scaled for the watertight ray triangle intersection of
+ * Woop, Benthin and Wald, "Watertight Ray/Triangle Intersection", 2013: the
+ * ray becomes the z-axis and the edge functions of two triangles sharing an
+ * edge are exactly opposite, so a ray can not slip between them */
+template <typename T>
+class WatertightRay {
+ public:
+  typedef geo3d::Point<T> Point;
+
+  WatertightRay() = default;
+
+  WatertightRay(const Point& ori, const Point& dir) : _ori(ori) {
+    assert(dir != Point::Origin);
+    _kz = dir.max_abs();
+    _kx = (_kz + 1) % 3;
+    _ky = (_kx + 1) % 3;
+    // keep the winding of the triangles
+    if (dir[_kz] < 0) std::swap(_kx, _ky);
+    _sx = dir[_kx] / dir[_kz];
+    _sy = dir[_ky] / dir[_kz];
+    _sz = T(1) / dir[_kz];
+  }
+
+ public:
+  /* parameter t >= 0, and t <= t_max if bounded, of the point where the ray
+   * meets triangle abc, both sides of the triangle are hit */
+  bool hit(const Point& a, const Point& b, const Point& c, bool bounded,
+           const T& t_max, T& t) const {
+    Point pa = a - _ori, pb = b - _ori, pc = c - _ori;
+    T ax = pa[_kx] - _sx * pa[_kz], ay = pa[_ky] - _sy * pa[_kz];
+    T bx = pb[_kx] - _sx * pb[_kz], by = pb[_ky] - _sy * pb[_kz];
+    T cx = pc[_kx] - _sx * pc[_kz], cy = pc[_ky] - _sy * pc[_kz];
+    T u = cx * by - cy * bx;
+    T v = ax * cy - ay * cx;
+    T w = bx * ay - by * ax;
+    if constexpr (std::is_floating_point<T>::value) {
+      // an edge through the ray needs a more precise sign
+      if (u == 0 || v == 0 || w == 0) {
+        typedef long double E;
+        u = T(E(cx) * E(by) - E(cy) * E(bx));
+        v = T(E(ax) * E(cy) - E(ay) * E(cx));
+        w = T(E(bx) * E(ay) - E(by) * E(ax));
+      }
+    }
+    if ((u < 0 || v < 0 || w < 0) && (u > 0 || v > 0 || w > 0)) return false;
+    T det = u + v + w;
+    if (det == 0) return false;
+    T s = (u * (_sz * pa[_kz]) + v * (_sz * pb[_kz]) + w * (_sz * pc[_kz])) /
+          det;
+    if (s < 0 || (bounded && s > t_max)) return false;
+    t = s;
+    return true;
+  }
+
+ private:
+  Point _ori;
+  unsigned _kx, _ky, _kz;
+  T _sx, _sy, _sz;
+};
+
+/* closest point of segment [a, b] to p */
+template <typename T>
+geo3d::Point<T> closest_on_segment(const geo3d::Point<T>& p,
+                                   const geo3d::Point<T>& a,
+                                   const geo3d::Point<T>& b) {
+  geo3d::Point<T> e = b - a;
+  T ee = e * e;
+  if (ee == 0) return a;
+  T t = ((p - a) * e) / ee;
+  if (t <= 0) return a;
+  if (t >= 1) return b;
+  return a + e * t;
+}
+
+/* closest point of triangle abc to p, by the Voronoi regions of the
+ * triangle, see Ericson, "Real-Time Collision Detection", 5.1.5 */
+template <typename T>
+geo3d::Point<T> closest_on_triangle(const geo3d::Point<T>& p,
+                                    const geo3d::Point<T>& a,
+                                    const geo3d::Point<T>& b,
+                                    const geo3d::Point<T>& c) {
+  typedef geo3d::Point<T> Point;
+  Point ab = b - a, ac = c - a;
+  if ((ab % ac) == Point::Origin) {
+    // degenerated triangle, the closest point is on an edge
+    Point best = closest_on_segment(p, a, b);
+    for (const Point& q :
+         {closest_on_segment(p, b, c), closest_on_segment(p, c, a)})
+      if ((q - p) * (q - p) < (best - p) * (best - p)) best = q;
+    return best;
+  }
+  Point ap = p - a;
+  T d1 = ab * ap, d2 = ac * ap;
+  if (d1 <= 0 && d2 <= 0) return a;
+  Point bp = p - b;
+  T d3 = ab * bp, d4 = ac * bp;
+  if (d3 >= 0 && d4 <= d3) return b;
+  T vc = d1 * d4 - d3 * d2;
+  if (vc <= 0 && d1 >= 0 && d3 <= 0) return a + ab * T(d1 / (d1 - d3));
+  Point cp = p - c;
+  T d5 = ab * cp, d6 = ac * cp;
+  if (d6 >= 0 && d5 <= d6) return c;
+  T vb = d5 * d2 - d1 * d6;
+  if (vb <= 0 && d2 >= 0 && d6 <= 0) return a + ac * T(d2 / (d2 - d6));
+  T va = d3 * d6 - d5 * d4;
+  if (va <= 0 && d4 - d3 >= 0 && d5 - d6 >= 0)
+    return b + (c - b) * T((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+  T sum = va + vb + vc;
+  return a + ab * T(vb / sum) + ac * T(vc / sum);
+}
+
+}  // namespace internal
+
+/**
+ * @brief axis-aligned bounding box tree over the faces of a surface mesh, for
+ * ray casting and closest point queries, built with a binned surface area
+ * heuristic, the 32 bytes nodes are stored in depth first order with 32-bit
+ * child indices and float bounds rounded outward, the queries are exact on
+ * the triangles for exact number types such as mpq_class
+ * @tparam T number type
+ * @note the faces are split into triangle fans and the triangles are copied,
+ * so the tree does not refer to the mesh and is rebuilt after it changed
+ */
+template <typename T>
+class AABBTree {
+ public:
+  typedef geo3d::Point<T> Point;
+  typedef halfedge::FaceHandle FaceHandle;
+  typedef internal::BVHNode<3> Node;
+
+  /** @brief number of coherent rays traversing the tree together */
+  static constexpr unsigned kPacketSize = 8;
+
+ public:
+  AABBTree() = default;
+
+  /**
+   * @brief build the tree of the faces of a mesh
+   * @param n_threads number of threads, 0 for default
+   */
+  template <class Traits>
+  AABBTree(const geo3d::SurfaceMesh<T, Traits>& sm, unsigned n_threads = 0) {
+    build(sm, n_threads);
+  }
+
+ public:
+  /**
+   * @brief rebuild the tree of the faces of a mesh
+   * @param n_threads number of threads, 0 for default
+   */
+  template <class Traits>
+  void build(const geo3d::SurfaceMesh<T, Traits>& sm, unsigned n_threads = 0) {
+    std::vector<Point> vertices;
+    std::vector<int> faces;
+    for (auto f_it = sm.faces_begin(); f_it != sm.faces_end(); ++f_it) {
+      auto fv = sm.fv_begin(*f_it);
+      const Point& first = sm.point(*fv);
+      const Point* prev = &sm.point(*++fv);
+      for (++fv; fv != sm.fv_end(*f_it); ++fv) {
+        vertices.push_back(first);
+        vertices.push_back(*prev);
+        vertices.push_back(sm.point(*fv));
+        faces.push_back(f_it->idx());
+        prev = &sm.point(*fv);
+      }
+    }
+
+    unsigned n = faces.size();
+    if (n_threads == 0) n_threads = default_threads(n, 1 << 12);
+    std::vector<internal::FloatBox<3>> boxes(n);
+    parallel_for(n, n_threads, [&](size_t begin, size_t end) {
+      for (size_t i = begin; i < end; ++i) {
+        geo3d::Box<T> box(vertices[3 * i], vertices[3 * i + 1]);
+        box.extend(vertices[3 * i + 2]);
+        boxes[i] = internal::outward_box(box);
+      }
+    });
+    std::vector<unsigned> order;
+    internal::BVHBuilder<3>::build(boxes, n_threads, _nodes, order);
+
+    // store the triangles in leaf order
+    _vertices.resize(3 * n);
+    _faces.resize(n);
+    for (unsigned k = 0; k < n; ++k) {
+      for (unsigned i = 0; i < 3; ++i)
+        _vertices[3 * k + i] = vertices[3 * order[k] + i];
+      _faces[k] = faces[order[k]];
+    }
+  }
+
+  /** @brief number of nodes */
+  size_t n_nodes() const { return _nodes.size(); }
+
+  /** @brief number of triangles */
+  size_t n_triangles() const { return _faces.size(); }
+
+  /** @brief nodes in depth first order, the first one is the root */
+  const std::vector<Node>& nodes() const { return _nodes; }
+
+  /**
+   * @brief get the bounding box of the mesh, rounded outward to float
+   */
+  geo3d::Box<T> bounding_box() const {
+    assert(!_nodes.empty());
+    const internal::FloatBox<3>& box = _nodes[0].box;
+    return geo3d::Box<T>(Point(T(box.lo[0]), T(box.lo[1]), T(box.lo[2])),
+                         Point(T(box.hi[0]), T(box.hi[1]), T(box.hi[2])));
+  }
+
+  /**
+   * @brief find the first face hit by the ray ori + t * dir, t >= 0
+   * @return true if the ray hits the mesh, otherwise false
+   */
+  bool ray_cast(const Point& ori, const Point& dir, RayHit<T>& hit) const {
+    return ray_cast(ori, dir, false, T(0), hit);
+  }
+
+  /**
+   * @brief find the first face hit by the ray ori + t * dir, 0 <= t <= t_max
+   * @return true if the ray hits the mesh, otherwise false
+   */
+  bool ray_cast(const Point& ori, const Point& dir, const T& t_max,
+                RayHit<T>& hit) const {
+    return ray_cast(ori, dir, true, t_max, hit);
+  }
+
+  /**
+   * @brief cast many rays, consecutive rays are traversed together in
+   * packets of kPacketSize, which is faster if they are coherent, such as
+   * the rays of neighbouring pixels
+   * @param origins ray origins
+   * @param directions ray directions
+   * @param hits first hit of each ray, with an invalid face if none
+   * @param n_threads number of threads, 0 for default
+   */
+  void ray_cast(const std::vector<Point>& origins,
+                const std::vector<Point>& directions,
+                std::vector<RayHit<T>>& hits, unsigned n_threads = 0) const {
+    assert(origins.size() == directions.size());
+    size_t n = origins.size();
+    hits.assign(n, RayHit<T>());
+    size_t n_packets = (n + kPacketSize - 1) / kPacketSize;
+    if (n_threads == 0) n_threads = default_threads(n, 1 << 10);
+    parallel_for(n_packets, n_threads, [&](size_t begin, size_t end) {
+      for (size_t i = begin; i < end; ++i) {
+        size_t first = i * kPacketSize;
+        unsigned size = std::min<size_t>(kPacketSize, n - first);
+        cast_packet(&origins[first], &directions[first], size, &hits[first]);
+      }
+    });
+  }
+
+  /**
+   * @brief find the closest point of the mesh to a point
+   * @param face face of the closest point
+   * @param closest closest point
+   * @return false if the mesh has no face
+   */
+  bool closest_point(const Point& p, FaceHandle& face, Point& closest) const {
+    if (_nodes.empty()) return false;
+    const double q[3] = {to_double(p[0]), to_double(p[1]), to_double(p[2])};
+    bool found = false;
+    T best(0);
+    double best_bound = std::numeric_limits<double>::infinity();
+    internal::BVHNodeStack stack;
+    stack.push(0);
+    while (!stack.empty()) {
+      const Node& node = _nodes[stack.pop()];
+      if (node.box.squared_distance(q) > best_bound) continue;
+      if (node.count == 0) {
+        // visit the nearer child first
+        std::uint32_t first = &node - _nodes.data() + 1, second = node.index;
+        if (_nodes[second].box.squared_distance(q) <
+            _nodes[first].box.squared_distance(q))
+          std::swap(first, second);
+        stack.push(second);
+        stack.push(first);
+        continue;
+      }
+      for (unsigned k = node.index; k < node.index + node.count; ++k) {
+        const Point* v = &_vertices[3 * k];
+        Point candidate = internal::closest_on_triangle(p, v[0], v[1], v[2]);
+        T d = (candidate - p) * (candidate - p);
+        if (found && !(d < best)) continue;
+        found = true;
+        best = d;
+        best_bound = to_double(best);
+        face = FaceHandle(_faces[k]);
+        closest = candidate;
+      }
+    }
+    return true;
+  }
+
+ private:
+  bool ray_cast(const Point& ori, const Point& dir, bool bounded,
+                const T& t_max, RayHit<T>& hit) const {
+    RayHit<T> result;
+    cast_packet(&ori, &dir, 1, &result, bounded, t_max);
+    if (!result.face.is_valid()) return false;
+    hit = result;
+    return true;
+  }
+
+  /* traverse the tree once for up to kPacketSize rays, a node is visited if
+   * one of the rays may hit it */
+  void cast_packet(const Point* origins, const Point* directions,
+                   unsigned size, RayHit<T>* hits, bool bounded = false,
+                   const T& t_max = T(0)) const {
+    if (_nodes.empty()) return;
+    internal::WatertightRay<T> rays[kPacketSize];
+    internal::TraversalRay<3> box_rays[kPacketSize];
+    double bound[kPacketSize];
+    for (unsigned r = 0; r < size; ++r) {
+      rays[r] = internal::WatertightRay<T>(origins[r], directions[r]);
+      box_rays[r] = internal::TraversalRay<3>(origins[r], directions[r]);
+      bound[r] = bounded ? to_double(t_max)
+                         : std::numeric_limits<double>::infinity();
+    }
+    auto enter = [&](const internal::FloatBox<3>& box, unsigned r) {
+      double t0 = 0, t1 = bound[r];
+      return box.clip(box_rays[r], t0, t1);
+    };
+
+    // a node is pushed with the first ray which hits its parent, the rays
+    // before it missed the parent so they miss the node
+    T t;
+    internal::BVHNodeStack stack, first_rays;
+    stack.push(0);
+    first_rays.push(0);
+    while (!stack.empty()) {
+      const Node& node = _nodes[stack.pop()];
+      unsigned first_ray = first_rays.pop();
+      while (first_ray < size && !enter(node.box, first_ray)) ++first_ray;
+      if (first_ray == size) continue;
+      if (node.count == 0) {
+        // visit first the child nearer along the first ray
+        const double* o = box_rays[first_ray].ori;
+        const double* d = box_rays[first_ray].dir;
+        std::uint32_t first = &node - _nodes.data() + 1, second = node.index;
+        double t_first = 0, t_second = 0;
+        for (unsigned k = 0; k < 3; ++k) {
+          t_first += d[k] * (_nodes[first].box.lo[k] +
+                             _nodes[first].box.hi[k] - 2 * o[k]);
+          t_second += d[k] * (_nodes[second].box.lo[k] +
+                              _nodes[second].box.hi[k] - 2 * o[k]);
+        }
+        if (t_second < t_first) std::swap(first, second);
+        stack.push(second);
+        first_rays.push(first_ray);
+        stack.push(first);
+        first_rays.push(first_ray);
+        continue;
+      }
+      for (unsigned r = first_ray; r < size; ++r) {
+        if (r != first_ray && !enter(node.box, r)) continue;
+        for (unsigned k = node.index; k < node.index + node.count; ++k) {
+          const Point* v = &_vertices[3 * k];
+          bool found = hits[r].face.is_valid();
+          if (!rays[r].hit(v[0], v[1], v[2], bounded || found,
+                           found ? hits[r].t : t_max, t) ||
+              (found && !(t < hits[r].t)))
+            continue;
+          hits[r].face = FaceHandle(_faces[k]);
+          hits[r].t = t;
+          bound[r] = to_double(t);
+        }
+      }
+    }
+  }
+
+ private:
+  std::vector<Node> _nodes;
+  /* vertices of the triangles in leaf order */
+  std::vector<Point> _vertices;
+  /* face index of the triangles in leaf order */
+  std::vector<int> _faces;
+};
+
+}  // namespace algorithm
+}  // namespace CMTL
+
+#endif  // __algorithm_aabb_tree__
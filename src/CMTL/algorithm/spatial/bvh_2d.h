@@ -0,0 +1,568 @@
+#ifndef __algorithm_bvh_2d__
+#define __algorithm_bvh_2d__
+
+#include "../../geo2d/box.h"
+#include "../../geo2d/polygon_soup.h"
+#include "../../geo2d/segment.h"
+#include "../../geo2d/triangle.h"
+#include "../intersect/box_line_intersect.h"
+#include "../predicate.h"
+#include "bvh_builder.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace CMTL {
+namespace algorithm {
+
+namespace internal {
+
+/* float box containing a box */
+template <typename T>
+FloatBox<2> outward_box(const geo2d::Box<T>& box) {
+  return FloatBox<2>{{round_down(box.left()), round_down(box.bottom())},
+                     {round_up(box.right()), round_up(box.top())}};
+}
+
+template <typename T>
+bool contains(const geo2d::Box<T>& box, const geo2d::Point<T>& p) {
+  return box.left() <= p.x() && p.x() <= box.right() &&
+         box.bottom() <= p.y() && p.y() <= box.top();
+}
+
+/* closest point of segment [a, b] to p */
+template <typename T>
+geo2d::Point<T> closest_on_segment(const geo2d::Point<T>& p,
+                                   const geo2d::Point<T>& a,
+                                   const geo2d::Point<T>& b) {
+  geo2d::Point<T> e = b - a;
+  T ee = e * e;
+  if (ee == 0) return a;
+  T t = ((p - a) * e) / ee;
+  if (t <= 0) return a;
+  if (t >= 1) return b;
+  return a + e * t;
+}
+
+/* smallest parameter t >= 0, and t <= t_max if bounded, such that ori + t *
+ * dir is on segment [a, b] */
+template <typename T>
+bool segment_hit(const geo2d::Point<T>& ori, const geo2d::Point<T>& dir,
+                 bool bounded, const T& t_max, const geo2d::Point<T>& a,
+                 const geo2d::Point<T>& b, T& t) {
+  geo2d::Point<T> e = b - a, w = a - ori;
+  T denominator = dir % e;
+  if (denominator != 0) {
+    T s = (w % e) / denominator;
+    T u = (w % dir) / denominator;
+    if (s < 0 || (bounded && s > t_max) || u < 0 || u > 1) return false;
+    t = s;
+    return true;
+  }
+  if (w % dir != 0) return false;
+  // collinear, the overlap starts at the nearest end point or at ori
+  T dd = dir * dir;
+  T ta = (w * dir) / dd;
+  T tb = ((b - ori) * dir) / dd;
+  if (tb < ta) std::swap(ta, tb);
+  if (tb < 0 || (bounded && ta > t_max)) return false;
+  t = ta < 0 ? T(0) : ta;
+  return true;
+}
+
+/* whether the closed polygon made of vertex(0), ..., vertex(n - 1) contains
+ * p, with the even-odd rule */
+template <typename T, typename Vertex>
+bool ring_contains(const Vertex& vertex, unsigned n,
+                   const geo2d::Point<T>& p) {
+  bool inside = false;
+  for (unsigned i = 0, j = n - 1; i < n; j = i++) {
+    const geo2d::Point<T>& a = vertex(j);
+    const geo2d::Point<T>& b = vertex(i);
+    ORIENTATION o = orient_2d(a, b, p);
+    if (o == ORIENTATION::ON && std::min(a.x(), b.x()) <= p.x() &&
+        p.x() <= std::max(a.x(), b.x()) && std::min(a.y(), b.y()) <= p.y() &&
+        p.y() <= std::max(a.y(), b.y()))
+      return true;
+    if ((a.y() > p.y()) != (b.y() > p.y()) &&
+        o == (b.y() > a.y() ? ORIENTATION::POSITIVE : ORIENTATION::NEGATIVE))
+      inside = !inside;
+  }
+  return inside;
+}
+
+template <typename T, typename Vertex>
+geo2d::Box<T> ring_box(const Vertex& vertex, unsigned n) {
+  geo2d::Box<T> box(vertex(0), vertex(0));
+  for (unsigned i = 1; i < n; ++i) {
+    const geo2d::Point<T>& p = vertex(i);
+    if (p.x() < box.left()) box.left() = p.x();
+    if (p.x() > box.right()) box.right() = p.x();
+    if (p.y() < box.bottom()) box.bottom() = p.y();
+    if (p.y() > box.top()) box.top() = p.y();
+  }
+  return box;
+}
+
+template <typename T, typename Vertex>
+bool ring_overlap(const Vertex& vertex, unsigned n, const geo2d::Box<T>& box) {
+  for (unsigned i = 0; i < n; ++i)
+    if (contains(box, vertex(i))) return true;
+  if (ring_contains(vertex, n, box.left_bottom())) return true;
+  T t0, t1;
+  for (unsigned i = 0, j = n - 1; i < n; j = i++) {
+    if (vertex(i) == vertex(j)) continue;
+    if (algorithm::intersect(box, geo2d::Segment<T>(vertex(j), vertex(i)),
+                             t0, t1))
+      return true;
+  }
+  return false;
+}
+
+template <typename T, typename Vertex>
+T ring_squared_distance(const Vertex& vertex, unsigned n,
+                        const geo2d::Point<T>& p,
+                        geo2d::Point<T>& closest) {
+  if (ring_contains(vertex, n, p)) {
+    closest = p;
+    return T(0);
+  }
+  T best(0);
+  for (unsigned i = 0, j = n - 1; i < n; j = i++) {
+    geo2d::Point<T> q = closest_on_segment(p, vertex(j), vertex(i));
+    T d = (q - p) * (q - p);
+    if (i == 0 || d < best) {
+      best = d;
+      closest = q;
+    }
+  }
+  return best;
+}
+
+template <typename T, typename Vertex>
+bool ring_hit(const Vertex& vertex, unsigned n, const geo2d::Point<T>& ori,
+              const geo2d::Point<T>& dir, bool bounded, const T& t_max,
+              T& t) {
+  if (ring_contains(vertex, n, ori)) {
+    t = T(0);
+    return true;
+  }
+  bool found = false;
+  T s;
+  for (unsigned i = 0, j = n - 1; i < n; j = i++) {
+    if (segment_hit(ori, dir, bounded, found ? t : t_max, vertex(j),
+                    vertex(i), s) &&
+        (!found || s < t)) {
+      t = s;
+      found = true;
+      bounded = true;
+    }
+  }
+  return found;
+}
+
+}  // namespace internal
+
+/**
+ * @brief segments as primitives of BVH2D
+ * @note the segments are referenced, not copied
+ */
+template <typename T>
+class BVH2DSegments {
+ public:
+  BVH2DSegments(const std::vector<geo2d::Segment<T>>& segments)
+      : _segments(&segments) {}
+
+ public:
+  size_t size() const { return _segments->size(); }
+
+  geo2d::Box<T> box(unsigned i) const {
+    return geo2d::Box<T>((*_segments)[i].first(), (*_segments)[i].second());
+  }
+
+  bool overlap(unsigned i, const geo2d::Box<T>& box) const {
+    const geo2d::Segment<T>& s = (*_segments)[i];
+    if (s.first() == s.second()) return internal::contains(box, s.first());
+    T t0, t1;
+    return algorithm::intersect(box, s, t0, t1);
+  }
+
+  T squared_distance(unsigned i, const geo2d::Point<T>& p,
+                     geo2d::Point<T>& closest) const {
+    const geo2d::Segment<T>& s = (*_segments)[i];
+    closest = internal::closest_on_segment(p, s.first(), s.second());
+    return (closest - p) * (closest - p);
+  }
+
+  bool hit(unsigned i, const geo2d::Point<T>& ori, const geo2d::Point<T>& dir,
+           bool bounded, const T& t_max, T& t) const {
+    const geo2d::Segment<T>& s = (*_segments)[i];
+    return internal::segment_hit(ori, dir, bounded, t_max, s.first(),
+                                 s.second(), t);
+  }
+
+ private:
+  const std::vector<geo2d::Segment<T>>* _segments;
+};
+
+/**
+ * @brief solid triangles as primitives of BVH2D
+ * @note the triangles are referenced, not copied
+ */
+template <typename T>
+class BVH2DTriangles {
+ public:
+  BVH2DTriangles(const std::vector<geo2d::Triangle<T>>& triangles)
+      : _triangles(&triangles) {}
+
+ public:
+  size_t size() const { return _triangles->size(); }
+
+  geo2d::Box<T> box(unsigned i) const {
+    return internal::ring_box<T>(vertex(i), 3);
+  }
+
+  bool overlap(unsigned i, const geo2d::Box<T>& box) const {
+    return internal::ring_overlap(vertex(i), 3, box);
+  }
+
+  T squared_distance(unsigned i, const geo2d::Point<T>& p,
+                     geo2d::Point<T>& closest) const {
+    return internal::ring_squared_distance(vertex(i), 3, p, closest);
+  }
+
+  bool hit(unsigned i, const geo2d::Point<T>& ori, const geo2d::Point<T>& dir,
+           bool bounded, const T& t_max, T& t) const {
+    return internal::ring_hit(vertex(i), 3, ori, dir, bounded, t_max, t);
+  }
+
+ private:
+  auto vertex(unsigned i) const {
+    const geo2d::Triangle<T>& triangle = (*_triangles)[i];
+    return [&triangle](unsigned k) -> const geo2d::Point<T>& {
+      return triangle[k];
+    };
+  }
+
+ private:
+  const std::vector<geo2d::Triangle<T>>* _triangles;
+};
+
+/**
+ * @brief solid polygons of a polygon soup as primitives of BVH2D, a polygon
+ * contains the points inside it by the even-odd rule
+ * @note the polygon soup is referenced, not copied
+ */
+template <typename T>
+class BVH2DPolygonSoup {
+ public:
+  BVH2DPolygonSoup(const geo2d::PolygonSoup<T>& soup) : _soup(&soup) {}
+
+ public:
+  size_t size() const { return _soup->n_polygons(); }
+
+  geo2d::Box<T> box(unsigned i) const {
+    return internal::ring_box<T>(vertex(i), n_vertices(i));
+  }
+
+  bool overlap(unsigned i, const geo2d::Box<T>& box) const {
+    return internal::ring_overlap(vertex(i), n_vertices(i), box);
+  }
+
+  T squared_distance(unsigned i, const geo2d::Point<T>& p,
+                     geo2d::Point<T>& closest) const {
+    return internal::ring_squared_distance(vertex(i), n_vertices(i), p,
+                                           closest);
+  }
+
+  bool hit(unsigned i, const geo2d::Point<T>& ori, const geo2d::Point<T>& dir,
+           bool bounded, const T& t_max, T& t) const {
+    return internal::ring_hit(vertex(i), n_vertices(i), ori, dir, bounded,
+                              t_max, t);
+  }
+
+ private:
+  unsigned n_vertices(unsigned i) const { return _soup->polygon(i).size(); }
+
+  auto vertex(unsigned i) const {
+    const geo2d::PolygonSoup<T>* soup = _soup;
+    const unsigned* indices = soup->indices().data() + soup->offsets()[i];
+    return [soup, indices](unsigned k) -> const geo2d::Point<T>& {
+      return soup->point(indices[k]);
+    };
+  }
+
+ private:
+  const geo2d::PolygonSoup<T>* _soup;
+};
+
+/**
+ * @brief flattened bounding volume hierarchy of 2d primitives, built with a
+ * binned surface area heuristic, the 32 bytes nodes are stored in depth first
+ * order with float bounds rounded outward, the queries are exact on the
+ * primitives
+ * @tparam T number type
+ * @tparam Primitives primitive set such as BVH2DSegments, BVH2DTriangles or
+ * BVH2DPolygonSoup, which provides size(), box(i), overlap(i, box),
+ * squared_distance(i, p, closest) and hit(i, ori, dir, bounded, t_max, t)
+ */
+template <typename T, typename Primitives>
+class BVH2D {
+ public:
+  typedef geo2d::Point<T> Point;
+  typedef internal::BVHNode<2> Node;
+
+ public:
+  /**
+   * @brief build the hierarchy of primitives
+   * @param n_threads number of threads, 0 for default
+   * @note the primitives are referenced and must outlive the hierarchy
+   */
+  BVH2D(const Primitives& primitives, unsigned n_threads = 0)
+      : _primitives(primitives) {
+    build(n_threads);
+  }
+
+ public:
+  /**
+   * @brief rebuild the hierarchy, after primitives were added or removed
+   * @param n_threads number of threads, 0 for default
+   */
+  void build(unsigned n_threads = 0) {
+    unsigned n = _primitives.size();
+    if (n_threads == 0) n_threads = default_threads(n, 1 << 12);
+    _boxes.resize(n);
+    parallel_for(n, n_threads, [&](size_t begin, size_t end) {
+      for (size_t i = begin; i < end; ++i)
+        _boxes[i] = internal::outward_box(_primitives.box(i));
+    });
+    internal::BVHBuilder<2>::build(_boxes, n_threads, _nodes, _order);
+  }
+
+  /**
+   * @brief update the bounds after the primitives moved, the tree structure
+   * is kept, so the queries remain correct but may slow down if the
+   * primitives moved much
+   * @param n_threads number of threads, 0 for default
+   */
+  void refit(unsigned n_threads = 0) {
+    unsigned n = _order.size();
+    assert(n == _primitives.size());
+    if (n_threads == 0) n_threads = default_threads(n, 1 << 12);
+    parallel_for(n, n_threads, [&](size_t begin, size_t end) {
+      for (size_t k = begin; k < end; ++k)
+        _boxes[k] = internal::outward_box(_primitives.box(_order[k]));
+    });
+    internal::BVHBuilder<2>::refit(_boxes, _nodes);
+  }
+
+  /** @brief number of nodes */
+  size_t n_nodes() const { return _nodes.size(); }
+
+  /** @brief nodes in depth first order, the first one is the root */
+  const std::vector<Node>& nodes() const { return _nodes; }
+
+  /**
+   * @brief find the primitives overlapping a box
+   * @param result indices of the primitives, in no particular order
+   */
+  void overlap(const geo2d::Box<T>& box, std::vector<unsigned>& result) const {
+    result.clear();
+    if (_nodes.empty()) return;
+    internal::FloatBox<2> query = internal::outward_box(box);
+    internal::BVHNodeStack stack;
+    stack.push(0);
+    while (!stack.empty()) {
+      const Node& node = _nodes[stack.pop()];
+      if (!node.box.overlap(query)) continue;
+      if (node.count == 0) {
+        stack.push(node.index);
+        stack.push(&node - _nodes.data() + 1);
+        continue;
+      }
+      for (unsigned k = node.index; k < node.index + node.count; ++k)
+        if (_boxes[k].overlap(query) && _primitives.overlap(_order[k], box))
+          result.push_back(_order[k]);
+    }
+  }
+
+  /**
+   * @brief find the closest primitive to a point
+   * @param primitive index of the closest primitive
+   * @param closest closest point on it
+   * @return false if there is no primitive
+   */
+  bool closest_point(const Point& p, unsigned& primitive,
+                     Point& closest) const {
+    if (_nodes.empty()) return false;
+    const double q[2] = {to_double(p.x()), to_double(p.y())};
+    bool found = false;
+    T best(0);
+    double best_bound = std::numeric_limits<double>::infinity();
+    Point candidate;
+    internal::BVHNodeStack stack;
+    stack.push(0);
+    while (!stack.empty()) {
+      const Node& node = _nodes[stack.pop()];
+      if (node.box.squared_distance(q) > best_bound) continue;
+      if (node.count == 0) {
+        // visit the nearer child first
+        std::uint32_t first = &node - _nodes.data() + 1, second = node.index;
+        if (_nodes[second].box.squared_distance(q) <
+            _nodes[first].box.squared_distance(q))
+          std::swap(first, second);
+        stack.push(second);
+        stack.push(first);
+        continue;
+      }
+      for (unsigned k = node.index; k < node.index + node.count; ++k) {
+        if (_boxes[k].squared_distance(q) > best_bound) continue;
+        T d = _primitives.squared_distance(_order[k], p, candidate);
+        if (found && !(d < best)) continue;
+        found = true;
+        best = d;
+        best_bound = to_double(best);
+        primitive = _order[k];
+        closest = candidate;
+      }
+    }
+    return true;
+  }
+
+  /**
+   * @brief find the first primitive met by a segment from its first point
+   * @param primitive index of the primitive
+   * @param t parameter of the first common point on segment
+   * @return true if the segment meets a primitive, otherwise false
+   */
+  bool first_hit(const geo2d::Segment<T>& segment, unsigned& primitive,
+                 T& t) const {
+    return first_hit(segment.first(), segment.direction(), true, T(1),
+                     primitive, t);
+  }
+
+  /**
+   * @brief find the first primitive met by a ray
+   * @param primitive index of the primitive
+   * @param t parameter of the first common point on ray
+   * @return true if the ray meets a primitive, otherwise false
+   */
+  bool first_hit(const geo2d::Ray<T>& ray, unsigned& primitive, T& t) const {
+    return first_hit(ray.origin(), ray.direction(), false, T(0), primitive,
+                     t);
+  }
+
+  /**
+   * @brief find the primitives met by a segment
+   * @param result indices of the primitives, in no particular order
+   */
+  void intersect(const geo2d::Segment<T>& segment,
+                 std::vector<unsigned>& result) const {
+    result.clear();
+    if (_nodes.empty()) return;
+    const Point& ori = segment.first();
+    Point dir = segment.direction();
+    assert(dir != Point::Origin);
+    const internal::TraversalRay<2> ray(ori, dir);
+    T t;
+    internal::BVHNodeStack stack;
+    stack.push(0);
+    while (!stack.empty()) {
+      const Node& node = _nodes[stack.pop()];
+      if (!hit_box(node.box, ray, 1)) continue;
+      if (node.count == 0) {
+        stack.push(node.index);
+        stack.push(&node - _nodes.data() + 1);
+        continue;
+      }
+      for (unsigned k = node.index; k < node.index + node.count; ++k)
+        if (hit_box(_boxes[k], ray, 1) &&
+            _primitives.hit(_order[k], ori, dir, true, T(1), t))
+          result.push_back(_order[k]);
+    }
+  }
+
+ private:
+  /* entry parameter of ori + t * dir, 0 <= t <= t_max, into a box */
+  static bool hit_box(const internal::FloatBox<2>& box,
+                      const internal::TraversalRay<2>& ray, double t_max,
+                      double* t_enter = nullptr) {
+    double t0 = 0, t1 = t_max;
+    if (!box.clip(ray, t0, t1)) return false;
+    if (t_enter) *t_enter = t0;
+    return true;
+  }
+
+  bool first_hit(const Point& ori, const Point& dir, bool bounded,
+                 const T& t_max, unsigned& primitive, T& t) const {
+    if (_nodes.empty()) return false;
+    assert(dir != Point::Origin);
+    const internal::TraversalRay<2> ray(ori, dir);
+    bool found = false;
+    double bound = bounded ? to_double(t_max)
+                           : std::numeric_limits<double>::infinity();
+    T s;
+    internal::BVHNodeStack stack;
+    stack.push(0);
+    while (!stack.empty()) {
+      const Node& node = _nodes[stack.pop()];
+      if (!hit_box(node.box, ray, bound)) continue;
+      if (node.count == 0) {
+        // visit the nearer child first
+        std::uint32_t first = &node - _nodes.data() + 1, second = node.index;
+        double t_first, t_second;
+        bool hit_first = hit_box(_nodes[first].box, ray, bound, &t_first);
+        bool hit_second =
+            hit_box(_nodes[second].box, ray, bound, &t_second);
+        if (hit_second && (!hit_first || t_second < t_first)) {
+          std::swap(first, second);
+          std::swap(hit_first, hit_second);
+        }
+        if (hit_second) stack.push(second);
+        if (hit_first) stack.push(first);
+        continue;
+      }
+      for (unsigned k = node.index; k < node.index + node.count; ++k) {
+        if (!hit_box(_boxes[k], ray, bound)) continue;
+        if (!_primitives.hit(_order[k], ori, dir, bounded || found,
+                             found ? t : t_max, s) ||
+            (found && !(s < t)))
+          continue;
+        found = true;
+        t = s;
+        primitive = _order[k];
+        bound = to_double(t);
+      }
+    }
+    return found;
+  }
+
+ private:
+  Primitives _primitives;
+  std::vector<Node> _nodes;
+  /* primitive indices in leaf order */
+  std::vector<unsigned> _order;
+  /* primitive boxes in leaf order */
+  std::vector<internal::FloatBox<2>> _boxes;
+};
+
+/** @brief bounding volume hierarchy of segments */
+template <typename T>
+using SegmentBVH2D = BVH2D<T, BVH2DSegments<T>>;
+
+/** @brief bounding volume hierarchy of triangles */
+template <typename T>
+using TriangleBVH2D = BVH2D<T, BVH2DTriangles<T>>;
+
+/** @brief bounding volume hierarchy of polygon soup faces */
+template <typename T>
+using PolygonSoupBVH2D = BVH2D<T, BVH2DPolygonSoup<T>>;
+
+}  // namespace algorithm
+}  // namespace CMTL
+
+#endif  // __algorithm_bvh_2d__
@@ -0,0 +1,328 @@
+#ifndef __algorithm_bvh_builder__
+#define __algorithm_bvh_builder__
+
+#include "../../common/numeric_utils.h"
+#include "../../common/parallel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace CMTL {
+namespace algorithm {
+
+namespace internal {
+
+/* largest float not above a number */
+template <typename T>
+float round_down(const T& v) {
+  // one more float step covers the rounding of the double conversion
+  return std::nextafter(static_cast<float>(to_double(v)),
+                        -std::numeric_limits<float>::infinity());
+}
+
+/* smallest float not below a number */
+template <typename T>
+float round_up(const T& v) {
+  return std::nextafter(static_cast<float>(to_double(v)),
+                        std::numeric_limits<float>::infinity());
+}
+
+/* ray ori + t * dir in double for the traversal of the boxes */
+template <unsigned DIM>
+struct TraversalRay {
+  double ori[DIM];
+  double dir[DIM];
+  double inv_dir[DIM];
+
+  TraversalRay() = default;
+
+  template <typename Point>
+  TraversalRay(const Point& o, const Point& d) {
+    for (unsigned k = 0; k < DIM; ++k) {
+      ori[k] = to_double(o[k]);
+      dir[k] = to_double(d[k]);
+      inv_dir[k] = 1.0 / dir[k];
+    }
+  }
+};
+
+/* box with float bounds, rounded outward so that it contains the exact box */
+template <unsigned DIM>
+struct FloatBox {
+  float lo[DIM];
+  float hi[DIM];
+
+  static FloatBox empty() {
+    FloatBox box;
+    std::fill(box.lo, box.lo + DIM, std::numeric_limits<float>::infinity());
+    std::fill(box.hi, box.hi + DIM, -std::numeric_limits<float>::infinity());
+    return box;
+  }
+
+  void merge(const FloatBox& other) {
+    for (unsigned k = 0; k < DIM; ++k) {
+      lo[k] = std::min(lo[k], other.lo[k]);
+      hi[k] = std::max(hi[k], other.hi[k]);
+    }
+  }
+
+  void merge(const float* p) {
+    for (unsigned k = 0; k < DIM; ++k) {
+      lo[k] = std::min(lo[k], p[k]);
+      hi[k] = std::max(hi[k], p[k]);
+    }
+  }
+
+  bool overlap(const FloatBox& other) const {
+    for (unsigned k = 0; k < DIM; ++k)
+      if (other.hi[k] < lo[k] || hi[k] < other.lo[k]) return false;
+    return true;
+  }
+
+  /* half of the boundary measure, the cost of the surface area heuristic */
+  float area() const {
+    if (hi[0] < lo[0]) return 0;
+    if (DIM == 2) return (hi[0] - lo[0]) + (hi[1] - lo[1]);
+    float result = 0;
+    for (unsigned k = 0; k < DIM; ++k)
+      result += (hi[k] - lo[k]) * (hi[(k + 1) % DIM] - lo[(k + 1) % DIM]);
+    return result;
+  }
+
+  /* squared distance from a point, 0 if inside */
+  double squared_distance(const double* p) const {
+    double result = 0;
+    for (unsigned k = 0; k < DIM; ++k) {
+      double d = std::max({double(lo[k]) - p[k], p[k] - double(hi[k]), 0.0});
+      result += d * d;
+    }
+    return result;
+  }
+
+  /* clip the parameter range [t0, t1] of a ray */
+  bool clip(const TraversalRay<DIM>& ray, double& t0, double& t1) const {
+    for (unsigned k = 0; k < DIM; ++k) {
+      if (ray.dir[k] == 0) {
+        if (ray.ori[k] < lo[k] || ray.ori[k] > hi[k]) return false;
+        continue;
+      }
+      double t_enter = (lo[k] - ray.ori[k]) * ray.inv_dir[k];
+      double t_leave = (hi[k] - ray.ori[k]) * ray.inv_dir[k];
+      if (ray.dir[k] < 0) std::swap(t_enter, t_leave);
+      t0 = std::max(t0, t_enter);
+      t1 = std::min(t1, t_leave);
+      if (t1 < t0) return false;
+    }
+    return true;
+  }
+};
+
+/* node of a flattened bounding volume hierarchy, nodes are stored in depth
+ * first order so the first child of an inner node follows it */
+template <unsigned DIM>
+struct alignas(32) BVHNode {
+  FloatBox<DIM> box;
+  /* second child of an inner node, first primitive of a leaf */
+  std::uint32_t index;
+  /* number of primitives of a leaf, 0 for an inner node */
+  std::uint32_t count;
+};
+
+static_assert(sizeof(BVHNode<2>) == 32 && sizeof(BVHNode<3>) == 32,
+              "a bvh node should be 32 bytes");
+
+/* stack of node indices for traversal, only allocates for deep trees */
+class BVHNodeStack {
+ public:
+  bool empty() const { return _size == 0; }
+
+  void push(std::uint32_t node) {
+    if (_size < kLocal) {
+      _local[_size++] = node;
+      return;
+    }
+    _more.push_back(node);
+    ++_size;
+  }
+
+  std::uint32_t pop() {
+    --_size;
+    if (_size < kLocal) return _local[_size];
+    std::uint32_t node = _more.back();
+    _more.pop_back();
+    return node;
+  }
+
+ private:
+  static constexpr unsigned kLocal = 64;
+  std::uint32_t _local[kLocal];
+  std::vector<std::uint32_t> _more;
+  unsigned _size = 0;
+};
+
+/* top-down builder of a bounding volume hierarchy with a binned surface area
+ * heuristic, the subtrees are built by separate threads and appended, so the
+ * result does not depend on the number of threads */
+template <unsigned DIM>
+class BVHBuilder {
+ public:
+  typedef FloatBox<DIM> Box;
+  typedef BVHNode<DIM> Node;
+
+  /* boxes are indexed by primitive, order gets the primitives in leaf order
+   * and the boxes are reordered the same way */
+  static void build(std::vector<Box>& boxes, unsigned n_threads,
+                    std::vector<Node>& nodes, std::vector<unsigned>& order) {
+    unsigned n = boxes.size();
+    nodes.clear();
+    order.resize(n);
+    std::iota(order.begin(), order.end(), 0u);
+    if (n == 0) return;
+    BVHBuilder builder(boxes, order);
+    parallel_for(n, n_threads, [&](size_t begin, size_t end) {
+      for (size_t i = begin; i < end; ++i)
+        for (unsigned k = 0; k < DIM; ++k)
+          builder._centers[DIM * i + k] =
+              0.5f * (boxes[i].lo[k] + boxes[i].hi[k]);
+    });
+    nodes.reserve(2 * n - 1);
+    builder.build_node(0, n, n_threads, nodes);
+    std::vector<Box> sorted(n);
+    for (unsigned k = 0; k < n; ++k) sorted[k] = boxes[order[k]];
+    boxes.swap(sorted);
+  }
+
+  /* update the node boxes from the primitive boxes in leaf order, children
+   * follow their parent so they are updated first */
+  static void refit(const std::vector<Box>& boxes, std::vector<Node>& nodes) {
+    for (size_t i = nodes.size(); i-- > 0;) {
+      Node& node = nodes[i];
+      node.box = Box::empty();
+      if (node.count == 0) {
+        node.box.merge(nodes[i + 1].box);
+        node.box.merge(nodes[node.index].box);
+      } else {
+        for (unsigned k = node.index; k < node.index + node.count; ++k)
+          node.box.merge(boxes[k]);
+      }
+    }
+  }
+
+ private:
+  static constexpr unsigned kBins = 16;
+  static constexpr unsigned kMaxLeafSize = 4;
+  /* primitives worth a thread for a subtree */
+  static constexpr unsigned kParallelGrain = 1 << 12;
+
+  BVHBuilder(const std::vector<Box>& boxes, std::vector<unsigned>& order)
+      : _boxes(boxes), _order(order), _centers(DIM * boxes.size()) {}
+
+  const float* center(unsigned i) const { return &_centers[DIM * i]; }
+
+  /* build the subtree of the primitives _order[begin, end) at the back of
+   * nodes, an inner node stores its second child relative to nodes */
+  void build_node(unsigned begin, unsigned end, unsigned n_threads,
+                  std::vector<Node>& nodes) {
+    unsigned id = nodes.size();
+    nodes.emplace_back();
+    Box box = Box::empty(), centers = Box::empty();
+    for (unsigned k = begin; k < end; ++k) {
+      box.merge(_boxes[_order[k]]);
+      centers.merge(center(_order[k]));
+    }
+    nodes[id].box = box;
+    nodes[id].count = end - begin;
+    nodes[id].index = begin;
+    if (end - begin <= 1) return;
+
+    unsigned axis = 0;
+    for (unsigned k = 1; k < DIM; ++k)
+      if (centers.hi[k] - centers.lo[k] > centers.hi[axis] - centers.lo[axis])
+        axis = k;
+    float lo = centers.lo[axis], scale = kBins / (centers.hi[axis] - lo);
+    unsigned mid;
+    if (!std::isfinite(scale)) {
+      // equal centers, split in the middle if the leaf is too large
+      if (end - begin <= kMaxLeafSize) return;
+      mid = begin + (end - begin) / 2;
+    } else {
+      auto bin_of = [&](unsigned i) {
+        float b = (center(i)[axis] - lo) * scale;
+        return std::min(static_cast<unsigned>(b), kBins - 1);
+      };
+      Box bin_boxes[kBins];
+      unsigned bin_counts[kBins] = {};
+      std::fill(bin_boxes, bin_boxes + kBins, Box::empty());
+      for (unsigned k = begin; k < end; ++k) {
+        unsigned b = bin_of(_order[k]);
+        bin_boxes[b].merge(_boxes[_order[k]]);
+        ++bin_counts[b];
+      }
+      float right_costs[kBins];
+      Box acc = Box::empty();
+      unsigned count = 0;
+      for (unsigned b = kBins - 1; b > 0; --b) {
+        acc.merge(bin_boxes[b]);
+        count += bin_counts[b];
+        right_costs[b] = acc.area() * count;
+      }
+      acc = Box::empty();
+      count = 0;
+      unsigned best_split = 1;
+      float best_cost = std::numeric_limits<float>::infinity();
+      for (unsigned b = 1; b < kBins; ++b) {
+        acc.merge(bin_boxes[b - 1]);
+        count += bin_counts[b - 1];
+        float cost = acc.area() * count + right_costs[b];
+        if (cost < best_cost) {
+          best_cost = cost;
+          best_split = b;
+        }
+      }
+      // a traversal step costs about half of a primitive test
+      float leaf_cost = box.area() * (end - begin);
+      if (end - begin <= kMaxLeafSize &&
+          leaf_cost <= 0.5f * box.area() + best_cost)
+        return;
+      mid = std::partition(_order.begin() + begin, _order.begin() + end,
+                           [&](unsigned i) { return bin_of(i) < best_split; }) -
+            _order.begin();
+    }
+
+    nodes[id].count = 0;
+    if (n_threads > 1 && end - begin >= kParallelGrain) {
+      std::vector<Node> second;
+      std::thread thread([&] { build_node(mid, end, n_threads / 2, second); });
+      build_node(begin, mid, n_threads - n_threads / 2, nodes);
+      thread.join();
+      std::uint32_t base = nodes.size();
+      for (Node node : second) {
+        if (node.count == 0) node.index += base;
+        nodes.push_back(node);
+      }
+      nodes[id].index = base;
+    } else {
+      build_node(begin, mid, 1, nodes);
+      nodes[id].index = nodes.size();
+      build_node(mid, end, 1, nodes);
+    }
+  }
+
+ private:
+  const std::vector<Box>& _boxes;
+  std::vector<unsigned>& _order;
+  std::vector<float> _centers;
+};
+
+}  // namespace internal
+
+}  // namespace algorithm
+}  // namespace CMTL
+
+#endif  // __algorithm_bvh_builder__
@@ -0,0 +1,260 @@
+#ifndef __algorithm_hash_grid__
+#define __algorithm_hash_grid__
+
+#include "../../common/numeric_utils.h"
+#include "../../common/parallel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace CMTL {
+namespace algorithm {
+
+/**
+ * @brief uniform grid of 2d or 3d points hashed by cell, for the points
+ * within a fixed distance epsilon of each other, such as the near duplicates
+ * given by numeric_comparator<T>::tolerance()
+ * @tparam Point geo2d::Point<T> or geo3d::Point<T>
+ * @note the cells are at least epsilon wide, so the points within epsilon of
+ * a point are in its cell or in the adjacent ones. The cells are stored in an
+ * open addressing table keyed by the packed integer cell coordinates, the
+ * queries take an expected time linear in the number of points visited
+ */
+template <typename Point>
+class HashGrid {
+ public:
+  typedef typename Point::FT T;
+
+ public:
+  HashGrid() = default;
+
+  /**
+   * @brief build the grid of a point set, use points() of a PolygonSoup or of
+   * a SurfaceMesh for their vertices
+   * @param epsilon distance of the queries, 0 for equal points
+   * @param n_threads number of threads, 0 for default
+   */
+  HashGrid(const std::vector<Point>& points, const T& epsilon,
+           unsigned n_threads = 0) {
+    build(points, epsilon, n_threads);
+  }
+
+ public:
+  /**
+   * @brief rebuild the grid of a point set
+   * @param epsilon distance of the queries, 0 for equal points
+   * @param n_threads number of threads, 0 for default
+   */
+  void build(const std::vector<Point>& points, const T& epsilon,
+             unsigned n_threads = 0) {
+    unsigned n = points.size();
+    if (n_threads == 0) n_threads = default_threads(n, 1 << 14);
+    _squared_epsilon = epsilon * epsilon;
+    _points.clear();
+    _indices.clear();
+    _offsets.assign(1, 0);
+    _cell_keys.clear();
+    _slots.clear();
+    if (n == 0) return;
+
+    // cells of at least epsilon, and small enough against the extent for the
+    // cell coordinates to be rounded by less than a cell fraction
+    _origin = points[0];
+    Point hi = points[0];
+    for (const Point& p : points) {
+      for (unsigned k = 0; k < kDim; ++k) {
+        if (p[k] < _origin[k]) _origin[k] = p[k];
+        if (hi[k] < p[k]) hi[k] = p[k];
+      }
+    }
+    double extent = 0;
+    for (unsigned k = 0; k < kDim; ++k)
+      extent = std::max(extent, to_double(T(hi[k] - _origin[k])));
+    double cell = std::max(to_double(epsilon), std::ldexp(extent, -40));
+    _inv_cell = cell > 0 ? 1 / (cell * (1 + 1.0 / 256)) : 1;
+
+    std::vector<std::uint64_t> keys(n);
+    parallel_for(n, n_threads, [&](size_t begin, size_t end) {
+      for (size_t i = begin; i < end; ++i) keys[i] = key_of(points[i]);
+    });
+
+    // the cells are numbered by their first point
+    unsigned capacity = 16;
+    while (capacity < 2 * n) capacity *= 2;
+    _slots.assign(capacity, Slot{0, kEmpty});
+    std::vector<unsigned> cells(n), counts;
+    for (unsigned i = 0; i < n; ++i) {
+      Slot& slot = _slots[find_slot(keys[i])];
+      if (slot.cell == kEmpty) {
+        slot = Slot{keys[i], unsigned(counts.size())};
+        _cell_keys.push_back(keys[i]);
+        counts.push_back(0);
+      }
+      cells[i] = slot.cell;
+      ++counts[cells[i]];
+    }
+    _offsets.resize(counts.size() + 1);
+    for (unsigned c = 0; c < counts.size(); ++c)
+      _offsets[c + 1] = _offsets[c] + counts[c];
+    _indices.resize(n);
+    counts.assign(_offsets.begin(), _offsets.end() - 1);
+    for (unsigned i = 0; i < n; ++i) _indices[counts[cells[i]]++] = i;
+    _points.resize(n);
+    parallel_for(n, n_threads, [&](size_t begin, size_t end) {
+      for (size_t i = begin; i < end; ++i) _points[i] = points[_indices[i]];
+    });
+  }
+
+  /** @brief number of points */
+  size_t size() const { return _points.size(); }
+
+  /** @brief number of non-empty cells */
+  size_t n_cells() const { return _cell_keys.size(); }
+
+  /**
+   * @brief find the points within epsilon of a point
+   * @param result indices of the points, in increasing order
+   */
+  void neighbors(const Point& p, std::vector<unsigned>& result) const {
+    result.clear();
+    if (_points.empty()) return;
+    std::uint64_t key = key_of(p);
+    for (unsigned d = 0; d < kStencil; ++d) {
+      unsigned cell = find_cell(shift(key, d));
+      if (cell == kEmpty) continue;
+      for (unsigned k = _offsets[cell]; k < _offsets[cell + 1]; ++k)
+        if (!(_squared_epsilon < squared_distance(p, _points[k])))
+          result.push_back(_indices[k]);
+    }
+    std::sort(result.begin(), result.end());
+  }
+
+  /**
+   * @brief find all pairs of points within epsilon of each other
+   * @param pairs each pair once, as (i, j) with i < j, in an order which does
+   * not depend on the number of threads
+   * @param n_threads number of threads, 0 for default
+   */
+  void close_pairs(std::vector<std::pair<unsigned, unsigned>>& pairs,
+                   unsigned n_threads = 0) const {
+    pairs.clear();
+    size_t n = n_cells();
+    if (n_threads == 0) n_threads = default_threads(_points.size(), 1 << 14);
+    n_threads = std::max<size_t>(std::min<size_t>(n_threads, n), 1);
+    if (n_threads == 1) {
+      for (unsigned c = 0; c < n; ++c) cell_pairs(c, pairs);
+      return;
+    }
+    // one list per range of cells, concatenated in the order of the cells
+    std::vector<std::vector<std::pair<unsigned, unsigned>>> found(n_threads);
+    parallel_for(n_threads, n_threads, [&](size_t first, size_t last) {
+      for (size_t t = first; t < last; ++t)
+        for (size_t c = n * t / n_threads; c < n * (t + 1) / n_threads; ++c)
+          cell_pairs(c, found[t]);
+    });
+    size_t n_pairs = 0;
+    for (const auto& local : found) n_pairs += local.size();
+    pairs.reserve(n_pairs);
+    for (const auto& local : found)
+      pairs.insert(pairs.end(), local.begin(), local.end());
+  }
+
+ private:
+  static constexpr unsigned kDim = Point::dimension();
+  /* bits of each packed cell coordinate, the coordinates wrap around which
+   * only merges far away cells */
+  static constexpr unsigned kBits = 64 / kDim;
+  static constexpr std::uint64_t kMask = (std::uint64_t(1) << kBits) - 1;
+  /* the cell and its adjacent ones */
+  static constexpr unsigned kStencil = kDim == 2 ? 9 : 27;
+  static constexpr unsigned kEmpty = ~0u;
+
+  struct Slot {
+    std::uint64_t key;
+    unsigned cell;
+  };
+
+  std::uint64_t key_of(const Point& p) const {
+    std::uint64_t key = 0;
+    for (unsigned k = 0; k < kDim; ++k) {
+      double c = std::floor(to_double(T(p[k] - _origin[k])) * _inv_cell);
+      c = std::min(std::max(c, -0x1p62), 0x1p62);
+      key |= (std::uint64_t(std::int64_t(c)) & kMask) << (kBits * k);
+    }
+    return key;
+  }
+
+  /* key of an adjacent cell, offset d in base 3 with digit 1 for no move,
+   * d = kStencil / 2 is the cell itself */
+  static std::uint64_t shift(std::uint64_t key, unsigned d) {
+    std::uint64_t result = 0;
+    for (unsigned k = 0; k < kDim; ++k, d /= 3) {
+      std::uint64_t c = (key >> (kBits * k)) + std::uint64_t(d % 3) - 1;
+      result |= (c & kMask) << (kBits * k);
+    }
+    return result;
+  }
+
+  /* slot of a key, or the empty slot where it should be */
+  unsigned find_slot(std::uint64_t key) const {
+    unsigned mask = _slots.size() - 1;
+    unsigned slot = (key * 0x9E3779B97F4A7C15ull) >> 32 & mask;
+    while (_slots[slot].cell != kEmpty && _slots[slot].key != key)
+      slot = (slot + 1) & mask;
+    return slot;
+  }
+
+  unsigned find_cell(std::uint64_t key) const {
+    return _slots[find_slot(key)].cell;
+  }
+
+  static T squared_distance(const Point& p, const Point& q) {
+    T result(0);
+    for (unsigned k = 0; k < kDim; ++k) result += (p[k] - q[k]) * (p[k] - q[k]);
+    return result;
+  }
+
+  /* pairs of a cell with itself and with the adjacent cells after it in the
+   * stencil order, so that each pair of cells is visited once */
+  void cell_pairs(unsigned cell,
+                  std::vector<std::pair<unsigned, unsigned>>& pairs) const {
+    unsigned begin = _offsets[cell], end = _offsets[cell + 1];
+    for (unsigned d = kStencil / 2; d < kStencil; ++d) {
+      unsigned other = cell;
+      if (d != kStencil / 2) other = find_cell(shift(_cell_keys[cell], d));
+      if (other == kEmpty) continue;
+      for (unsigned a = begin; a < end; ++a) {
+        unsigned b = other == cell ? a + 1 : _offsets[other];
+        for (; b < _offsets[other + 1]; ++b) {
+          if (_squared_epsilon < squared_distance(_points[a], _points[b]))
+            continue;
+          pairs.emplace_back(std::min(_indices[a], _indices[b]),
+                             std::max(_indices[a], _indices[b]));
+        }
+      }
+    }
+  }
+
+ private:
+  T _squared_epsilon;
+  /* corner of the grid and inverse cell width */
+  Point _origin;
+  double _inv_cell = 1;
+  /* points grouped by cell, cell c holds [_offsets[c], _offsets[c + 1]) */
+  std::vector<Point> _points;
+  /* input index of the points */
+  std::vector<unsigned> _indices;
+  std::vector<unsigned> _offsets = std::vector<unsigned>(1, 0);
+  /* packed coordinates of the cells */
+  std::vector<std::uint64_t> _cell_keys;
+  /* open addressing table from packed coordinates to cell */
+  std::vector<Slot> _slots;
+};
+
+}  // namespace algorithm
+}  // namespace CMTL
+
+#endif  // __algorithm_hash_grid__
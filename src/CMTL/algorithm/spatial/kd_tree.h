@@ -0,0 +1,323 @@
+#ifndef __algorithm_kd_tree__
+#define __algorithm_kd_tree__
+
+#include "../../common/parallel.h"
+
+#include <algorithm>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+namespace CMTL {
+namespace algorithm {
+
+namespace internal {
+
+/* max-heap of at most capacity (distance, index) pairs on arrays provided by
+ * the caller, keeps the smallest pairs pushed, ties broken by index */
+template <typename T>
+class BoundedMaxHeap {
+ public:
+  BoundedMaxHeap(unsigned* indices, T* distances, unsigned capacity)
+      : _indices(indices), _distances(distances), _capacity(capacity) {}
+
+ public:
+  unsigned size() const { return _size; }
+
+  bool full() const { return _size == _capacity; }
+
+  /* largest distance, only valid if full */
+  const T& top() const { return _distances[0]; }
+
+  void push(const T& distance, unsigned index) {
+    if (_capacity == 0) return;
+    if (!full()) {
+      // sift up
+      unsigned i = _size++;
+      while (i > 0 && less(_distances[(i - 1) / 2], _indices[(i - 1) / 2],
+                           distance, index)) {
+        move(i, (i - 1) / 2);
+        i = (i - 1) / 2;
+      }
+      _distances[i] = distance;
+      _indices[i] = index;
+      return;
+    }
+    if (!less(distance, index, _distances[0], _indices[0])) return;
+    sift_down(0, _size, distance, index);
+  }
+
+  /* sort the pairs by increasing distance, the heap is then invalid */
+  void sort() {
+    for (unsigned n = _size; n > 1; --n) {
+      T distance = _distances[n - 1];
+      unsigned index = _indices[n - 1];
+      _distances[n - 1] = _distances[0];
+      _indices[n - 1] = _indices[0];
+      sift_down(0, n - 1, distance, index);
+    }
+  }
+
+ private:
+  static bool less(const T& d0, unsigned i0, const T& d1, unsigned i1) {
+    return d0 < d1 || (d0 == d1 && i0 < i1);
+  }
+
+  void move(unsigned to, unsigned from) {
+    _distances[to] = _distances[from];
+    _indices[to] = _indices[from];
+  }
+
+  /* put a pair at position i of the heap [0, n) and sift it down */
+  void sift_down(unsigned i, unsigned n, const T& distance, unsigned index) {
+    while (2 * i + 1 < n) {
+      unsigned child = 2 * i + 1;
+      if (child + 1 < n && less(_distances[child], _indices[child],
+                                _distances[child + 1], _indices[child + 1]))
+        ++child;
+      if (!less(distance, index, _distances[child], _indices[child])) break;
+      move(i, child);
+      i = child;
+    }
+    _distances[i] = distance;
+    _indices[i] = index;
+  }
+
+ private:
+  unsigned* _indices;
+  T* _distances;
+  unsigned _capacity;
+  unsigned _size = 0;
+};
+
+}  // namespace internal
+
+/**
+ * @brief static k-d tree of 2d or 3d points for nearest neighbour and radius
+ * queries, the tree is implicit: the points are reordered so that the median
+ * of each range along its split axis is at the middle of the range
+ * @tparam Point geo2d::Point<T> or geo3d::Point<T>
+ * @note the points are copied, the distances are exact for exact number types
+ * such as mpq_class
+ */
+template <typename Point>
+class KDTree {
+ public:
+  typedef typename Point::FT T;
+
+ public:
+  KDTree() = default;
+
+  /**
+   * @brief build the tree of a point set
+   * @param n_threads number of threads, 0 for default
+   */
+  KDTree(const std::vector<Point>& points, unsigned n_threads = 0) {
+    build(points, n_threads);
+  }
+
+ public:
+  /**
+   * @brief rebuild the tree of a point set
+   * @param n_threads number of threads, 0 for default
+   */
+  void build(const std::vector<Point>& points, unsigned n_threads = 0) {
+    unsigned n = points.size();
+    if (n_threads == 0) n_threads = default_threads(n, 1 << 14);
+    _indices.resize(n);
+    std::iota(_indices.begin(), _indices.end(), 0u);
+    _axes.assign(n, 0);
+    build_range(points, 0, n, n_threads);
+    _points.resize(n);
+    parallel_for(n, n_threads, [&](size_t begin, size_t end) {
+      for (size_t i = begin; i < end; ++i) _points[i] = points[_indices[i]];
+    });
+  }
+
+  /** @brief number of points */
+  size_t size() const { return _points.size(); }
+
+  /**
+   * @brief find the nearest point
+   * @param index index of the nearest point, the smallest one if several
+   * @param squared_distance its squared distance, ignored if null
+   * @return false if the tree is empty
+   */
+  bool nearest(const Point& p, unsigned& index,
+               T* squared_distance = nullptr) const {
+    T distance;
+    if (knn(p, 1, &index, &distance) == 0) return false;
+    if (squared_distance) *squared_distance = distance;
+    return true;
+  }
+
+  /**
+   * @brief find the k nearest points without heap allocation
+   * @param indices at least k entries, get the indices of the points by
+   * increasing distance, ties broken by index
+   * @param squared_distances at least k entries, get their squared distances
+   * @return number of points found, min(k, size())
+   */
+  unsigned knn(const Point& p, unsigned k, unsigned* indices,
+               T* squared_distances) const {
+    internal::BoundedMaxHeap<T> heap(indices, squared_distances, k);
+    if (!_points.empty()) search_knn(p, 0, _points.size(), heap);
+    heap.sort();
+    return heap.size();
+  }
+
+  /**
+   * @brief find the k nearest points
+   * @param indices indices of the points by increasing distance
+   */
+  void knn(const Point& p, unsigned k, std::vector<unsigned>& indices) const {
+    k = std::min<size_t>(k, size());
+    indices.resize(k);
+    std::vector<T> distances(k);
+    knn(p, k, indices.data(), distances.data());
+  }
+
+  /**
+   * @brief find the k nearest points of many points in parallel
+   * @param indices k entries per query, the indices of the points by
+   * increasing distance, size() if less than k points
+   * @param squared_distances k entries per query, their squared distances,
+   * ignored if null
+   * @param n_threads number of threads, 0 for default
+   */
+  void knn(const std::vector<Point>& queries, unsigned k,
+           std::vector<unsigned>& indices,
+           std::vector<T>* squared_distances = nullptr,
+           unsigned n_threads = 0) const {
+    size_t n = queries.size();
+    indices.assign(n * k, size());
+    std::vector<T> local;
+    std::vector<T>& distances = squared_distances ? *squared_distances : local;
+    distances.assign(n * k, T(0));
+    if (n_threads == 0) n_threads = default_threads(n, 1 << 10);
+    parallel_for(n, n_threads, [&](size_t begin, size_t end) {
+      for (size_t i = begin; i < end; ++i)
+        knn(queries[i], k, &indices[i * k], &distances[i * k]);
+    });
+  }
+
+  /**
+   * @brief find the points within a distance
+   * @param r distance, the points at distance r are included
+   * @param result indices of the points, in increasing order
+   */
+  void radius(const Point& p, const T& r,
+              std::vector<unsigned>& result) const {
+    result.clear();
+    if (!_points.empty())
+      search_radius(p, T(r * r), 0, _points.size(), result);
+    std::sort(result.begin(), result.end());
+  }
+
+  /**
+   * @brief find the points within a distance of many points in parallel
+   * @param r distance, the points at distance r are included
+   * @param results indices of the points of each query, in increasing order
+   * @param n_threads number of threads, 0 for default
+   */
+  void radius(const std::vector<Point>& queries, const T& r,
+              std::vector<std::vector<unsigned>>& results,
+              unsigned n_threads = 0) const {
+    size_t n = queries.size();
+    results.resize(n);
+    if (n_threads == 0) n_threads = default_threads(n, 1 << 10);
+    parallel_for(n, n_threads, [&](size_t begin, size_t end) {
+      for (size_t i = begin; i < end; ++i)
+        radius(queries[i], r, results[i]);
+    });
+  }
+
+ private:
+  static constexpr unsigned kDim = Point::dimension();
+  /* points worth a thread for a subtree */
+  static constexpr unsigned kParallelGrain = 1 << 14;
+
+  /* put the median of _indices[begin, end) along the axis of largest extent
+   * at the middle, then build both sides */
+  void build_range(const std::vector<Point>& points, unsigned begin,
+                   unsigned end, unsigned n_threads) {
+    if (end - begin <= 1) return;
+    Point lo = points[_indices[begin]], hi = lo;
+    for (unsigned i = begin + 1; i < end; ++i) {
+      const Point& p = points[_indices[i]];
+      for (unsigned k = 0; k < kDim; ++k) {
+        if (p[k] < lo[k]) lo[k] = p[k];
+        if (hi[k] < p[k]) hi[k] = p[k];
+      }
+    }
+    unsigned axis = (hi - lo).max();
+    unsigned mid = begin + (end - begin) / 2;
+    std::nth_element(_indices.begin() + begin, _indices.begin() + mid,
+                     _indices.begin() + end, [&](unsigned i, unsigned j) {
+                       return points[i][axis] < points[j][axis];
+                     });
+    _axes[mid] = axis;
+    if (n_threads > 1 && end - begin >= kParallelGrain) {
+      std::thread thread([&] {
+        build_range(points, mid + 1, end, n_threads / 2);
+      });
+      build_range(points, begin, mid, n_threads - n_threads / 2);
+      thread.join();
+    } else {
+      build_range(points, begin, mid, 1);
+      build_range(points, mid + 1, end, 1);
+    }
+  }
+
+  static T squared_distance(const Point& p, const Point& q) {
+    T result(0);
+    for (unsigned k = 0; k < kDim; ++k) result += (p[k] - q[k]) * (p[k] - q[k]);
+    return result;
+  }
+
+  void search_knn(const Point& p, unsigned begin, unsigned end,
+                  internal::BoundedMaxHeap<T>& heap) const {
+    unsigned mid = begin + (end - begin) / 2;
+    const Point& q = _points[mid];
+    heap.push(squared_distance(p, q), _indices[mid]);
+    if (end - begin == 1) return;
+    unsigned axis = _axes[mid];
+    T diff = p[axis] - q[axis];
+    // the side of p first, the other one if it may be closer than the worst
+    bool left = diff < 0;
+    if (left ? begin < mid : mid + 1 < end)
+      search_knn(p, left ? begin : mid + 1, left ? mid : end, heap);
+    if ((left ? mid + 1 < end : begin < mid) &&
+        (!heap.full() || !(heap.top() < diff * diff)))
+      search_knn(p, left ? mid + 1 : begin, left ? end : mid, heap);
+  }
+
+  void search_radius(const Point& p, const T& squared_radius, unsigned begin,
+                     unsigned end, std::vector<unsigned>& result) const {
+    unsigned mid = begin + (end - begin) / 2;
+    const Point& q = _points[mid];
+    if (!(squared_radius < squared_distance(p, q)))
+      result.push_back(_indices[mid]);
+    if (end - begin == 1) return;
+    unsigned axis = _axes[mid];
+    T diff = p[axis] - q[axis];
+    bool near = !(squared_radius < diff * diff);
+    if (begin < mid && (diff < 0 || near))
+      search_radius(p, squared_radius, begin, mid, result);
+    if (mid + 1 < end && (!(diff < 0) || near))
+      search_radius(p, squared_radius, mid + 1, end, result);
+  }
+
+ private:
+  /* points in tree order */
+  std::vector<Point> _points;
+  /* input index of the points in tree order */
+  std::vector<unsigned> _indices;
+  /* split axis of the range whose middle is the point */
+  std::vector<unsigned char> _axes;
+};
+
+}  // namespace algorithm
+}  // namespace CMTL
+
+#endif  // __algorithm_kd_tree__
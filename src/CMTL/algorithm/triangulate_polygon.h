@@ -1,11 +1,21 @@
 #ifndef __algorithm_triangulate_polygon__
 #define __algorithm_triangulate_polygon__
 
+#include "../common/numeric_utils.h"
+#include "../common/z_order.h"
 #include "../geo2d/polygon.h"
+#include "../geo2d/polygon_with_holes.h"
+#include "../geo2d/pslg.h"
 #include "../geo3d/polygon.h"
 #include "predicate.h"
+#include "triangulation.h"
 
+#include <algorithm>
 #include <array>
+#include <cstdint>
+#include <numeric>
+#include <set>
+#include <type_traits>
 #include <vector>
 
 namespace CMTL {
@@ -48,6 +58,7 @@ class triangulate_polygon_modifier_2d {
     }
     unsigned begin_id = 0;
     unsigned iter_times = 0;
+    triangles.clear();
     triangles.reserve(n_points - 2);
     while (_vertex_list[_vertex_list[begin_id].next_id].next_id !=
            _vertex_list[begin_id].prev_id) {
@@ -114,8 +125,512 @@ class triangulate_polygon_modifier_2d {
   std::vector<vertex> _vertex_list;
 };
 
+/* ear clipping where an ear is only checked against the non-convex vertices
+ * in its bounding box: the vertices are put in the cells of a 65536 x 65536
+ * grid, and the non-convex ones are sorted by the z-order of their cell, in
+ * which the cells of a box lie between the codes of its corners */
+template <typename Polygon>
+class z_order_ear_clipping_2d {
+ public:
+  z_order_ear_clipping_2d(const Polygon& polygon) : _polygon(polygon) {}
+
+ private:
+  typedef typename std::decay<decltype(std::declval<Polygon>()[0])>::type
+      Point;
+
+  struct vertex {
+    unsigned prev_id, next_id;
+    std::uint32_t cell[2];
+    bool is_convex;
+  };
+
+  /* non-convex vertex in z-order */
+  struct blocker {
+    std::uint32_t code;
+    unsigned id;
+  };
+
+ public:
+  bool execute(std::vector<std::array<unsigned, 3>>& triangles) {
+    unsigned n_points = _polygon.size();
+    if (n_points < 3) return false;
+    if (n_points == 3) {
+      triangles = std::vector<std::array<unsigned, 3>>{
+          std::array<unsigned, 3>{0, 1, 2}};
+      return true;
+    }
+    // the cells only need to be monotonic in the coordinates
+    double lo[2], hi[2];
+    for (unsigned k = 0; k < 2; ++k) lo[k] = hi[k] = to_double(_polygon[0][k]);
+    for (unsigned i = 1; i < n_points; ++i) {
+      for (unsigned k = 0; k < 2; ++k) {
+        lo[k] = std::min(lo[k], to_double(_polygon[i][k]));
+        hi[k] = std::max(hi[k], to_double(_polygon[i][k]));
+      }
+    }
+    double extent = std::max(hi[0] - lo[0], hi[1] - lo[1]);
+    double scale = extent > 0 ? 65535 / extent : 0;
+    _vertex_list.resize(n_points);
+    _blockers.clear();
+    for (unsigned i = 0; i < n_points; ++i) {
+      vertex& v = _vertex_list[i];
+      v.prev_id = i == 0 ? n_points - 1 : i - 1;
+      v.next_id = i + 1 == n_points ? 0 : i + 1;
+      for (unsigned k = 0; k < 2; ++k) {
+        double c = (to_double(_polygon[i][k]) - lo[k]) * scale;
+        v.cell[k] = std::min(static_cast<std::uint32_t>(c), 65535u);
+      }
+      v.is_convex = orient_2d(_polygon[v.prev_id], _polygon[i],
+                              _polygon[v.next_id]) == ORIENTATION::POSITIVE;
+      if (!v.is_convex)
+        _blockers.push_back(blocker{z_order_2d(v.cell[0], v.cell[1]), i});
+    }
+    std::sort(_blockers.begin(), _blockers.end(),
+              [](const blocker& b0, const blocker& b1) {
+                return b0.code < b1.code ||
+                       (b0.code == b1.code && b0.id < b1.id);
+              });
+    _position.assign(n_points, ~0u);
+    for (unsigned k = 0; k < _blockers.size(); ++k)
+      _position[_blockers[k].id] = k;
+    _skip.resize(_blockers.size() + 1);
+    std::iota(_skip.begin(), _skip.end(), 0u);
+
+    triangles.clear();
+    triangles.reserve(n_points - 2);
+    unsigned ear = 0, remaining = n_points, iter_times = 0;
+    while (remaining > 3) {
+      const vertex& v = _vertex_list[ear];
+      if (!v.is_convex || !is_ear(ear)) {
+        ear = v.next_id;
+        if (++iter_times > remaining) return false;
+        continue;
+      }
+      unsigned prev_id = v.prev_id, next_id = v.next_id;
+      triangles.push_back(std::array<unsigned, 3>{prev_id, ear, next_id});
+      _vertex_list[prev_id].next_id = next_id;
+      _vertex_list[next_id].prev_id = prev_id;
+      re_configure(prev_id);
+      re_configure(next_id);
+      --remaining;
+      iter_times = 0;
+      // skipping the next vertex avoids fans of slivers
+      ear = _vertex_list[next_id].next_id;
+    }
+    const vertex& v = _vertex_list[ear];
+    triangles.push_back(std::array<unsigned, 3>{v.prev_id, ear, v.next_id});
+    return true;
+  }
+
+ private:
+  /* clipping a neighbour only makes a vertex more convex, a vertex becoming
+   * convex is no longer a blocker */
+  void re_configure(unsigned id) {
+    vertex& v = _vertex_list[id];
+    if (v.is_convex) return;
+    v.is_convex = orient_2d(_polygon[v.prev_id], _polygon[id],
+                            _polygon[v.next_id]) == ORIENTATION::POSITIVE;
+    if (v.is_convex) _skip[_position[id]] = _position[id] + 1;
+  }
+
+  /* vertices out of the box scanned before jumping */
+  static constexpr unsigned kMaxMisses = 16;
+
+  /* first blocker from a position on, with path halving */
+  unsigned find_blocker(unsigned k) {
+    while (_skip[k] != k) {
+      _skip[k] = _skip[_skip[k]];
+      k = _skip[k];
+    }
+    return k;
+  }
+
+  /* the ear may only contain the vertices at the ends of its diagonal, which
+   * happens when holes are bridged */
+  bool is_ear(unsigned id) {
+    const vertex& v = _vertex_list[id];
+    const vertex &a = _vertex_list[v.prev_id], &c = _vertex_list[v.next_id];
+    std::uint32_t lo[2], hi[2];
+    for (unsigned k = 0; k < 2; ++k) {
+      lo[k] = std::min({a.cell[k], v.cell[k], c.cell[k]});
+      hi[k] = std::max({a.cell[k], v.cell[k], c.cell[k]});
+    }
+    std::uint32_t lo_code = z_order_2d(lo[0], lo[1]);
+    std::uint32_t hi_code = z_order_2d(hi[0], hi[1]);
+    const Point &pa = _polygon[v.prev_id], &pb = _polygon[id],
+                &pc = _polygon[v.next_id];
+    unsigned k = std::lower_bound(_blockers.begin(), _blockers.end(), lo_code,
+                                  [](const blocker& b, std::uint32_t code) {
+                                    return b.code < code;
+                                  }) -
+                 _blockers.begin();
+    unsigned n_misses = 0;
+    for (k = find_blocker(k); k < _blockers.size() &&
+                              _blockers[k].code <= hi_code;
+         k = find_blocker(k + 1)) {
+      unsigned p_id = _blockers[k].id;
+      const vertex& p = _vertex_list[p_id];
+      if (p.cell[0] < lo[0] || p.cell[0] > hi[0] || p.cell[1] < lo[1] ||
+          p.cell[1] > hi[1]) {
+        // after a run of vertices out of the box, jump to the next code in it
+        if (++n_misses < kMaxMisses) continue;
+        n_misses = 0;
+        std::uint32_t next = z_order_2d_next(_blockers[k].code, lo_code,
+                                             hi_code);
+        if (next <= _blockers[k].code) break;
+        k = std::lower_bound(_blockers.begin() + k, _blockers.end(), next,
+                             [](const blocker& b, std::uint32_t code) {
+                               return b.code < code;
+                             }) -
+            _blockers.begin() - 1;
+        continue;
+      }
+      n_misses = 0;
+      if (p_id == v.prev_id || p_id == v.next_id) continue;
+      const Point& pp = _polygon[p_id];
+      if (pp == pa || pp == pc) continue;
+      if (in_triangle(pa, pb, pc, pp) != ORIENTATION::OUTSIDE) return false;
+    }
+    return true;
+  }
+
+ private:
+  const Polygon& _polygon;
+  std::vector<vertex> _vertex_list;
+  std::vector<blocker> _blockers;
+  /* position of the non-convex vertices in _blockers */
+  std::vector<unsigned> _position;
+  /* next blocker position which may still be non-convex, itself if so */
+  std::vector<unsigned> _skip;
+};
+
+/* sweep line partition into y-monotone pieces (de Berg et al., chapter 3),
+ * each piece being triangulated with a stack in linear time. The vertices
+ * are swept by decreasing y then increasing x, the status holds the edges
+ * which have the interior on their right, ordered from left to right */
+template <typename Polygon>
+class monotone_partition_2d {
+ public:
+  monotone_partition_2d(const Polygon& polygon) : _polygon(polygon) {}
+
+ private:
+  typedef typename std::decay<decltype(std::declval<Polygon>()[0])>::type
+      Point;
+  typedef typename Point::FT T;
+
+  enum vertex_type { START, END, SPLIT, MERGE, REGULAR };
+
+  /* edge i goes from vertex i down to vertex i + 1, n stands for the query
+   * point. Two edges in the status both cross the sweep line, the one whose
+   * upper end is swept later is compared with the line of the other */
+  struct edge_less {
+    const monotone_partition_2d* self;
+    bool operator()(unsigned e0, unsigned e1) const {
+      if (e0 == e1) return false;
+      unsigned n = self->_polygon.size();
+      if (e1 == n) return !self->left_of(self->_query, e0, true);
+      if (e0 == n) return self->left_of(self->_query, e1, true);
+      if (self->above(self->_polygon[e1], self->_polygon[e0]))
+        return self->left_of(self->_polygon[e0], e1, true);
+      return !self->left_of(self->_polygon[e1], e0, true);
+    }
+  };
+
+ public:
+  bool execute(std::vector<std::array<unsigned, 3>>& triangles) {
+    triangles.clear();
+    unsigned n_points = _polygon.size();
+    if (n_points < 3) return false;
+    T area(0);
+    for (unsigned i = 0, j = n_points - 1; i < n_points; j = i++)
+      area += _polygon[j] % _polygon[i];
+    if (!(area > T(0))) return false;
+    triangles.reserve(n_points - 2);
+
+    std::vector<std::pair<unsigned, unsigned>> diagonals;
+    if (!partition(diagonals)) return false;
+    std::vector<std::vector<unsigned>> pieces;
+    split(diagonals, pieces);
+    for (const std::vector<unsigned>& piece : pieces)
+      triangulate_monotone(piece, triangles);
+    return triangles.size() == n_points - 2;
+  }
+
+ private:
+  unsigned next(unsigned i) const {
+    return i + 1 == _polygon.size() ? 0 : i + 1;
+  }
+
+  unsigned prev(unsigned i) const {
+    return i == 0 ? _polygon.size() - 1 : i - 1;
+  }
+
+  /* p is swept before q */
+  static bool above(const Point& p, const Point& q) {
+    return q[1] < p[1] || (p[1] == q[1] && p[0] < q[0]);
+  }
+
+  /* p is strictly left of the line of edge e, or on it if or_on */
+  bool left_of(const Point& p, unsigned e, bool or_on) const {
+    ORIENTATION ori = orient_2d(_polygon[next(e)], _polygon[e], p);
+    return ori == ORIENTATION::POSITIVE || (or_on && ori == ORIENTATION::ON);
+  }
+
+  vertex_type type_of(unsigned i) const {
+    const Point& p = _polygon[prev(i)];
+    const Point& v = _polygon[i];
+    const Point& q = _polygon[next(i)];
+    bool reflex = orient_2d(p, v, q) == ORIENTATION::NEGATIVE;
+    if (above(v, p) && above(v, q)) return reflex ? SPLIT : START;
+    if (above(p, v) && above(q, v)) return reflex ? MERGE : END;
+    return REGULAR;
+  }
+
+  /* return false if the sweep finds the polygon is not simple */
+  bool partition(std::vector<std::pair<unsigned, unsigned>>& diagonals) {
+    unsigned n_points = _polygon.size();
+    std::vector<unsigned> order(n_points);
+    std::iota(order.begin(), order.end(), 0u);
+    std::sort(order.begin(), order.end(), [&](unsigned i, unsigned j) {
+      return above(_polygon[i], _polygon[j]);
+    });
+    std::vector<vertex_type> types(n_points);
+    for (unsigned i = 0; i < n_points; ++i) types[i] = type_of(i);
+
+    std::set<unsigned, edge_less> status(edge_less{this});
+    std::vector<unsigned> helper(n_points);
+    // edge directly left of vertex i, none if the polygon is not simple
+    auto find_left_edge = [&](unsigned i, unsigned& e) {
+      _query = _polygon[i];
+      auto it = status.lower_bound(n_points);
+      if (it == status.begin()) return false;
+      e = *--it;
+      return true;
+    };
+    // update the helper of the edge directly left of vertex i
+    auto left_edge = [&](unsigned i) {
+      unsigned e;
+      if (!find_left_edge(i, e)) return false;
+      if (types[helper[e]] == MERGE) diagonals.emplace_back(i, helper[e]);
+      helper[e] = i;
+      return true;
+    };
+    // end of the edge above vertex i, which is missing if the polygon is
+    // not simple
+    auto remove_edge = [&](unsigned i) {
+      unsigned e = prev(i);
+      if (status.find(e) == status.end()) return false;
+      if (types[helper[e]] == MERGE) diagonals.emplace_back(i, helper[e]);
+      status.erase(e);
+      return true;
+    };
+    for (unsigned i : order) {
+      switch (types[i]) {
+        case START:
+          helper[i] = i;
+          status.insert(i);
+          break;
+        case END:
+          if (!remove_edge(i)) return false;
+          break;
+        case SPLIT: {
+          unsigned e;
+          if (!find_left_edge(i, e)) return false;
+          diagonals.emplace_back(i, helper[e]);
+          helper[e] = i;
+          helper[i] = i;
+          status.insert(i);
+          break;
+        }
+        case MERGE:
+          if (!remove_edge(i) || !left_edge(i)) return false;
+          break;
+        case REGULAR:
+          if (above(_polygon[prev(i)], _polygon[i])) {
+            // on a left chain, the interior is on the right
+            if (!remove_edge(i)) return false;
+            helper[i] = i;
+            status.insert(i);
+          } else if (!left_edge(i)) {
+            return false;
+          }
+          break;
+      }
+    }
+    return status.empty();
+  }
+
+  /* split the polygon along the diagonals into counterclock-wise pieces,
+   * the edges around each vertex are ordered counterclock-wise from the edge
+   * to its next vertex, all of them lying in its interior angle */
+  void split(const std::vector<std::pair<unsigned, unsigned>>& diagonals,
+             std::vector<std::vector<unsigned>>& pieces) const {
+    unsigned n_points = _polygon.size();
+    if (diagonals.empty()) {
+      pieces.emplace_back(n_points);
+      std::iota(pieces[0].begin(), pieces[0].end(), 0u);
+      return;
+    }
+    std::vector<unsigned> offsets(n_points + 1, 2);
+    offsets[0] = 0;
+    for (const auto& d : diagonals) {
+      ++offsets[d.first + 1];
+      ++offsets[d.second + 1];
+    }
+    for (unsigned i = 0; i < n_points; ++i) offsets[i + 1] += offsets[i];
+    std::vector<unsigned> around(offsets.back());
+    std::vector<unsigned> fill(offsets.begin(), offsets.end() - 1);
+    for (unsigned i = 0; i < n_points; ++i) around[fill[i]++] = next(i);
+    for (const auto& d : diagonals) {
+      around[fill[d.first]++] = d.second;
+      around[fill[d.second]++] = d.first;
+    }
+    for (unsigned i = 0; i < n_points; ++i) {
+      around[fill[i]] = prev(i);
+      const Point& v = _polygon[i];
+      Point ref = _polygon[next(i)] - v;
+      // angles in (0, 2 pi) from the edge to the next vertex
+      auto half = [&](const Point& d) {
+        T cross = ref % d;
+        return cross < T(0) || (cross == T(0) && ref * d < T(0));
+      };
+      std::sort(around.begin() + offsets[i] + 1, around.begin() + fill[i],
+                [&](unsigned a, unsigned b) {
+                  Point da = _polygon[a] - v, db = _polygon[b] - v;
+                  bool ha = half(da), hb = half(db);
+                  if (ha != hb) return hb;
+                  return da % db > T(0);
+                });
+    }
+
+    // half-edge k of vertex i goes to around[k], sorted to find the twins
+    std::vector<std::pair<unsigned, unsigned>> keys(around.size());
+    std::vector<unsigned> from(around.size());
+    for (unsigned i = 0; i < n_points; ++i) {
+      for (unsigned k = offsets[i]; k < offsets[i + 1]; ++k) {
+        keys[k] = std::make_pair(i, around[k]);
+        from[k] = i;
+      }
+    }
+    std::vector<unsigned> sorted(around.size());
+    std::iota(sorted.begin(), sorted.end(), 0u);
+    std::sort(sorted.begin(), sorted.end(),
+              [&](unsigned a, unsigned b) { return keys[a] < keys[b]; });
+    auto find = [&](unsigned i, unsigned j) {
+      auto it = std::lower_bound(
+          sorted.begin(), sorted.end(), std::make_pair(i, j),
+          [&](unsigned k, const std::pair<unsigned, unsigned>& key) {
+            return keys[k] < key;
+          });
+      return *it;
+    };
+
+    // the piece on the left of half-edge (u, v) goes on with the edge of v
+    // just before (v, u) counterclock-wise
+    std::vector<bool> used(around.size(), false);
+    for (unsigned k = 0; k < around.size(); ++k) {
+      if (used[k] || around[k] == prev(from[k])) continue;
+      std::vector<unsigned> piece;
+      for (unsigned h = k; !used[h];) {
+        used[h] = true;
+        piece.push_back(from[h]);
+        unsigned v = around[h];
+        unsigned twin = find(v, from[h]);
+        h = twin == offsets[v] ? offsets[v + 1] - 1 : twin - 1;
+      }
+      pieces.push_back(std::move(piece));
+    }
+  }
+
+  /* stack triangulation of a counterclock-wise y-monotone piece */
+  void triangulate_monotone(const std::vector<unsigned>& piece,
+                            std::vector<std::array<unsigned, 3>>& triangles) {
+    unsigned m = piece.size();
+    if (m < 3) return;
+    unsigned top = 0, bottom = 0;
+    for (unsigned k = 1; k < m; ++k) {
+      if (above(_polygon[piece[k]], _polygon[piece[top]])) top = k;
+      if (above(_polygon[piece[bottom]], _polygon[piece[k]])) bottom = k;
+    }
+    // merge the left chain, from the top forward, and the right chain, from
+    // the top backward, by sweep order
+    std::vector<std::pair<unsigned, bool>> sorted;
+    sorted.reserve(m);
+    sorted.emplace_back(piece[top], true);
+    unsigned l = (top + 1) % m, r = (top + m - 1) % m;
+    while (sorted.size() < m) {
+      if (l != bottom && (r == bottom || above(_polygon[piece[l]],
+                                               _polygon[piece[r]]))) {
+        sorted.emplace_back(piece[l], true);
+        l = (l + 1) % m;
+      } else if (r != bottom) {
+        sorted.emplace_back(piece[r], false);
+        r = (r + m - 1) % m;
+      } else {
+        sorted.emplace_back(piece[bottom], true);
+      }
+    }
+
+    auto emit = [&](unsigned a, unsigned b, unsigned c) {
+      if (orient_2d(_polygon[a], _polygon[b], _polygon[c]) ==
+          ORIENTATION::NEGATIVE)
+        std::swap(b, c);
+      triangles.push_back(std::array<unsigned, 3>{a, b, c});
+    };
+    std::vector<std::pair<unsigned, bool>> stack{sorted[0], sorted[1]};
+    for (unsigned j = 2; j < m; ++j) {
+      unsigned u = sorted[j].first;
+      bool left = sorted[j].second;
+      if (j == m - 1 || left != stack.back().second) {
+        // fan to the whole stack, the bottom vertex sees both chains
+        for (unsigned k = stack.size() - 1; k > 0; --k)
+          emit(u, stack[k].first, stack[k - 1].first);
+        std::pair<unsigned, bool> last = stack.back();
+        stack.assign({last, sorted[j]});
+      } else {
+        std::pair<unsigned, bool> last = stack.back();
+        stack.pop_back();
+        while (!stack.empty()) {
+          unsigned s = stack.back().first;
+          ORIENTATION ori =
+              left ? orient_2d(_polygon[s], _polygon[last.first], _polygon[u])
+                   : orient_2d(_polygon[u], _polygon[last.first], _polygon[s]);
+          if (ori != ORIENTATION::POSITIVE) break;
+          emit(u, last.first, s);
+          last = stack.back();
+          stack.pop_back();
+        }
+        stack.push_back(last);
+        stack.push_back(sorted[j]);
+      }
+    }
+  }
+
+ private:
+  const Polygon& _polygon;
+  /* point looked up in the status */
+  Point _query;
+};
+
 }  // namespace internal
 
+/**
+ * @brief ear clipping checking every non-convex vertex for each ear, O(n^2)
+ */
+struct EarClippingTag {};
+
+/**
+ * @brief ear clipping checking only the non-convex vertices in the bounding
+ * box of each ear, found through their z-order, for large polygons
+ */
+struct ZOrderEarClippingTag {};
+
+/**
+ * @brief sweep line partition into y-monotone pieces, each triangulated in
+ * linear time, O(n log n) in the worst case
+ */
+struct MonotonePartitionTag {};
+
 /**
  * @brief triangulate a single counterclock-wise 2d-polygon into several
  * triangles using ear-clipping
@@ -127,11 +642,88 @@ class triangulate_polygon_modifier_2d {
  */
 template <typename Polygon>
 bool triangulate_polygon_2d(const Polygon& polygon,
-                            std::vector<std::array<unsigned, 3>>& triangles) {
+                            std::vector<std::array<unsigned, 3>>& triangles,
+                            EarClippingTag = EarClippingTag()) {
   internal::triangulate_polygon_modifier_2d<Polygon> modifier(polygon);
   return modifier.execute(triangles);
 }
 
+/**
+ * @brief triangulate a single counterclock-wise 2d-polygon into several
+ * triangles using ear-clipping, where the ears are only checked against the
+ * non-convex vertices in their bounding box
+ * @return true if the polygon be trianguled successfully.
+ * @note the polygon should be intersect-free, except for the duplicated
+ * vertices of bridged holes. Expected O(n log n) for polygons whose vertices
+ * are spread evenly.
+ */
+template <typename Polygon>
+bool triangulate_polygon_2d(const Polygon& polygon,
+                            std::vector<std::array<unsigned, 3>>& triangles,
+                            ZOrderEarClippingTag) {
+  internal::z_order_ear_clipping_2d<Polygon> modifier(polygon);
+  return modifier.execute(triangles);
+}
+
+/**
+ * @brief triangulate a single counterclock-wise 2d-polygon into several
+ * triangles by partitioning it into y-monotone pieces
+ * @return true if the polygon be trianguled successfully.
+ * @note the polygon should be intersect-free, the result does not depend on
+ * where the polygon starts. O(n log n) in the worst case.
+ */
+template <typename Polygon>
+bool triangulate_polygon_2d(const Polygon& polygon,
+                            std::vector<std::array<unsigned, 3>>& triangles,
+                            MonotonePartitionTag) {
+  internal::monotone_partition_2d<Polygon> modifier(polygon);
+  return modifier.execute(triangles);
+}
+
+/**
+ * @brief triangulate a 2d-polygon with holes by recovering its edges in the
+ * Delaunay triangulation of its points, then removing the triangles inside
+ * the holes by even-odd parity
+ * @param triangles counterclock-wise triangles, the points are indexed with
+ * the outer polygon first, then each hole in turn
+ * @param delaunay whether to flip the other edges back to a constrained
+ * Delaunay triangulation, which avoids slivers but costs more flips
+ * @return true if the polygon be trianguled successfully.
+ * @note the rings should be intersect-free and not share any point, the
+ * orientation of each ring does not matter. Expected O(n log n) for rings
+ * whose vertices are spread evenly. The points are inserted in ring order, so
+ * many cocircular points, such as a regular polygon, may cost O(n^2) flips.
+ */
+template <typename T>
+bool triangulate_polygon_with_holes_2d(
+    const geo2d::PolygonWithHoles<T>& polygon,
+    std::vector<std::array<unsigned, 3>>& triangles, bool delaunay = false) {
+  triangles.clear();
+  geo2d::PSLG<T> pslg;
+  pslg._points.reserve(polygon.n_points());
+  pslg._segments.reserve(polygon.n_points());
+  auto add_ring = [&](const geo2d::Polygon<T>& ring) {
+    unsigned first = pslg._points.size();
+    for (unsigned i = 0; i < ring.size(); ++i) {
+      pslg._points.push_back(ring[i]);
+      pslg._segments.emplace_back(first + i, first + (i + 1) % ring.size());
+    }
+  };
+  add_ring(polygon.outer());
+  for (unsigned i = 0; i < polygon.n_holes(); ++i) add_ring(polygon.hole(i));
+  pslg._segmentmarks.assign(pslg._segments.size(), 0);
+
+  try {
+    Triangulation<T> triangulation(pslg);
+    if (delaunay) triangulation.restore_delaunay();
+    triangulation.carve_even_odd();
+    triangulation.triangles(triangles);
+  } catch (int) {
+    return false;
+  }
+  return true;
+}
+
 namespace internal {
 
 template <typename T>
@@ -170,6 +762,7 @@ class triangulate_polygon_modifier_3d {
     }
     unsigned begin_id = 0;
     unsigned iter_times = 0;
+    triangles.clear();
     triangles.reserve(n_points - 2);
     while (_vertex_list[_vertex_list[begin_id].next_id].next_id !=
            _vertex_list[begin_id].prev_id) {
@@ -239,6 +832,25 @@ class triangulate_polygon_modifier_3d {
   std::vector<vertex> _vertex_list;
 };
 
+/* project a 3d-polygon onto the coordinate plane most orthogonal to its
+ * normal, swapping the two coordinates kept if needed so that the projection
+ * is counterclock-wise. Exact, since it only drops a coordinate */
+template <typename T>
+std::vector<geo2d::Point<T>> project_polygon_3d(
+    const geo3d::Polygon<T>& polygon) {
+  geo3d::Point<T> normal = polygon.normal();
+  unsigned axis = 0;
+  for (unsigned k = 1; k < 3; ++k)
+    if (absolute(normal[axis]) < absolute(normal[k])) axis = k;
+  unsigned x = (axis + 1) % 3, y = (axis + 2) % 3;
+  if (normal[axis] < T(0)) std::swap(x, y);
+  std::vector<geo2d::Point<T>> result;
+  result.reserve(polygon.size());
+  for (unsigned i = 0; i < polygon.size(); ++i)
+    result.emplace_back(polygon[i][x], polygon[i][y]);
+  return result;
+}
+
 }  // namespace internal
 
 /**
@@ -270,6 +882,44 @@ bool triangulate_polygon_3d(const Polygon& polygon,
   return modifier.execute(triangles);
 }
 
+/**
+ * @brief triangulate a single 3d-polygon into several triangles by projecting
+ * it once onto the coordinate plane most orthogonal to its normal, then using
+ * the 2d algorithm of the tag
+ * @param tag EarClippingTag, ZOrderEarClippingTag or MonotonePartitionTag
+ * @return true if the polygon be trianguled successfully.
+ * @note the polygon should be planar and intersect-free, the normal gives its
+ * orientation. The projection only drops a coordinate, so the orientation
+ * tests stay exact for exact number types, and are 2d ones.
+ */
+template <typename T, typename Tag>
+bool triangulate_polygon_3d(const geo3d::Polygon<T>& polygon,
+                            std::vector<std::array<unsigned, 3>>& triangles,
+                            Tag tag) {
+  if (polygon.size() < 3) return false;
+  return triangulate_polygon_2d(internal::project_polygon_3d(polygon),
+                                triangles, tag);
+}
+
+/**
+ * @brief triangulate a single 3d-polygon into several triangles by projecting
+ * it once onto the coordinate plane most orthogonal to its normal, then using
+ * the 2d algorithm of the tag
+ * @tparam NumberType the point coordinate type
+ * @tparam Polygon point container
+ * @param tag EarClippingTag, ZOrderEarClippingTag or MonotonePartitionTag
+ * @return true if the polygon be trianguled successfully.
+ * @note the polygon should have the iterator method, be planar and
+ * intersect-free.
+ */
+template <typename NumberType, typename Polygon, typename Tag>
+bool triangulate_polygon_3d(const Polygon& polygon,
+                            std::vector<std::array<unsigned, 3>>& triangles,
+                            Tag tag) {
+  geo3d::Polygon<NumberType> geo_poly(polygon.begin(), polygon.end());
+  return triangulate_polygon_3d(geo_poly, triangles, tag);
+}
+
 }  // namespace algorithm
 }  // namespace CMTL
 
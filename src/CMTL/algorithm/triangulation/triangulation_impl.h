@@ -5,6 +5,9 @@
 #include "../predicate.h"
 #include "triangulation_storage.h"
 
+#include <array>
+#include <deque>
+#include <utility>
 #include <vector>
 
 #define TRIANGULATION_QUIT_ON_BUG 0
@@ -13,12 +16,22 @@
 namespace CMTL {
 namespace algorithm {
 
+/**
+ * @brief triangulation of a planar straight line graph: the Delaunay
+ * triangulation of its points, where its segments are recovered by edge flips
+ * @note nothing is carved out and the edges around the segments are not
+ * flipped back to Delaunay unless restore_delaunay() or a carve step is called
+ */
 template <typename T>
 class Triangulation : public Internal::TriangulationStorage<T> {
  public:
+  /**
+   * @brief triangulate a planar straight line graph
+   */
   Triangulation(const geo2d::PSLG<T>& input);
   virtual ~Triangulation();
 
+  using typename Internal::TriangulationStorage<T>::Point;
   using typename Internal::TriangulationStorage<T>::Vertex;
   using typename Internal::TriangulationStorage<T>::TriEdge;
   using typename Internal::TriangulationStorage<T>::Triangle;
@@ -30,6 +43,38 @@ class Triangulation : public Internal::TriangulationStorage<T> {
   enum LocateResult { INTRIANGLE, ONEDGE, ONVERTEX, OUTSIDE };
   enum FlipType { FLIP13 };
 
+ public:
+  /**
+   * @brief get the triangles which are not carved out, as the indices of
+   * their input points in counterclockwise order
+   */
+  void triangles(std::vector<std::array<unsigned, 3>>& result) const;
+
+  /**
+   * @brief get the marker of the segment, or of the piece of a segment split
+   * at the points lying on it, between two input points
+   * @return false if they are not joined by a segment
+   */
+  bool segment_mark(unsigned i, unsigned j, int& mark) const;
+
+  /**
+   * @brief flip the edges which are not segments back to a constrained
+   * Delaunay triangulation
+   */
+  void restore_delaunay();
+
+  /**
+   * @brief carve out the triangles reachable from the convex hull or from a
+   * hole point without crossing a segment
+   */
+  void carve_holes(const std::vector<Point>& holes);
+
+  /**
+   * @brief carve out the triangles enclosed by an even number of segment
+   * loops, such as the holes of a polygon given by its outer and inner rings
+   */
+  void carve_even_odd();
+
  private:
   int incremental_delaunay();
   void recover_segments(const std::vector<std::pair<unsigned, unsigned>>& segs,
@@ -47,9 +92,11 @@ class Triangulation : public Internal::TriangulationStorage<T> {
   void flip13(Vertex* v, TriEdge& te);
   void flip24(Vertex* v, TriEdge& te);
   void flip22(TriEdge& te);
+  void flip22_constrained(TriEdge& te);
   void lawson_flip(Vertex* v, TriEdge& start);
   int find_direction(TriEdge& starttri, Vertex* endv);
-  int scout_segment(TriEdge& searchtri, Vertex* endpoint2, int mark);
+  bool find_edge(Vertex* v0, Vertex* v1, TriEdge& te) const;
+  Vertex* flip_crossings(TriEdge searchtri, Vertex* endv);
   void insert_subsegment(TriEdge& te, int mark);
 
  private:
@@ -94,6 +141,8 @@ Triangulation<T>::Triangulation(const geo2d::PSLG<T>& input)
 
   incremental_delaunay();
 
+  if (input._segments.empty()) return;
+
   recover_segments(input._segments, input._segmentmarks);
 }
 
@@ -135,55 +184,123 @@ typename Triangulation<T>::InsertVertexResult Triangulation<T>::insert_vertex(
   return insertresult;
 }
 
+/**
+ * @brief recover a segment as a chain of edges, splitting it at the vertices
+ * lying on it
+ */
 template <typename T>
 void Triangulation<T>::recover_segment(Vertex* endpoint1, Vertex* endpoint2,
                                        int mark) {
-  TriEdge p1tri = endpoint1->adj;
-  if (scout_segment(p1tri, endpoint2, mark)) {
-    return;
-  }
-  endpoint1 = p1tri.org();
-
-  TriEdge p2tri = endpoint2->adj;
-  if (scout_segment(p2tri, endpoint1, mark)) {
-    return;
+  while (endpoint1 != endpoint2) {
+    TriEdge searchtri = endpoint1->adj;
+    int collinear = find_direction(searchtri, endpoint2);
+    if (collinear == 1) {
+      insert_subsegment(searchtri, mark);
+      endpoint1 = searchtri.dest();
+    } else if (collinear == -1) {
+      searchtri = searchtri.prev();
+      insert_subsegment(searchtri, mark);
+      endpoint1 = searchtri.org();
+    } else {
+      Vertex* reached = flip_crossings(searchtri, endpoint2);
+      if (!find_edge(endpoint1, reached, searchtri)) {
+        quit(TRIANGULATION_QUIT_ON_BUG);
+      }
+      insert_subsegment(searchtri, mark);
+      endpoint1 = reached;
+    }
   }
-  endpoint2 = p2tri.org();
 }
 
+/**
+ * @brief flip away the edges crossing the segment from the origin of
+ * 'searchtri' to 'endv' (Sloan's algorithm), the segment stops at the first
+ * vertex lying on it
+ * @param searchtri a triangle whose edge opposite to its origin crosses the
+ * segment
+ * @return endv or the first vertex lying on the segment, the edge from the
+ * origin to it exists on return
+ */
 template <typename T>
-int Triangulation<T>::scout_segment(TriEdge& searchtri, Vertex* endpoint2,
-                                    int mark) {
-  int collinear = find_direction(searchtri, endpoint2);
-  Vertex* rightv = searchtri.dest();
-  Vertex* leftv = searchtri.apex();
-  if (is_same(leftv, endpoint2)) {
-    searchtri = searchtri.prev();
-    insert_subsegment(searchtri, mark);
-    return 1;
-  } else if (is_same(rightv, endpoint2)) {
-    insert_subsegment(searchtri, mark);
-    return 1;
-  } else if (collinear == -1) {
-    searchtri = searchtri.prev();
-    insert_subsegment(searchtri, mark);
-    return scout_segment(searchtri, endpoint2, mark);
-  } else if (collinear == 1) {
-    insert_subsegment(searchtri, mark);
-    searchtri = searchtri.next();
-    return scout_segment(searchtri, endpoint2, mark);
-  } else {
-    TriEdge crosstri = searchtri.next();
+typename Triangulation<T>::Vertex* Triangulation<T>::flip_crossings(
+    TriEdge searchtri, Vertex* endv) {
+  Vertex* startv = searchtri.org();
+  Vertex* reached = endv;
+
+  // walk along the segment, the crossed edges go from its right to its left
+  std::deque<std::pair<Vertex*, Vertex*>> crossings;
+  TriEdge crosstri = searchtri.next();
+  while (true) {
     if (crosstri.is_segment()) {
-      return 0;
-    } else {
-      return scout_segment(searchtri, endpoint2, mark);
+      std::cerr << "Error : Segments intersect at an interior point.\n";
+      quit(TRIANGULATION_QUIT_ON_INPUT_ERROR);
+    }
+    crossings.emplace_back(crosstri.org(), crosstri.dest());
+    TriEdge oppotri = crosstri.sym();
+    Vertex* farv = oppotri.apex();
+    if (farv == endv) break;
+    ORIENTATION ori = orient2d(startv, endv, farv);
+    if (ori == ORIENTATION::ON) {
+      reached = farv;
+      break;
     }
+    crosstri = ori == ORIENTATION::POSITIVE ? oppotri.next() : oppotri.prev();
   }
+
+  // flip the crossing edges whose quadrilateral is convex, until none cross
+  while (!crossings.empty()) {
+    std::pair<Vertex*, Vertex*> edge = crossings.front();
+    crossings.pop_front();
+    TriEdge fliptri;
+    if (!find_edge(edge.first, edge.second, fliptri)) {
+      quit(TRIANGULATION_QUIT_ON_BUG);
+    }
+    Vertex* va = fliptri.org();
+    Vertex* vb = fliptri.dest();
+    Vertex* vc = fliptri.apex();
+    Vertex* vd = fliptri.sym().apex();
+    ORIENTATION oria = orient2d(vd, vc, va);
+    ORIENTATION orib = orient2d(vd, vc, vb);
+    if (oria == ORIENTATION::ON || orib == ORIENTATION::ON || oria == orib) {
+      crossings.push_back(edge);
+      continue;
+    }
+    flip22_constrained(fliptri);
+    if (vc == startv || vc == reached || vd == startv || vd == reached)
+      continue;
+    ORIENTATION oric = orient2d(startv, reached, vc);
+    ORIENTATION orid = orient2d(startv, reached, vd);
+    if (oric != ORIENTATION::ON && orid != ORIENTATION::ON && oric != orid)
+      crossings.emplace_back(vd, vc);
+  }
+
+  return reached;
 }
 
+/**
+ * @brief find the edge from one vertex to another
+ * @param te the edge if found
+ * @return false if they are not connected
+ */
 template <typename T>
-void Triangulation<T>::insert_subsegment(TriEdge& te, int mark) {}
+bool Triangulation<T>::find_edge(Vertex* v0, Vertex* v1, TriEdge& te) const {
+  TriEdge first = v0->adj;
+  te = first;
+  do {
+    if (te.dest() == v1) return true;
+    te = te.ccw();
+  } while (te.tri != first.tri || te.ori != first.ori);
+  return false;
+}
+
+template <typename T>
+void Triangulation<T>::insert_subsegment(TriEdge& te, int mark) {
+  te.set_segment();
+  TriEdge symtri = te.sym();
+  symtri.set_segment();
+  te.tri->segmark[te.ori] = mark;
+  symtri.tri->segmark[symtri.ori] = mark;
+}
 
 template <typename T>
 typename Triangulation<T>::LocateResult Triangulation<T>::locate(
@@ -285,7 +402,7 @@ void Triangulation<T>::flip13(Vertex* v, TriEdge& te) {
   Vertex* vc = te.apex();
 
   int mark = tt[0].tri->mark;
-  int area = tt[0].tri->area;
+  T area = tt[0].tri->area;
 
   TriEdge nn[3];
   for (unsigned i = 0; i < 3; ++i) {
@@ -338,9 +455,9 @@ void Triangulation<T>::flip24(Vertex* v, TriEdge& te) {
   Vertex* vd = tt[1].apex();
 
   int c_mark = tt[0].tri->mark;
-  int c_area = tt[0].tri->area;
+  T c_area = tt[0].tri->area;
   int d_mark = tt[1].tri->mark;
-  int d_area = tt[1].tri->area;
+  T d_area = tt[1].tri->area;
 
   TriEdge nn[4];
   nn[0] = tt[0].next().sym();  // [c, b]
@@ -400,9 +517,9 @@ void Triangulation<T>::flip22(TriEdge& te) {
   Vertex* vd = tt[1].apex();
 
   int c_mark = tt[0].tri->mark;
-  int c_area = tt[0].tri->area;
+  T c_area = tt[0].tri->area;
   int d_mark = tt[1].tri->mark;
-  int d_area = tt[1].tri->area;
+  T d_area = tt[1].tri->area;
 
   TriEdge nn[4];
   nn[0] = tt[0].next().sym();  // [c, b]
@@ -450,6 +567,24 @@ void Triangulation<T>::flip22(TriEdge& te) {
   te.ori = 0;
 }
 
+/**
+ * @brief flip22 which keeps the segment flags and markers of the four outer
+ * edges
+ */
+template <typename T>
+void Triangulation<T>::flip22_constrained(TriEdge& te) {
+  flip22(te);
+  TriEdge tt[2] = {te, te.sym()};
+  for (TriEdge& t : tt) {
+    for (t.ori = 0; t.ori < 3; ++t.ori) {
+      TriEdge symtri = t.sym();
+      if (!symtri.is_segment()) continue;
+      t.set_segment();
+      t.tri->segmark[t.ori] = symtri.tri->segmark[symtri.ori];
+    }
+  }
+}
+
 /**
  * @brief perform lawson flip around a vertex to recover delaunay property
  * @param v center vertex
@@ -509,58 +644,46 @@ void Triangulation<T>::lawson_flip(Vertex* v, TriEdge& start) {
  * @return 0 if the starttri's edge which opposite its origin vertex intersect
  * the path, 1 if 'starttri' collinear with the path, -1 if the prev edge of
  * 'starttri' collinear with the path.
- * @note the origin of the starttri
- * does not change, even though the triangle returned may change.
+ * @note the origin of the starttri does not change, even though the triangle
+ * returned may change. The triangles around the origin are visited in turn,
+ * skipping those of the infinite vertex.
  */
 template <typename T>
 int Triangulation<T>::find_direction(TriEdge& starttri, Vertex* endv) {
   Vertex* startv = starttri.org();
-  Vertex* rightv = starttri.dest();
-  Vertex* leftv = starttri.apex();
-
-  ORIENTATION leftori = orient2d(startv, endv, leftv);
-  ORIENTATION rightori = orient2d(startv, endv, rightv);
-  bool leftrotflag = (leftori == ORIENTATION::NEGATIVE);
-  bool rightrotflag = (rightori == ORIENTATION::POSITIVE);
-
-  if (leftrotflag && rightrotflag) {
-    TriEdge ccw = starttri.ccw();
-    if (ccw.tri->is_dummy())
-      leftrotflag = false;
-    else
-      rightrotflag = false;
-  }
-
-  while (leftrotflag) {
+  TriEdge first = starttri;
+  do {
+    Vertex* rightv = starttri.dest();
+    Vertex* leftv = starttri.apex();
+    if (rightv != this->_infvrt && leftv != this->_infvrt) {
+      ORIENTATION rightori = orient2d(startv, rightv, endv);
+      ORIENTATION leftori = orient2d(startv, leftv, endv);
+      if (rightori == ORIENTATION::ON &&
+          (rightv->crd - startv->crd) * (endv->crd - startv->crd) > 0)
+        return 1;
+      if (leftori == ORIENTATION::ON &&
+          (leftv->crd - startv->crd) * (endv->crd - startv->crd) > 0)
+        return -1;
+      if (rightori == ORIENTATION::POSITIVE &&
+          leftori == ORIENTATION::NEGATIVE)
+        return 0;
+    }
     starttri = starttri.ccw();
-    leftv = starttri.apex();
-    rightori = leftori;
-    leftori = orient2d(startv, endv, leftv);
-    leftrotflag = (leftori == ORIENTATION::NEGATIVE);
-  }
-  while (rightrotflag) {
-    starttri = starttri.cw();
-    rightv = starttri.dest();
-    leftori = rightori;
-    rightori = orient2d(startv, endv, rightv);
-    rightrotflag = (rightori == ORIENTATION::POSITIVE);
-  }
-
-  if (leftori == ORIENTATION::ON)
-    return -1;
-  else if (rightori == ORIENTATION::ON)
-    return 1;
-  else
-    return 0;
+  } while (starttri.tri != first.tri || starttri.ori != first.ori);
+  quit(TRIANGULATION_QUIT_ON_BUG);
+  return 0;
 }
 
 template <typename T>
 int Triangulation<T>::incremental_delaunay() {
+  // the triangle is changed by the insertions, keep its vertices
   Triangle* firstT = first_tri();
+  Vertex* firstv1 = firstT->vrt[1];
+  Vertex* firstv2 = firstT->vrt[2];
 
   for (unsigned i = 1; i < this->_vertices.size(); ++i) {
     Vertex* curr = this->_vertices[i];
-    if (curr == firstT->vrt[1] || curr == firstT->vrt[2] ||
+    if (curr == firstv1 || curr == firstv2 ||
         curr->type == this->UNUSEDVERTEX)
       continue;
     TriEdge searchtri = this->_infvrt->adj;
@@ -612,6 +735,133 @@ void Triangulation<T>::recover_segments(
   }
 }
 
+template <typename T>
+void Triangulation<T>::restore_delaunay() {
+  std::vector<std::pair<Vertex*, Vertex*>> stack;
+  for (Triangle* tri : this->_triangles) {
+    if (tri->is_dummy()) continue;
+    for (unsigned char i = 0; i < 3; ++i) {
+      TriEdge te(tri, i);
+      if (te.org() < te.dest()) stack.emplace_back(te.org(), te.dest());
+    }
+  }
+
+  while (!stack.empty()) {
+    std::pair<Vertex*, Vertex*> edge = stack.back();
+    stack.pop_back();
+    TriEdge fliptri;
+    if (!find_edge(edge.first, edge.second, fliptri)) continue;
+    if (fliptri.is_segment()) continue;
+    TriEdge symtri = fliptri.sym();
+    if (fliptri.tri->is_dummy() || symtri.tri->is_dummy()) continue;
+    Vertex* va = fliptri.org();
+    Vertex* vb = fliptri.dest();
+    Vertex* vc = fliptri.apex();
+    Vertex* vd = symtri.apex();
+    if (local_delaunay_check(va, vb, vc, vd)) continue;
+    // only flip convex quadrilaterals in case of inexact predicates
+    ORIENTATION oria = orient2d(vd, vc, va);
+    ORIENTATION orib = orient2d(vd, vc, vb);
+    if (oria == ORIENTATION::ON || orib == ORIENTATION::ON || oria == orib)
+      continue;
+    flip22_constrained(fliptri);
+    stack.emplace_back(va, vc);
+    stack.emplace_back(vc, vb);
+    stack.emplace_back(vb, vd);
+    stack.emplace_back(vd, va);
+  }
+}
+
+template <typename T>
+void Triangulation<T>::carve_holes(const std::vector<Point>& holes) {
+  std::vector<Triangle*> stack;
+  for (Triangle* tri : this->_triangles) {
+    if (!tri->is_dummy()) continue;
+    for (unsigned char i = 0; i < 3; ++i) {
+      TriEdge te(tri, i);
+      Triangle* nei = te.sym().tri;
+      if (te.is_segment() || nei->is_dummy() || nei->is_hole()) continue;
+      nei->set_hole();
+      stack.push_back(nei);
+    }
+  }
+  for (const Point& p : holes) {
+    Vertex holevertex;
+    holevertex.crd = p;
+    TriEdge searchtri = this->_infvrt->adj;
+    if (locate(&holevertex, searchtri) == OUTSIDE) continue;
+    if (searchtri.tri->is_dummy() || searchtri.tri->is_hole()) continue;
+    searchtri.tri->set_hole();
+    stack.push_back(searchtri.tri);
+  }
+
+  while (!stack.empty()) {
+    Triangle* tri = stack.back();
+    stack.pop_back();
+    for (unsigned char i = 0; i < 3; ++i) {
+      TriEdge te(tri, i);
+      Triangle* nei = te.sym().tri;
+      if (te.is_segment() || nei->is_dummy() || nei->is_hole()) continue;
+      nei->set_hole();
+      stack.push_back(nei);
+    }
+  }
+}
+
+template <typename T>
+void Triangulation<T>::carve_even_odd() {
+  // breadth first from the outside, crossing a segment changes the side
+  std::vector<Triangle*> queue;
+  for (Triangle* tri : this->_triangles) {
+    tri->clear_hole();
+    tri->clear_infected();
+    if (tri->is_dummy()) {
+      tri->set_infected();
+      queue.push_back(tri);
+    }
+  }
+  for (size_t k = 0; k < queue.size(); ++k) {
+    Triangle* tri = queue[k];
+    bool outside = tri->is_dummy() || tri->is_hole();
+    for (unsigned char i = 0; i < 3; ++i) {
+      TriEdge te(tri, i);
+      Triangle* nei = te.sym().tri;
+      if (nei->is_infected()) continue;
+      nei->set_infected();
+      if (outside != te.is_segment()) nei->set_hole();
+      queue.push_back(nei);
+    }
+  }
+  for (Triangle* tri : this->_triangles) tri->clear_infected();
+}
+
+template <typename T>
+void Triangulation<T>::triangles(
+    std::vector<std::array<unsigned, 3>>& result) const {
+  result.clear();
+  for (const Triangle* tri : this->_triangles) {
+    if (tri->is_dummy() || tri->is_hole()) continue;
+    result.push_back(std::array<unsigned, 3>{unsigned(tri->vrt[0]->idx),
+                                             unsigned(tri->vrt[1]->idx),
+                                             unsigned(tri->vrt[2]->idx)});
+  }
+}
+
+template <typename T>
+bool Triangulation<T>::segment_mark(unsigned i, unsigned j, int& mark) const {
+  if (i >= this->_vertices.size() || j >= this->_vertices.size()) return false;
+  Vertex* v0 = this->_vertices[i];
+  Vertex* v1 = this->_vertices[j];
+  if (v0->type == this->UNUSEDVERTEX && v0->pair != nullptr) v0 = v0->pair;
+  if (v1->type == this->UNUSEDVERTEX && v1->pair != nullptr) v1 = v1->pair;
+  if (v0->type == this->UNUSEDVERTEX || v1->type == this->UNUSEDVERTEX)
+    return false;
+  TriEdge te;
+  if (!find_edge(v0, v1, te) || !te.is_segment()) return false;
+  mark = te.tri->segmark[te.ori];
+  return true;
+}
+
 template <typename T>
 typename Triangulation<T>::Triangle* Triangulation<T>::first_tri() {
   Vertex* v0 = this->_vertices[0];
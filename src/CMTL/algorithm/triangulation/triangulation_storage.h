@@ -22,6 +22,18 @@ class TriangulationStorage {
   friend void io::write_obj(const TriangulationStorage<TT>& triangulation,
                             const std::string& file);
 
+  template <typename TT>
+  friend void io::write_obj(const TriangulationStorage<TT>& triangulation,
+                            std::ostream& out);
+
+  template <typename TT>
+  friend void io::write_node(const TriangulationStorage<TT>& triangulation,
+                             std::ostream& out);
+
+  template <typename TT>
+  friend void io::write_ele(const TriangulationStorage<TT>& triangulation,
+                            std::ostream& out);
+
  public:
   void clean();
 
@@ -86,6 +98,7 @@ class TriangulationStorage {
     TriEdge nei[3];
     int flags;
     int mark;
+    int segmark[3];  // markers of the segments on the edges
     T area;
 
     Triangle();
@@ -94,6 +107,16 @@ class TriangulationStorage {
     bool is_dummy() const;
     void set_dummy();
     void clear_dummy();
+
+    /* carved out of the domain */
+    bool is_hole() const;
+    void set_hole();
+    void clear_hole();
+
+    /* scratch mark of the traversals */
+    bool is_infected() const;
+    void set_infected();
+    void clear_infected();
   };
 
   struct Segment {};
@@ -147,6 +170,10 @@ void TriangulationStorage<T>::clean() {
   for (unsigned i = 0; i < _triangles.size(); ++i) {
     if (_triangles[i]) delete _triangles[i];
   }
+  // clean may run again from the destructor
+  _infvrt = nullptr;
+  _vertices.clear();
+  _triangles.clear();
 }
 
 // TriEdge
@@ -258,6 +285,7 @@ void TriangulationStorage<T>::Triangle::init() {
   nei[0].tri = nei[1].tri = nei[2].tri = nullptr;
   nei[0].ori = nei[1].ori = nei[2].ori = 0;
   flags = mark = 0;
+  segmark[0] = segmark[1] = segmark[2] = 0;
   area = T(0);
 }
 
@@ -276,6 +304,36 @@ void TriangulationStorage<T>::Triangle::clear_dummy() {
   flags &= ~1;
 }
 
+template <typename T>
+bool TriangulationStorage<T>::Triangle::is_hole() const {
+  return flags & 2;
+}
+
+template <typename T>
+void TriangulationStorage<T>::Triangle::set_hole() {
+  flags |= 2;
+}
+
+template <typename T>
+void TriangulationStorage<T>::Triangle::clear_hole() {
+  flags &= ~2;
+}
+
+template <typename T>
+bool TriangulationStorage<T>::Triangle::is_infected() const {
+  return flags & 4;
+}
+
+template <typename T>
+void TriangulationStorage<T>::Triangle::set_infected() {
+  flags |= 4;
+}
+
+template <typename T>
+void TriangulationStorage<T>::Triangle::clear_infected() {
+  flags &= ~4;
+}
+
 }  // namespace Internal
 }  // namespace algorithm
 }  // namespace CMTL
@@ -1,6 +1,7 @@
 #ifndef __algorithm_triangulation_storage_fwd_h__
 #define __algorithm_triangulation_storage_fwd_h__
 
+#include <iosfwd>
 #include <string>
 
 namespace CMTL {
@@ -18,6 +19,21 @@ template <typename T>
 void write_obj(
     const algorithm::Internal::TriangulationStorage<T>& triangulation,
     const std::string& file);
+
+template <typename T>
+void write_obj(
+    const algorithm::Internal::TriangulationStorage<T>& triangulation,
+    std::ostream& out);
+
+template <typename T>
+void write_node(
+    const algorithm::Internal::TriangulationStorage<T>& triangulation,
+    std::ostream& out);
+
+template <typename T>
+void write_ele(
+    const algorithm::Internal::TriangulationStorage<T>& triangulation,
+    std::ostream& out);
 }
 
 }  // namespace CMTL
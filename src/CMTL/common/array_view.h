@@ -0,0 +1,79 @@
+#ifndef __common_array_view_h__
+#define __common_array_view_h__
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief Computational Mathematics Tool Library
+ */
+namespace CMTL {
+
+/**
+ * @brief non-owning view of a contiguous array, used to expose a piece of a
+ * flat storage such as a polygon of a polygon soup
+ * @tparam T element type, const for a read-only view
+ */
+template <typename T>
+class ArrayView {
+ public:
+  typedef T value_type;
+  typedef T* iterator;
+  typedef T* const_iterator;
+
+  ArrayView() : _begin(nullptr), _end(nullptr) {}
+
+  ArrayView(T* begin, T* end) : _begin(begin), _end(end) {}
+
+  /** @brief a writable view is also a read-only view */
+  template <typename U>
+  ArrayView(const ArrayView<U>& other)
+      : _begin(other.begin()), _end(other.end()) {}
+
+ public:
+  T* begin() const { return _begin; }
+
+  T* end() const { return _end; }
+
+  T* data() const { return _begin; }
+
+  size_t size() const { return _end - _begin; }
+
+  bool empty() const { return _begin == _end; }
+
+  T& operator[](size_t i) const {
+    assert(i < size());
+    return _begin[i];
+  }
+
+  T& front() const { return *_begin; }
+
+  T& back() const { return *(_end - 1); }
+
+  /** @brief copy the elements into a vector */
+  template <typename U = typename std::remove_const<T>::type>
+  std::vector<U> to_vector() const {
+    return std::vector<U>(_begin, _end);
+  }
+
+  /** @brief element-wise comparison */
+  template <typename U>
+  bool operator==(const ArrayView<U>& other) const {
+    return size() == other.size() && std::equal(_begin, _end, other.begin());
+  }
+
+  template <typename U>
+  bool operator!=(const ArrayView<U>& other) const {
+    return !(*this == other);
+  }
+
+ private:
+  T* _begin;
+  T* _end;
+};
+
+}  // namespace CMTL
+
+#endif  // __common_array_view_h__
@@ -0,0 +1,42 @@
+#ifndef __common_parallel_h__
+#define __common_parallel_h__
+
+#include <algorithm>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Computational Mathematics Tool Library
+ */
+namespace CMTL {
+
+/**
+ * @brief number of threads worth using for n items, at least grain items per
+ * thread
+ */
+inline unsigned default_threads(size_t n, size_t grain = 1 << 16) {
+  size_t n_threads = std::max(std::thread::hardware_concurrency(), 1u);
+  return static_cast<unsigned>(std::min(n_threads, n / grain + 1));
+}
+
+/**
+ * @brief split [0, n) into n_threads contiguous ranges and run job(begin,
+ * end) on each of them in its own thread, the calling thread runs the first
+ * range
+ */
+template <typename Job>
+void parallel_for(size_t n, unsigned n_threads, const Job& job) {
+  n_threads = static_cast<unsigned>(
+      std::max<size_t>(std::min<size_t>(n_threads, n), 1));
+  std::vector<std::thread> threads;
+  threads.reserve(n_threads - 1);
+  for (unsigned i = 1; i < n_threads; ++i)
+    threads.emplace_back(job, n * i / n_threads, n * (i + 1) / n_threads);
+  job(size_t(0), n / n_threads);
+  for (std::thread& thread : threads) thread.join();
+}
+
+}  // namespace CMTL
+
+#endif  // __common_parallel_h__
@@ -0,0 +1,45 @@
+#ifndef __common_radix_sort_h__
+#define __common_radix_sort_h__
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Computational Mathematics Tool Library
+ */
+namespace CMTL {
+
+/**
+ * @brief stable least significant digit radix sort of items by an unsigned
+ * integer key, 8 bits per pass, passes on which all the keys share the same
+ * digit are skipped
+ * @param items items to sort
+ * @param key function returning the uint64_t key of an item
+ * @param n_bits only the lowest n_bits of the keys are compared
+ */
+template <typename T, typename Key>
+void radix_sort(std::vector<T>& items, const Key& key, unsigned n_bits = 64) {
+  if (items.size() < 2) return;
+  std::vector<T> buffer(items.size());
+  size_t count[256];
+  for (unsigned shift = 0; shift < n_bits; shift += 8) {
+    std::fill(count, count + 256, 0);
+    for (const T& item : items) ++count[(key(item) >> shift) & 0xff];
+    if (count[(key(items[0]) >> shift) & 0xff] == items.size()) continue;
+    size_t sum = 0;
+    for (unsigned d = 0; d < 256; ++d) {
+      size_t n = count[d];
+      count[d] = sum;
+      sum += n;
+    }
+    for (const T& item : items)
+      buffer[count[(key(item) >> shift) & 0xff]++] = item;
+    items.swap(buffer);
+  }
+}
+
+}  // namespace CMTL
+
+#endif  // __common_radix_sort_h__
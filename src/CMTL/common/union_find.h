@@ -0,0 +1,123 @@
+#ifndef __common_union_find_h__
+#define __common_union_find_h__
+
+#include <atomic>
+#include <memory>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Computational Mathematics Tool Library
+ */
+namespace CMTL {
+
+/**
+ * @brief disjoint sets of integer elements with path halving and union by
+ * index, the root of a set is its smallest element
+ */
+class UnionFind {
+ public:
+  explicit UnionFind(unsigned n = 0) { reset(n); }
+
+ public:
+  /** @brief make n singleton sets */
+  void reset(unsigned n) {
+    _parent.resize(n);
+    std::iota(_parent.begin(), _parent.end(), 0u);
+  }
+
+  /** @brief number of elements */
+  unsigned size() const { return _parent.size(); }
+
+  /** @brief root of the set containing i */
+  unsigned find(unsigned i) {
+    while (_parent[i] != i) {
+      _parent[i] = _parent[_parent[i]];
+      i = _parent[i];
+    }
+    return i;
+  }
+
+  /**
+   * @brief merge the sets containing i and j
+   * @return false if they are already in the same set
+   */
+  bool unite(unsigned i, unsigned j) {
+    i = find(i);
+    j = find(j);
+    if (i == j) return false;
+    // the smaller root survives, so roots do not depend on the union order
+    if (i < j)
+      _parent[j] = i;
+    else
+      _parent[i] = j;
+    return true;
+  }
+
+ private:
+  std::vector<unsigned> _parent;
+};
+
+/**
+ * @brief lock-free union-find which can be shared by several threads, roots
+ * are linked with compare-and-swap, the root of a set is its smallest element
+ * so the final sets do not depend on the thread interleaving
+ */
+class ConcurrentUnionFind {
+ public:
+  explicit ConcurrentUnionFind(unsigned n = 0) { reset(n); }
+
+ public:
+  /** @brief make n singleton sets, not thread safe */
+  void reset(unsigned n) {
+    _parent.reset(new std::atomic<unsigned>[n]);
+    _size = n;
+    for (unsigned i = 0; i < n; ++i)
+      _parent[i].store(i, std::memory_order_relaxed);
+  }
+
+  /** @brief number of elements */
+  unsigned size() const { return _size; }
+
+  /** @brief root of the set containing i */
+  unsigned find(unsigned i) {
+    unsigned parent = _parent[i].load(std::memory_order_relaxed);
+    while (parent != i) {
+      // path halving, losing the race only skips a shortcut
+      unsigned grand = _parent[parent].load(std::memory_order_relaxed);
+      _parent[i].compare_exchange_weak(parent, grand,
+                                       std::memory_order_relaxed);
+      i = parent;
+      parent = _parent[i].load(std::memory_order_relaxed);
+    }
+    return i;
+  }
+
+  /**
+   * @brief merge the sets containing i and j
+   * @return false if they are already in the same set
+   */
+  bool unite(unsigned i, unsigned j) {
+    while (true) {
+      i = find(i);
+      j = find(j);
+      if (i == j) return false;
+      if (i < j) std::swap(i, j);
+      // link the larger root under the smaller one, retry if i is no longer
+      // a root
+      unsigned expected = i;
+      if (_parent[i].compare_exchange_strong(expected, j,
+                                             std::memory_order_relaxed))
+        return true;
+    }
+  }
+
+ private:
+  std::unique_ptr<std::atomic<unsigned>[]> _parent;
+  unsigned _size = 0;
+};
+
+}  // namespace CMTL
+
+#endif  // __common_union_find_h__
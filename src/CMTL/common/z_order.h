@@ -0,0 +1,57 @@
+#ifndef __common_z_order_h__
+#define __common_z_order_h__
+
+#include <cstdint>
+
+/**
+ * @brief Computational Mathematics Tool Library
+ */
+namespace CMTL {
+
+/**
+ * @brief z-order (morton) code of a cell of a 65536 x 65536 grid, which
+ * interleaves the bits of its two 16 bits coordinates
+ * @note the cells of a box have codes between the codes of its lower and
+ * upper corners
+ */
+inline std::uint32_t z_order_2d(std::uint32_t x, std::uint32_t y) {
+  x = (x | (x << 8)) & 0x00FF00FF;
+  x = (x | (x << 4)) & 0x0F0F0F0F;
+  x = (x | (x << 2)) & 0x33333333;
+  x = (x | (x << 1)) & 0x55555555;
+  y = (y | (y << 8)) & 0x00FF00FF;
+  y = (y | (y << 4)) & 0x0F0F0F0F;
+  y = (y | (y << 2)) & 0x33333333;
+  y = (y | (y << 1)) & 0x55555555;
+  return x | (y << 1);
+}
+
+/**
+ * @brief smallest z-order code above code in the box of the cells between the
+ * codes lo and hi, or 0 if none (Tropf and Herzog's BIGMIN)
+ */
+inline std::uint32_t z_order_2d_next(std::uint32_t code, std::uint32_t lo,
+                                     std::uint32_t hi) {
+  std::uint32_t result = 0;
+  for (int bit = 31; bit >= 0; --bit) {
+    std::uint32_t mask = std::uint32_t(1) << bit;
+    // lower bits of the same coordinate
+    std::uint32_t lower = (0x55555555u << (bit & 1)) & (mask - 1);
+    bool c = code & mask, l = lo & mask, h = hi & mask;
+    if (!c && !l && h) {
+      result = (lo | mask) & ~lower;
+      hi = (hi & ~mask) | lower;
+    } else if (!c && l && h) {
+      return lo;
+    } else if (c && !l && !h) {
+      return result;
+    } else if (c && !l && h) {
+      lo = (lo | mask) & ~lower;
+    }
+  }
+  return result;
+}
+
+}  // namespace CMTL
+
+#endif  // __common_z_order_h__
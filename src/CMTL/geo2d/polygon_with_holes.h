@@ -0,0 +1,114 @@
+#ifndef __geo2d_polygon_with_holes_h__
+#define __geo2d_polygon_with_holes_h__
+
+#include "polygon.h"
+
+#include <vector>
+
+namespace CMTL {
+namespace geo2d {
+
+/**
+ * @brief 2 dimension polygon with holes
+ * @tparam T number type of point coordinate
+ * @note the holes are simple polygons strictly inside the outer polygon and
+ * disjoint from each other, the orientation of each ring does not matter
+ */
+template <typename T>
+class PolygonWithHoles {
+ public:
+  /**
+   * @brief float type
+   */
+  typedef T FT;
+
+ public:
+  PolygonWithHoles() = default;
+
+  /**
+   * @brief construct from the outer polygon and the holes
+   */
+  PolygonWithHoles(const Polygon<T>& outer,
+                   const std::vector<Polygon<T>>& holes = {})
+      : _outer(outer), _holes(holes) {}
+
+  ~PolygonWithHoles() = default;
+
+ public:
+  /**
+   * @brief get the outer polygon
+   */
+  const Polygon<T>& outer() const { return _outer; }
+
+  /**
+   * @brief get the writable outer polygon
+   */
+  Polygon<T>& outer() { return _outer; }
+
+  /**
+   * @brief return the number of holes
+   */
+  size_t n_holes() const { return _holes.size(); }
+
+  /**
+   * @brief get the const ith hole
+   */
+  const Polygon<T>& hole(unsigned int i) const {
+    assert(i < _holes.size());
+    return _holes[i];
+  }
+
+  /**
+   * @brief add a hole
+   */
+  void add_hole(const Polygon<T>& hole) { _holes.push_back(hole); }
+
+  /**
+   * @brief return the number of points of the outer polygon and the holes
+   */
+  size_t n_points() const {
+    size_t result = _outer.size();
+    for (const Polygon<T>& hole : _holes) result += hole.size();
+    return result;
+  }
+
+ public:
+  /**
+   * @brief get the area of the outer polygon minus the areas of the holes
+   */
+  T area() const;
+
+ public:
+  friend std::ostream& operator<<(std::ostream& os,
+                                  const PolygonWithHoles& poly) {
+    os << "{ " << poly._outer;
+    for (const Polygon<T>& hole : poly._holes) {
+      os << " " << hole;
+    }
+    os << " }";
+    return os;
+  }
+
+ private:
+  Polygon<T> _outer;
+  std::vector<Polygon<T>> _holes;
+};
+
+/* Implementation */
+
+template <typename T>
+T PolygonWithHoles<T>::area() const {
+  T result = _outer.area();
+  if (result < 0) result = -result;
+  for (const Polygon<T>& hole : _holes) {
+    T hole_area = hole.area();
+    if (hole_area < 0) hole_area = -hole_area;
+    result -= hole_area;
+  }
+  return result;
+}
+
+}  // namespace geo2d
+}  // namespace CMTL
+
+#endif  // __geo2d_polygon_with_holes_h__
@@ -19,6 +19,8 @@ class PSLG {
   std::vector<geo2d::Point<T>> _points;
   std::vector<std::pair<unsigned, unsigned>> _segments;
   std::vector<int> _segmentmarks;
+  /* a point inside each hole */
+  std::vector<geo2d::Point<T>> _holes;
 };
 
 }  // namespace geo2d
@@ -0,0 +1,139 @@
+#ifndef __geo3d_box_h__
+#define __geo3d_box_h__
+
+#include "point.h"
+
+#include <utility>
+
+namespace CMTL {
+namespace geo3d {
+
+/**
+ * @brief 3 dimension axis-aligned box
+ * @tparam T number type of point coordinate
+ */
+template <typename T>
+class Box {
+ public:
+  /**
+   * @brief float type
+   */
+  typedef T FT;
+
+ public:
+  Box() = default;
+
+  /**
+   * @brief construct from two opposite corner points
+   */
+  Box(const Point<T>& p0, const Point<T>& p1) : _min(p0), _max(p1) {
+    // check
+    for (unsigned i = 0; i < 3; ++i)
+      if (_min[i] > _max[i]) std::swap(_min[i], _max[i]);
+  }
+
+  ~Box() = default;
+
+ public:
+  /**
+   * @brief get the writable corner with minimal coordinates
+   */
+  Point<T>& min_corner() { return _min; }
+
+  /**
+   * @brief get the const corner with minimal coordinates
+   */
+  const Point<T>& min_corner() const { return _min; }
+
+  /**
+   * @brief get the writable corner with maximal coordinates
+   */
+  Point<T>& max_corner() { return _max; }
+
+  /**
+   * @brief get the const corner with maximal coordinates
+   */
+  const Point<T>& max_corner() const { return _max; }
+
+  /**
+   * @brief get the length along x-axis
+   */
+  T length() const { return _max.x() - _min.x(); }
+
+  /**
+   * @brief get the width along y-axis
+   */
+  T width() const { return _max.y() - _min.y(); }
+
+  /**
+   * @brief get the height along z-axis
+   */
+  T height() const { return _max.z() - _min.z(); }
+
+  /**
+   * @brief return the surface area of the box
+   */
+  T area() const {
+    return T(2) * (length() * width() + width() * height() +
+                   height() * length());
+  }
+
+  /**
+   * @brief return the volume of the box
+   */
+  T volume() const { return length() * width() * height(); }
+
+  /**
+   * @brief return the center of the box
+   */
+  Point<T> center() const { return (_min + _max) / T(2); }
+
+  /**
+   * @brief enlarge the box to contain a point
+   */
+  void extend(const Point<T>& p) {
+    for (unsigned i = 0; i < 3; ++i) {
+      if (p[i] < _min[i]) _min[i] = p[i];
+      if (p[i] > _max[i]) _max[i] = p[i];
+    }
+  }
+
+  /**
+   * @brief enlarge the box to contain another box
+   */
+  void extend(const Box& other) {
+    extend(other._min);
+    extend(other._max);
+  }
+
+  /**
+   * @brief check whether a point is inside the box or on its boundary
+   */
+  bool contains(const Point<T>& p) const {
+    for (unsigned i = 0; i < 3; ++i)
+      if (p[i] < _min[i] || p[i] > _max[i]) return false;
+    return true;
+  }
+
+  /**
+   * @brief check whether two boxes share a point
+   */
+  bool overlap(const Box& other) const {
+    for (unsigned i = 0; i < 3; ++i)
+      if (other._max[i] < _min[i] || _max[i] < other._min[i]) return false;
+    return true;
+  }
+
+  friend std::ostream& operator<<(std::ostream& os, const Box& box) {
+    os << "[" << box._min << ", " << box._max << "]";
+    return os;
+  }
+
+ private:
+  Point<T> _min, _max;
+};
+
+}  // namespace geo3d
+}  // namespace CMTL
+
+#endif  // __geo3d_box_h__
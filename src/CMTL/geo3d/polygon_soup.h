@@ -1,8 +1,13 @@
 #ifndef __geo3d_polygon_soup_h__
 #define __geo3d_polygon_soup_h__
 
+#include "../common/array_view.h"
 #include "point.h"
 
+#include <cassert>
+#include <initializer_list>
+#include <iterator>
+#include <utility>
 #include <vector>
 
 namespace CMTL {
@@ -35,13 +40,41 @@ class PolygonSoup {
     for (auto v_it = points.begin(); v_it != points.end(); ++v_it) {
       _vertices.emplace_back((*v_it)[0], (*v_it)[1], (*v_it)[2]);
     }
+    // count the indices first to fill the flat storage at once
+    size_t n_polygons = 0, n_indices = 0;
     for (auto f_it = polygons.begin(); f_it != polygons.end(); ++f_it) {
-      _polygons.emplace_back(f_it->begin(), f_it->end());
+      ++n_polygons;
+      n_indices += std::distance(f_it->begin(), f_it->end());
+    }
+    _offsets.reserve(n_polygons + 1);
+    _indices.reserve(n_indices);
+    for (auto f_it = polygons.begin(); f_it != polygons.end(); ++f_it) {
+      add_polygon(*f_it);
     }
   }
 
+  /**
+   * @brief construct from flat polygon storage, polygon i is made of
+   * indices[offsets[i], offsets[i + 1])
+   * @note offsets must start with 0 and end with indices.size()
+   */
+  PolygonSoup(std::vector<Point<T>> points, std::vector<unsigned> offsets,
+              std::vector<unsigned> indices)
+      : _vertices(std::move(points)),
+        _offsets(std::move(offsets)),
+        _indices(std::move(indices)) {
+    assert(!_offsets.empty() && _offsets.front() == 0 &&
+           _offsets.back() == _indices.size());
+  }
+
   PolygonSoup(const PolygonSoup& other) = default;
 
+  PolygonSoup(PolygonSoup&& other) = default;
+
+  PolygonSoup& operator=(const PolygonSoup& other) = default;
+
+  PolygonSoup& operator=(PolygonSoup&& other) = default;
+
   ~PolygonSoup() = default;
 
  public:
@@ -53,7 +86,7 @@ class PolygonSoup {
   /**
    * @brief return the number of polygons
    */
-  size_t n_polygons() const { return _polygons.size(); }
+  size_t n_polygons() const { return _offsets.size() - 1; }
 
   /**
    * @brief get the ith point
@@ -65,10 +98,107 @@ class PolygonSoup {
    */
   const Point<T>& point(unsigned i) const { return _vertices[i]; }
 
+  /**
+   * @brief get all points
+   */
+  const std::vector<Point<T>>& points() const { return _vertices; }
+
+  /**
+   * @brief get the ith polygon, the vertices can be modified but not the
+   * size
+   */
+  ArrayView<unsigned> polygon(unsigned i) {
+    return ArrayView<unsigned>(_indices.data() + _offsets[i],
+                               _indices.data() + _offsets[i + 1]);
+  }
+
+  /**
+   * @brief get the const ith polygon
+   */
+  ArrayView<const unsigned> polygon(unsigned i) const {
+    return ArrayView<const unsigned>(_indices.data() + _offsets[i],
+                                     _indices.data() + _offsets[i + 1]);
+  }
+
+  /**
+   * @brief polygon i is made of indices()[offsets()[i], offsets()[i + 1])
+   */
+  const std::vector<unsigned>& offsets() const { return _offsets; }
+
+  /**
+   * @brief vertex indices of all polygons
+   */
+  const std::vector<unsigned>& indices() const { return _indices; }
+
+  /**
+   * @brief reserve storage for points, polygons and their vertex indices
+   */
+  void reserve(size_t n_points, size_t n_polygons, size_t n_indices) {
+    _vertices.reserve(n_points);
+    _offsets.reserve(n_polygons + 1);
+    _indices.reserve(n_indices);
+  }
+
+  /**
+   * @brief add a point
+   * @return index of the point
+   */
+  unsigned add_point(const Point<T>& p) {
+    _vertices.push_back(p);
+    return _vertices.size() - 1;
+  }
+
+  /**
+   * @brief add a polygon from a container of vertex indices
+   * @return index of the polygon
+   */
+  template <class IndexRange>
+  unsigned add_polygon(const IndexRange& polygon) {
+    _indices.insert(_indices.end(), polygon.begin(), polygon.end());
+    _offsets.push_back(_indices.size());
+    return _offsets.size() - 2;
+  }
+
+  /**
+   * @brief add a polygon from a list of vertex indices
+   * @return index of the polygon
+   */
+  unsigned add_polygon(std::initializer_list<unsigned> polygon) {
+    return add_polygon<std::initializer_list<unsigned>>(polygon);
+  }
+
+  /**
+   * @brief add a triangle
+   * @return index of the triangle
+   */
+  unsigned add_triangle(unsigned v0, unsigned v1, unsigned v2) {
+    _indices.push_back(v0);
+    _indices.push_back(v1);
+    _indices.push_back(v2);
+    _offsets.push_back(_indices.size());
+    return _offsets.size() - 2;
+  }
+
+  /**
+   * @brief add polygons of the same size from a flat array of indices
+   * @param indices n * size vertex indices
+   * @param n number of polygons
+   * @param size number of vertices of each polygon
+   */
+  void add_polygons(const unsigned* indices, size_t n, unsigned size) {
+    size_t first = _indices.size();
+    _indices.insert(_indices.end(), indices, indices + n * size);
+    _offsets.reserve(_offsets.size() + n);
+    for (size_t i = 1; i <= n; ++i) _offsets.push_back(first + i * size);
+  }
+
  private:
   std::vector<Point<T>> _vertices;
 
-  std::vector<std::vector<unsigned>> _polygons;
+  /* polygon i is made of _indices[_offsets[i], _offsets[i + 1]) */
+  std::vector<unsigned> _offsets = std::vector<unsigned>(1, 0);
+
+  std::vector<unsigned> _indices;
 };
 
 /* Implementation */
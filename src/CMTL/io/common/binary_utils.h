@@ -0,0 +1,43 @@
+#ifndef __io_common_binary_utils__
+#define __io_common_binary_utils__
+
+#include "output_buffer.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+namespace CMTL {
+namespace io {
+namespace internal {
+
+inline bool is_little_endian() {
+  const uint16_t one = 1;
+  return *reinterpret_cast<const unsigned char*>(&one) == 1;
+}
+
+/* read a little endian value at p */
+template <typename V>
+V read_little_endian(const char* p) {
+  char bytes[sizeof(V)];
+  std::memcpy(bytes, p, sizeof(V));
+  if (!is_little_endian()) std::reverse(bytes, bytes + sizeof(V));
+  V v;
+  std::memcpy(&v, bytes, sizeof(V));
+  return v;
+}
+
+/* append a value in little endian */
+template <typename V>
+void write_little_endian(OutputBuffer& fout, V v) {
+  char bytes[sizeof(V)];
+  std::memcpy(bytes, &v, sizeof(V));
+  if (!is_little_endian()) std::reverse(bytes, bytes + sizeof(V));
+  fout.write(bytes, sizeof(V));
+}
+
+}  // namespace internal
+}  // namespace io
+}  // namespace CMTL
+
+#endif  // __io_common_binary_utils__
@@ -0,0 +1,544 @@
+#ifndef __io_common_cmesh_format__
+#define __io_common_cmesh_format__
+
+#include "../../common/attributes.h"
+#include "../../topology/halfedge.h"
+
+#include <any>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <set>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace CMTL {
+namespace io {
+namespace internal {
+
+/*
+ * .cmesh is a native binary dump of a halfedge graph: a fixed header followed
+ * by the raw element arrays, the vertex coordinates, the trivially copyable
+ * attributes and a directory of the named attributes (Attributes<> entries of
+ * scalar type) with their names, values and presence flags. Each section
+ * starts at a 64 bytes aligned offset and is stored in the byte order of the
+ * writer.
+ */
+
+/* sections of a .cmesh file, in file order */
+enum CmeshSection {
+  CMESH_VERTICES = 0,
+  CMESH_EDGES,
+  CMESH_FACES,
+  CMESH_POINTS,
+  CMESH_VERTEX_ATTRIBUTES,
+  CMESH_HALFEDGE_ATTRIBUTES,
+  CMESH_EDGE_ATTRIBUTES,
+  CMESH_FACE_ATTRIBUTES,
+  CMESH_PROPERTIES,
+  CMESH_N_SECTIONS
+};
+
+struct CmeshSectionEntry {
+  uint64_t offset;
+  uint64_t count;
+  uint32_t item_size;
+  uint32_t reserved;
+};
+
+struct CmeshHeader {
+  char magic[8];
+  uint32_t version;
+  /* 0x01020304 in the byte order of the writer */
+  uint32_t byte_order;
+  uint32_t dimension;
+  /* size of a coordinate, and 1 if it is a floating point number */
+  uint32_t scalar_size;
+  uint32_t scalar_is_float;
+  uint32_t reserved;
+  CmeshSectionEntry sections[CMESH_N_SECTIONS];
+};
+
+static const char CMESH_MAGIC[8] = {'C', 'M', 'T', 'L', 'M', 'S', 'H', '\0'};
+static const uint32_t CMESH_VERSION = 2;
+static const uint32_t CMESH_BYTE_ORDER = 0x01020304;
+static const uint64_t CMESH_ALIGNMENT = 64;
+
+/* round an offset up to the section alignment */
+inline uint64_t align_cmesh_offset(uint64_t offset) {
+  return (offset + CMESH_ALIGNMENT - 1) / CMESH_ALIGNMENT * CMESH_ALIGNMENT;
+}
+
+/* a named attribute of the elements of one kind, the elements which do not
+ * have it are zero with a zero presence flag */
+struct CmeshPropertyEntry {
+  /* CMESH_VERTEX_ATTRIBUTES to CMESH_FACE_ATTRIBUTES */
+  uint32_t section;
+  /* index of the value type in CmeshPropertyTypes */
+  uint32_t type;
+  uint64_t count;
+  uint64_t name_offset;
+  uint64_t name_size;
+  uint64_t values_offset;
+  uint64_t flags_offset;
+};
+
+/* value types of the named attributes which are written */
+typedef std::tuple<bool, char, int8_t, uint8_t, int16_t, uint16_t, int32_t,
+                   uint32_t, int64_t, uint64_t, float, double>
+    CmeshPropertyTypes;
+
+/* call f with a value of the type of the given index, not at all if the index
+ * is out of range */
+template <size_t I = 0, typename F>
+void visit_cmesh_property_type(uint32_t type, F&& f) {
+  if constexpr (I < std::tuple_size<CmeshPropertyTypes>::value) {
+    if (type == I)
+      f(typename std::tuple_element<I, CmeshPropertyTypes>::type());
+    else
+      visit_cmesh_property_type<I + 1>(type, f);
+  }
+}
+
+/* index of a value type in CmeshPropertyTypes, -1 if it is not written */
+template <size_t I = 0>
+int cmesh_property_type(const std::type_info& type) {
+  if constexpr (I < std::tuple_size<CmeshPropertyTypes>::value) {
+    typedef typename std::tuple_element<I, CmeshPropertyTypes>::type Value;
+    if (type == typeid(Value)) return I;
+    return cmesh_property_type<I + 1>(type);
+  } else {
+    return -1;
+  }
+}
+
+template <typename Attribute>
+struct is_cmesh_named_attributes : std::false_type {};
+
+template <>
+struct is_cmesh_named_attributes<Attributes<std::string>> : std::true_type {};
+
+/* number of attributes which can be dumped, 0 if not trivially copyable */
+template <typename Attribute>
+uint64_t cmesh_attribute_count(const std::vector<Attribute>& attributes) {
+  return std::is_trivially_copyable<Attribute>::value ? attributes.size() : 0;
+}
+
+/* a named attribute gathered for writing */
+struct CmeshProperty {
+  CmeshPropertyEntry entry;
+  std::string name;
+  std::vector<char> values;
+  std::vector<char> flags;
+};
+
+/* gather the named attributes of the elements of one kind, the attributes
+ * which cannot be written are reported */
+template <typename Attribute>
+void collect_cmesh_properties(const std::vector<Attribute>& attributes,
+                              uint32_t section,
+                              std::vector<CmeshProperty>& properties) {
+  if constexpr (is_cmesh_named_attributes<Attribute>::value) {
+    std::map<std::pair<std::string, int>, size_t> index;
+    std::set<std::string> dropped;
+    for (size_t i = 0; i < attributes.size(); ++i) {
+      for (const auto& item : attributes[i]) {
+        if (!item.second.has_value()) continue;
+        int type = cmesh_property_type(item.second.type());
+        if (type < 0) {
+          dropped.insert(item.first);
+          continue;
+        }
+        auto it = index.find({item.first, type});
+        if (it == index.end()) {
+          it = index.emplace(std::make_pair(item.first, type),
+                             properties.size()).first;
+          CmeshProperty property;
+          std::memset(&property.entry, 0, sizeof(property.entry));
+          property.entry.section = section;
+          property.entry.type = type;
+          property.entry.count = attributes.size();
+          property.name = item.first;
+          visit_cmesh_property_type(type, [&](auto value) {
+            property.values.assign(attributes.size() * sizeof(value), 0);
+          });
+          property.flags.assign(attributes.size(), 0);
+          properties.push_back(std::move(property));
+        }
+        CmeshProperty& property = properties[it->second];
+        visit_cmesh_property_type(type, [&](auto value) {
+          typedef decltype(value) Value;
+          std::memcpy(&property.values[i * sizeof(Value)],
+                      std::any_cast<Value>(&item.second), sizeof(Value));
+        });
+        property.flags[i] = 1;
+      }
+    }
+    for (const std::string& name : dropped)
+      std::cerr << "warning: attribute " << name
+                << " has a value type which cmesh does not store." << std::endl;
+  } else if constexpr (!std::is_trivially_copyable<Attribute>::value) {
+    if (!attributes.empty())
+      std::cerr << "warning: cmesh does not store attributes which are not "
+                   "trivially copyable."
+                << std::endl;
+  }
+}
+
+/**
+ * @brief dump a halfedge graph into .cmesh format, the Attributes<> entries
+ * of scalar type are written as named attributes, the other attributes which
+ * are not trivially copyable are reported and not written
+ * @param graph halfedge graph with points of arithmetic coordinates
+ * @param out target stream, should be opened in binary mode
+ */
+template <typename Graph>
+void write_cmesh(const Graph& graph, std::ostream& out) {
+  typedef typename Graph::FT Scalar;
+  typedef typename Graph::Point Point;
+  static_assert(std::is_arithmetic<Scalar>::value,
+                ".cmesh only stores arithmetic coordinates");
+  const unsigned dim = Point::dimension();
+
+  // points have a virtual table, coordinates are copied out
+  std::vector<Scalar> coords;
+  coords.reserve(dim * graph.points().size());
+  for (const Point& p : graph.points())
+    for (unsigned k = 0; k < dim; ++k) coords.push_back(p[k]);
+
+  std::vector<CmeshProperty> properties;
+  collect_cmesh_properties(graph.vertex_attributes(), CMESH_VERTEX_ATTRIBUTES,
+                           properties);
+  collect_cmesh_properties(graph.halfedge_attributes(),
+                           CMESH_HALFEDGE_ATTRIBUTES, properties);
+  collect_cmesh_properties(graph.edge_attributes(), CMESH_EDGE_ATTRIBUTES,
+                           properties);
+  collect_cmesh_properties(graph.face_attributes(), CMESH_FACE_ATTRIBUTES,
+                           properties);
+  std::vector<CmeshPropertyEntry> directory(properties.size());
+
+  const void* data[CMESH_N_SECTIONS] = {
+      graph.vertex_items().data(),        graph.edge_items().data(),
+      graph.face_items().data(),          coords.data(),
+      graph.vertex_attributes().data(),   graph.halfedge_attributes().data(),
+      graph.edge_attributes().data(),     graph.face_attributes().data(),
+      directory.data()};
+  uint64_t counts[CMESH_N_SECTIONS] = {
+      graph.n_vertices(),
+      graph.n_edges(),
+      graph.n_faces(),
+      graph.points().size(),
+      cmesh_attribute_count(graph.vertex_attributes()),
+      cmesh_attribute_count(graph.halfedge_attributes()),
+      cmesh_attribute_count(graph.edge_attributes()),
+      cmesh_attribute_count(graph.face_attributes()),
+      properties.size()};
+  uint32_t item_sizes[CMESH_N_SECTIONS] = {
+      sizeof(halfedge::VertexItem),
+      sizeof(halfedge::EdgeItem),
+      sizeof(halfedge::FaceItem),
+      static_cast<uint32_t>(dim * sizeof(Scalar)),
+      sizeof(typename Graph::VertexAttribute),
+      sizeof(typename Graph::HalfedgeAttribute),
+      sizeof(typename Graph::EdgeAttribute),
+      sizeof(typename Graph::FaceAttribute),
+      sizeof(CmeshPropertyEntry)};
+
+  CmeshHeader header;
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.magic, CMESH_MAGIC, sizeof(CMESH_MAGIC));
+  header.version = CMESH_VERSION;
+  header.byte_order = CMESH_BYTE_ORDER;
+  header.dimension = dim;
+  header.scalar_size = sizeof(Scalar);
+  header.scalar_is_float = std::is_floating_point<Scalar>::value;
+  uint64_t offset = sizeof(header);
+  for (unsigned i = 0; i < CMESH_N_SECTIONS; ++i) {
+    offset = align_cmesh_offset(offset);
+    header.sections[i].offset = offset;
+    header.sections[i].count = counts[i];
+    header.sections[i].item_size = item_sizes[i];
+    offset += counts[i] * item_sizes[i];
+  }
+  for (size_t i = 0; i < properties.size(); ++i) {
+    CmeshProperty& property = properties[i];
+    property.entry.name_offset = align_cmesh_offset(offset);
+    property.entry.name_size = property.name.size();
+    offset = property.entry.name_offset + property.name.size();
+    property.entry.values_offset = align_cmesh_offset(offset);
+    offset = property.entry.values_offset + property.values.size();
+    property.entry.flags_offset = align_cmesh_offset(offset);
+    offset = property.entry.flags_offset + property.flags.size();
+    directory[i] = property.entry;
+  }
+
+  static const char zeros[CMESH_ALIGNMENT] = {};
+  out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  offset = sizeof(header);
+  auto write_block = [&](uint64_t block_offset, const void* block,
+                         uint64_t size) {
+    out.write(zeros, block_offset - offset);
+    out.write(static_cast<const char*>(block), size);
+    offset = block_offset + size;
+  };
+  for (unsigned i = 0; i < CMESH_N_SECTIONS; ++i) {
+    write_block(header.sections[i].offset, data[i], counts[i] * item_sizes[i]);
+  }
+  for (const CmeshProperty& property : properties) {
+    write_block(property.entry.name_offset, property.name.data(),
+                property.name.size());
+    write_block(property.entry.values_offset, property.values.data(),
+                property.values.size());
+    write_block(property.entry.flags_offset, property.flags.data(),
+                property.flags.size());
+  }
+}
+
+/* check that a section lies in the file and has the expected item size */
+inline bool check_cmesh_section(const CmeshSectionEntry& entry,
+                                uint32_t item_size, uint64_t file_size) {
+  if (entry.count == 0) return true;
+  return entry.item_size == item_size && entry.offset % CMESH_ALIGNMENT == 0 &&
+         entry.offset <= file_size &&
+         entry.count <= (file_size - entry.offset) / item_size;
+}
+
+/* load an attribute section, the attributes are grown with the handle based
+ * setter so that the storage is allocated at once */
+template <typename Attribute, typename Graph, typename Handle>
+bool read_cmesh_attributes(Graph& graph, const char* begin,
+                           const CmeshSectionEntry& entry, uint64_t file_size,
+                           uint64_t n_elements) {
+  if (entry.count == 0) return true;
+  if constexpr (std::is_trivially_copyable<Attribute>::value) {
+    if (!check_cmesh_section(entry, sizeof(Attribute), file_size) ||
+        entry.count > n_elements)
+      return false;
+    Attribute* data = &graph.attribute(Handle(entry.count - 1)) -
+                      (entry.count - 1);
+    std::memcpy(data, begin + entry.offset, entry.count * sizeof(Attribute));
+    return true;
+  } else {
+    return false;
+  }
+}
+
+/* load a named attribute of the elements of one kind */
+template <typename Attribute, typename Graph, typename Handle>
+bool read_cmesh_property(Graph& graph, const char* begin,
+                         const CmeshPropertyEntry& entry, uint64_t file_size,
+                         uint64_t n_elements) {
+  if constexpr (is_cmesh_named_attributes<Attribute>::value) {
+    if (entry.count > n_elements || entry.name_offset > file_size ||
+        entry.name_size > file_size - entry.name_offset ||
+        entry.flags_offset > file_size ||
+        entry.count > file_size - entry.flags_offset)
+      return false;
+    std::string name(begin + entry.name_offset, entry.name_size);
+    const char* flags = begin + entry.flags_offset;
+    bool ok = false;
+    visit_cmesh_property_type(entry.type, [&](auto value) {
+      typedef decltype(value) Value;
+      if (entry.values_offset > file_size ||
+          entry.count > (file_size - entry.values_offset) / sizeof(Value))
+        return;
+      const char* values = begin + entry.values_offset;
+      // allocate all attributes at once
+      if (entry.count > 0) graph.attribute(Handle(entry.count - 1));
+      for (uint64_t i = 0; i < entry.count; ++i) {
+        if (!flags[i]) continue;
+        if constexpr (std::is_same<Value, bool>::value) {
+          value = values[i] != 0;
+        } else {
+          std::memcpy(&value, values + i * sizeof(Value), sizeof(Value));
+        }
+        graph.attribute(Handle(i)).template set<Value>(name) = value;
+      }
+      ok = true;
+    });
+    return ok;
+  } else {
+    return false;
+  }
+}
+
+/* load the named attributes listed in the directory section */
+template <typename Graph>
+bool read_cmesh_properties(Graph& graph, const char* begin,
+                           const CmeshSectionEntry& section,
+                           uint64_t file_size) {
+  if (section.count == 0) return true;
+  if (!check_cmesh_section(section, sizeof(CmeshPropertyEntry), file_size))
+    return false;
+  typedef typename Graph::VertexHandle VertexHandle;
+  typedef typename Graph::HalfedgeHandle HalfedgeHandle;
+  typedef typename Graph::EdgeHandle EdgeHandle;
+  typedef typename Graph::FaceHandle FaceHandle;
+  for (uint64_t k = 0; k < section.count; ++k) {
+    CmeshPropertyEntry entry;
+    std::memcpy(&entry, begin + section.offset + k * sizeof(entry),
+                sizeof(entry));
+    bool ok = false;
+    switch (entry.section) {
+      case CMESH_VERTEX_ATTRIBUTES:
+        ok = read_cmesh_property<typename Graph::VertexAttribute, Graph,
+                                 VertexHandle>(graph, begin, entry, file_size,
+                                               graph.n_vertices());
+        break;
+      case CMESH_HALFEDGE_ATTRIBUTES:
+        ok = read_cmesh_property<typename Graph::HalfedgeAttribute, Graph,
+                                 HalfedgeHandle>(graph, begin, entry,
+                                                 file_size,
+                                                 graph.n_halfedges());
+        break;
+      case CMESH_EDGE_ATTRIBUTES:
+        ok = read_cmesh_property<typename Graph::EdgeAttribute, Graph,
+                                 EdgeHandle>(graph, begin, entry, file_size,
+                                             graph.n_edges());
+        break;
+      case CMESH_FACE_ATTRIBUTES:
+        ok = read_cmesh_property<typename Graph::FaceAttribute, Graph,
+                                 FaceHandle>(graph, begin, entry, file_size,
+                                             graph.n_faces());
+        break;
+    }
+    if (!ok) return false;
+  }
+  return true;
+}
+
+/* check that all handles stored in the items are in range */
+template <typename Graph>
+bool check_cmesh_topology(const Graph& graph) {
+  int nv = graph.n_vertices(), nh = graph.n_halfedges(), nf = graph.n_faces();
+  for (int i = 0; i < nh; ++i) {
+    auto heh = graph.halfedge_handle(i);
+    int v = graph.to_vertex_handle(heh).idx();
+    int next = graph.next_halfedge_handle(heh).idx();
+    int prev = graph.prev_halfedge_handle(heh).idx();
+    int f = graph.face_handle(heh).idx();
+    if (v < 0 || v >= nv || next < 0 || next >= nh || prev < 0 ||
+        prev >= nh || f >= nf)
+      return false;
+  }
+  for (int i = 0; i < nv; ++i)
+    if (graph.halfedge_handle(graph.vertex_handle(i)).idx() >= nh)
+      return false;
+  for (int i = 0; i < nf; ++i) {
+    int h = graph.halfedge_handle(graph.face_handle(i)).idx();
+    if (h < 0 || h >= nh) return false;
+  }
+  return true;
+}
+
+/**
+ * @brief load a halfedge graph from .cmesh content, the element arrays are
+ * copied from the content in one block each
+ * @return true if sucessfully loaded, otherwise false
+ */
+template <typename Graph>
+bool read_cmesh(Graph& graph, const char* begin, const char* end) {
+  typedef typename Graph::FT Scalar;
+  typedef typename Graph::Point Point;
+  static_assert(std::is_arithmetic<Scalar>::value,
+                ".cmesh only stores arithmetic coordinates");
+  typedef halfedge::VertexItem VertexItem;
+  typedef halfedge::EdgeItem EdgeItem;
+  typedef halfedge::FaceItem FaceItem;
+  const unsigned dim = Point::dimension();
+
+  graph.clear();
+  uint64_t file_size = end - begin;
+  CmeshHeader header;
+  if (file_size < sizeof(header)) {
+    std::cerr << "error while reading cmesh header." << std::endl;
+    return false;
+  }
+  std::memcpy(&header, begin, sizeof(header));
+  if (std::memcmp(header.magic, CMESH_MAGIC, sizeof(CMESH_MAGIC)) != 0 ||
+      header.version != CMESH_VERSION ||
+      header.byte_order != CMESH_BYTE_ORDER || header.dimension != dim ||
+      header.scalar_size != sizeof(Scalar) ||
+      header.scalar_is_float != std::is_floating_point<Scalar>::value) {
+    std::cerr << "error while reading cmesh header." << std::endl;
+    return false;
+  }
+
+  const CmeshSectionEntry* sections = header.sections;
+  uint64_t nv = sections[CMESH_VERTICES].count;
+  uint64_t ne = sections[CMESH_EDGES].count;
+  uint64_t nf = sections[CMESH_FACES].count;
+  if (!check_cmesh_section(sections[CMESH_VERTICES], sizeof(VertexItem),
+                           file_size) ||
+      !check_cmesh_section(sections[CMESH_EDGES], sizeof(EdgeItem),
+                           file_size) ||
+      !check_cmesh_section(sections[CMESH_FACES], sizeof(FaceItem),
+                           file_size) ||
+      !check_cmesh_section(sections[CMESH_POINTS], dim * sizeof(Scalar),
+                           file_size) ||
+      sections[CMESH_POINTS].count > nv) {
+    std::cerr << "error while reading cmesh elements." << std::endl;
+    return false;
+  }
+
+  graph.assign_items(
+      reinterpret_cast<const VertexItem*>(begin +
+                                          sections[CMESH_VERTICES].offset),
+      nv,
+      reinterpret_cast<const EdgeItem*>(begin + sections[CMESH_EDGES].offset),
+      ne,
+      reinterpret_cast<const FaceItem*>(begin + sections[CMESH_FACES].offset),
+      nf);
+  if (!check_cmesh_topology(graph)) {
+    graph.clear();
+    std::cerr << "error while reading cmesh elements." << std::endl;
+    return false;
+  }
+
+  uint64_t np = sections[CMESH_POINTS].count;
+  if (np > 0) {
+    const char* p = begin + sections[CMESH_POINTS].offset;
+    // allocate all points at once
+    graph.point(graph.vertex_handle(np - 1));
+    for (uint64_t i = 0; i < np; ++i) {
+      Point& point = graph.point(graph.vertex_handle(i));
+      for (unsigned k = 0; k < dim; ++k, p += sizeof(Scalar))
+        std::memcpy(&point[k], p, sizeof(Scalar));
+    }
+  }
+
+  typedef typename Graph::VertexHandle VertexHandle;
+  typedef typename Graph::HalfedgeHandle HalfedgeHandle;
+  typedef typename Graph::EdgeHandle EdgeHandle;
+  typedef typename Graph::FaceHandle FaceHandle;
+  if (!read_cmesh_attributes<typename Graph::VertexAttribute, Graph,
+                             VertexHandle>(
+          graph, begin, sections[CMESH_VERTEX_ATTRIBUTES], file_size, nv) ||
+      !read_cmesh_attributes<typename Graph::HalfedgeAttribute, Graph,
+                             HalfedgeHandle>(
+          graph, begin, sections[CMESH_HALFEDGE_ATTRIBUTES], file_size,
+          2 * ne) ||
+      !read_cmesh_attributes<typename Graph::EdgeAttribute, Graph,
+                             EdgeHandle>(
+          graph, begin, sections[CMESH_EDGE_ATTRIBUTES], file_size, ne) ||
+      !read_cmesh_attributes<typename Graph::FaceAttribute, Graph,
+                             FaceHandle>(
+          graph, begin, sections[CMESH_FACE_ATTRIBUTES], file_size, nf) ||
+      !read_cmesh_properties(graph, begin, sections[CMESH_PROPERTIES],
+                             file_size)) {
+    graph.clear();
+    std::cerr << "error while reading cmesh attributes." << std::endl;
+    return false;
+  }
+  return true;
+}
+
+}  // namespace internal
+}  // namespace io
+}  // namespace CMTL
+
+#endif  // __io_common_cmesh_format__
@@ -0,0 +1,108 @@
+#ifndef __io_common_mapped_file__
+#define __io_common_mapped_file__
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define CMTL_IO_USE_MMAP
+#endif
+
+namespace CMTL {
+namespace io {
+
+/**
+ * @brief read-only view of a whole file, the file is memory mapped when the
+ * platform supports it, otherwise it is read into a buffer
+ */
+class MappedFile {
+ public:
+  MappedFile() = default;
+
+  explicit MappedFile(const std::string& file) { open(file); }
+
+  MappedFile(const MappedFile&) = delete;
+
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  ~MappedFile() { close(); }
+
+ public:
+  /**
+   * @brief map a file
+   * @return true if the file is opened
+   */
+  bool open(const std::string& file) {
+    close();
+#ifdef CMTL_IO_USE_MMAP
+    int fd = ::open(file.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+      ::close(fd);
+      return false;
+    }
+    _size = st.st_size;
+    if (_size > 0) {
+      void* addr = ::mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (addr != MAP_FAILED) {
+        ::madvise(addr, _size, MADV_SEQUENTIAL);
+        _data = static_cast<const char*>(addr);
+        _mapped = true;
+      }
+    }
+    ::close(fd);
+    _is_open = _mapped || _size == 0;
+    if (_is_open) return true;
+#endif
+    // fall back to read the whole file
+    std::ifstream in(file.c_str(), std::ios_base::in | std::ios_base::binary);
+    if (!in.is_open()) return false;
+    in.seekg(0, std::ios_base::end);
+    _buffer.resize(static_cast<size_t>(in.tellg()));
+    in.seekg(0, std::ios_base::beg);
+    in.read(_buffer.data(), _buffer.size());
+    _data = _buffer.data();
+    _size = _buffer.size();
+    _is_open = !in.bad();
+    return _is_open;
+  }
+
+  /** @brief unmap the file */
+  void close() {
+#ifdef CMTL_IO_USE_MMAP
+    if (_mapped) ::munmap(const_cast<char*>(_data), _size);
+#endif
+    _buffer.clear();
+    _data = nullptr;
+    _size = 0;
+    _mapped = false;
+    _is_open = false;
+  }
+
+  bool is_open() const { return _is_open; }
+
+  const char* begin() const { return _data; }
+
+  const char* end() const { return _data + _size; }
+
+  size_t size() const { return _size; }
+
+ private:
+  const char* _data = nullptr;
+  size_t _size = 0;
+  bool _mapped = false;
+  bool _is_open = false;
+  /* file content when mmap is not available */
+  std::vector<char> _buffer;
+};
+
+}  // namespace io
+}  // namespace CMTL
+
+#endif  // __io_common_mapped_file__
@@ -0,0 +1,24 @@
+#ifndef __io_common_obj_corner_attributes__
+#define __io_common_obj_corner_attributes__
+
+#include <vector>
+
+namespace CMTL {
+namespace io {
+
+/**
+ * @brief texture coordinates and normals of the face corners of an .obj file,
+ * stored per halfedge, the corner of a halfedge is its target vertex in its
+ * face, so halfedge h has uv[2h, 2h + 2) and normal[3h, 3h + 3)
+ * @note a column is empty if the file has no such record, corners without
+ * index and boundary halfedges are 0
+ */
+struct ObjCornerAttributes {
+  std::vector<double> uv;
+  std::vector<double> normal;
+};
+
+}  // namespace io
+}  // namespace CMTL
+
+#endif  // __io_common_obj_corner_attributes__
@@ -0,0 +1,282 @@
+#ifndef __io_common_obj_parser__
+#define __io_common_obj_parser__
+
+#include "../../common/parallel.h"
+#include "obj_corner_attributes.h"
+#include "scanner.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+namespace CMTL {
+namespace io {
+
+namespace internal {
+
+/* vt and vn records and the 0-based vt and vn index of each face corner, -1
+ * if the corner has none */
+struct ObjCornerData {
+  std::vector<double> uvs;
+  std::vector<double> normals;
+  std::vector<int> uv_indices;
+  std::vector<int> normal_indices;
+};
+
+/* vertices and faces parsed from a part of an .obj file */
+template <typename Point>
+struct ObjChunk {
+  enum Status { OK = 0, VERTEX_ERROR, FACE_ERROR };
+
+  std::vector<Point> points;
+  /* face i is made of indices[offsets[i], offsets[i + 1]) */
+  std::vector<unsigned> offsets;
+  /* raw obj indices, 1-based or negative */
+  std::vector<int> indices;
+  /* number of vertices of this chunk before each face */
+  std::vector<unsigned> face_base;
+  /* vt and vn records, and raw vt and vn indices of corners, 0 if none */
+  std::vector<double> uvs, normals;
+  std::vector<int> uv_indices, normal_indices;
+  /* number of vt and vn records of this chunk before each face */
+  std::vector<unsigned> face_uv_base, face_normal_base;
+  Status status = OK;
+};
+
+/* parse the vertex and face lines of [begin, end), the vt and vn records and
+ * corner indices are only kept if with_corners is true */
+template <typename Point>
+void parse_obj_chunk(const char* begin, const char* end,
+                     ObjChunk<Point>& chunk, bool with_corners = false) {
+  typedef ObjChunk<Point> Chunk;
+
+  // count the elements first to avoid reallocation
+  size_t n_vertices = Scanner::count_lines(begin, end, "v");
+  size_t n_faces = Scanner::count_lines(begin, end, "f");
+  chunk.points.reserve(n_vertices);
+  chunk.offsets.assign(1, 0);
+  chunk.offsets.reserve(n_faces + 1);
+  chunk.indices.reserve(3 * n_faces);
+  chunk.face_base.reserve(n_faces);
+  if (with_corners) {
+    chunk.uv_indices.reserve(3 * n_faces);
+    chunk.normal_indices.reserve(3 * n_faces);
+    chunk.face_uv_base.reserve(n_faces);
+    chunk.face_normal_base.reserve(n_faces);
+  }
+
+  Scanner scanner(begin, end);
+  const char *key, *key_end;
+  for (; !scanner.eof(); scanner.next_line()) {
+    if (!scanner.token(key, key_end) || key[0] == '#') continue;
+    size_t key_size = key_end - key;
+
+    if (key_size == 1 && key[0] == 'v') {
+      Point p;
+      bool ok = scanner.number(p[0]) && scanner.number(p[1]);
+      if (Point::dimension() == 3) ok = ok && scanner.number(p[2]);
+      if (!ok) {
+        chunk.status = Chunk::VERTEX_ERROR;
+        return;
+      }
+      chunk.points.push_back(p);
+    } else if (key_size == 1 && key[0] == 'f') {
+      int vid;
+      while (scanner.number(vid)) {
+        chunk.indices.push_back(vid);
+        if (!with_corners) {
+          scanner.skip_token();
+          continue;
+        }
+        // "v", "v/vt", "v//vn" or "v/vt/vn"
+        int uv = 0, normal = 0;
+        if (scanner.consume('/')) {
+          scanner.number(uv);
+          if (scanner.consume('/')) scanner.number(normal);
+        }
+        chunk.uv_indices.push_back(uv);
+        chunk.normal_indices.push_back(normal);
+        scanner.skip_token();
+      }
+      if (chunk.indices.size() < chunk.offsets.back() + 3) {
+        chunk.status = Chunk::FACE_ERROR;
+        return;
+      }
+      chunk.offsets.push_back(chunk.indices.size());
+      chunk.face_base.push_back(chunk.points.size());
+      if (with_corners) {
+        chunk.face_uv_base.push_back(chunk.uvs.size() / 2);
+        chunk.face_normal_base.push_back(chunk.normals.size() / 3);
+      }
+    } else if (with_corners && key_size == 2 && key[0] == 'v' &&
+               (key[1] == 't' || key[1] == 'n')) {
+      std::vector<double>& values = key[1] == 't' ? chunk.uvs : chunk.normals;
+      double x;
+      for (unsigned k = key[1] == 't' ? 2 : 3; k > 0; --k) {
+        if (!scanner.number(x)) {
+          chunk.status = Chunk::VERTEX_ERROR;
+          return;
+        }
+        values.push_back(x);
+      }
+    }
+  }
+}
+
+/* convert the obj indices of a chunk into vertex indices, base is the number
+ * of vertices before the chunk */
+template <typename Point>
+bool resolve_obj_indices(const ObjChunk<Point>& chunk, unsigned base,
+                         unsigned* out) {
+  for (unsigned f = 0; f + 1 < chunk.offsets.size(); ++f) {
+    int nv = static_cast<int>(base + chunk.face_base[f]);
+    for (unsigned i = chunk.offsets[f]; i < chunk.offsets[f + 1]; ++i) {
+      int vid = chunk.indices[i];
+      if (vid > nv || vid == 0 || vid < -nv) return false;
+      *out++ = vid < 0 ? nv + vid : vid - 1;
+    }
+  }
+  return true;
+}
+
+/* convert the raw vt or vn indices of a chunk into 0-based indices, -1 if a
+ * corner has none, base is the number of records before the chunk */
+template <typename Point>
+bool resolve_obj_corner_indices(const ObjChunk<Point>& chunk,
+                                const std::vector<int>& raw,
+                                const std::vector<unsigned>& face_base,
+                                unsigned base, int* out) {
+  for (unsigned f = 0; f + 1 < chunk.offsets.size(); ++f) {
+    int n = static_cast<int>(base + face_base[f]);
+    for (unsigned i = chunk.offsets[f]; i < chunk.offsets[f + 1]; ++i) {
+      int id = raw[i];
+      if (id > n || id < -n) return false;
+      *out++ = id < 0 ? n + id : id - 1;
+    }
+  }
+  return true;
+}
+
+/* split [begin, end) into n pieces at line breaks */
+inline std::vector<const char*> split_lines(const char* begin, const char* end,
+                                            unsigned n) {
+  std::vector<const char*> bounds(1, begin);
+  size_t size = end - begin;
+  for (unsigned i = 1; i < n; ++i) {
+    const char* p = std::max(begin + size * i / n, bounds.back());
+    if (p >= end) break;
+    const char* eol = static_cast<const char*>(
+        std::memchr(p, '\n', static_cast<size_t>(end - p)));
+    if (!eol || eol + 1 >= end) break;
+    if (eol + 1 > bounds.back()) bounds.push_back(eol + 1);
+  }
+  bounds.push_back(end);
+  return bounds;
+}
+
+/**
+ * @brief parse the vertices and faces of an .obj file content, the file is
+ * split at line breaks and parsed by n_threads threads, the result does not
+ * depend on the number of threads
+ * @param points vertex points
+ * @param offsets face i is made of indices[offsets[i], offsets[i + 1])
+ * @param indices 0-based vertex indices of faces
+ * @param corners vt and vn records and corner indices, ignored if null
+ * @return true if sucessfully parsed, otherwise false
+ */
+template <typename Point>
+bool parse_obj(const char* begin, const char* end, unsigned n_threads,
+               std::vector<Point>& points, std::vector<unsigned>& offsets,
+               std::vector<unsigned>& indices,
+               ObjCornerData* corners = nullptr) {
+  typedef ObjChunk<Point> Chunk;
+
+  std::vector<const char*> bounds =
+      split_lines(begin, end, std::max(n_threads, 1u));
+  unsigned n_chunks = bounds.size() - 1;
+  std::vector<Chunk> chunks(n_chunks);
+  parallel_for(n_chunks, n_chunks, [&](size_t first, size_t last) {
+    for (size_t i = first; i < last; ++i)
+      parse_obj_chunk(bounds[i], bounds[i + 1], chunks[i], corners != nullptr);
+  });
+
+  // prefix sums of the chunk sizes
+  std::vector<unsigned> point_base(n_chunks + 1, 0);
+  std::vector<unsigned> face_base(n_chunks + 1, 0);
+  std::vector<unsigned> uv_base(n_chunks + 1, 0);
+  std::vector<unsigned> normal_base(n_chunks + 1, 0);
+  for (unsigned i = 0; i < n_chunks; ++i) {
+    if (chunks[i].status == Chunk::VERTEX_ERROR) {
+      std::cerr << "error while reading obj vertex." << std::endl;
+      return false;
+    } else if (chunks[i].status == Chunk::FACE_ERROR) {
+      std::cerr << "error while reading obj face." << std::endl;
+      return false;
+    }
+    point_base[i + 1] = point_base[i] + chunks[i].points.size();
+    face_base[i + 1] = face_base[i] + chunks[i].offsets.size() - 1;
+    uv_base[i + 1] = uv_base[i] + chunks[i].uvs.size() / 2;
+    normal_base[i + 1] = normal_base[i] + chunks[i].normals.size() / 3;
+  }
+
+  offsets.resize(face_base[n_chunks] + 1);
+  offsets[0] = 0;
+  for (unsigned i = 0; i < n_chunks; ++i) {
+    unsigned index_base = offsets[face_base[i]];
+    for (unsigned f = 1; f < chunks[i].offsets.size(); ++f)
+      offsets[face_base[i] + f] = index_base + chunks[i].offsets[f];
+  }
+  indices.resize(offsets.back());
+  if (n_chunks == 1) {
+    points.swap(chunks[0].points);
+  } else {
+    points.resize(point_base[n_chunks]);
+  }
+
+  if (corners) {
+    corners->uvs.resize(2 * uv_base[n_chunks]);
+    corners->normals.resize(3 * normal_base[n_chunks]);
+    corners->uv_indices.resize(indices.size());
+    corners->normal_indices.resize(indices.size());
+  }
+
+  std::vector<unsigned char> resolved(n_chunks, 0);
+  auto merge_chunk = [&](unsigned i) {
+    const Chunk& chunk = chunks[i];
+    if (n_chunks > 1)
+      std::copy(chunk.points.begin(), chunk.points.end(),
+                points.begin() + point_base[i]);
+    unsigned first = offsets[face_base[i]];
+    resolved[i] =
+        resolve_obj_indices(chunk, point_base[i], indices.data() + first);
+    if (!corners || !resolved[i]) return;
+    std::copy(chunk.uvs.begin(), chunk.uvs.end(),
+              corners->uvs.begin() + 2 * uv_base[i]);
+    std::copy(chunk.normals.begin(), chunk.normals.end(),
+              corners->normals.begin() + 3 * normal_base[i]);
+    resolved[i] =
+        resolve_obj_corner_indices(chunk, chunk.uv_indices,
+                                   chunk.face_uv_base, uv_base[i],
+                                   corners->uv_indices.data() + first) &&
+        resolve_obj_corner_indices(chunk, chunk.normal_indices,
+                                   chunk.face_normal_base, normal_base[i],
+                                   corners->normal_indices.data() + first);
+  };
+  parallel_for(n_chunks, n_chunks, [&](size_t first, size_t last) {
+    for (size_t i = first; i < last; ++i) merge_chunk(i);
+  });
+  for (unsigned i = 0; i < n_chunks; ++i) {
+    if (!resolved[i]) {
+      std::cerr << "error while reading obj face." << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace internal
+}  // namespace io
+}  // namespace CMTL
+
+#endif  // __io_common_obj_parser__
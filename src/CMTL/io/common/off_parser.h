@@ -0,0 +1,95 @@
+#ifndef __io_common_off_parser__
+#define __io_common_off_parser__
+
+#include "scanner.h"
+
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+namespace CMTL {
+namespace io {
+namespace internal {
+
+/**
+ * @brief parse the vertices and faces of .off content, the storage is
+ * reserved from the counts of the header, colors and other trailing values
+ * are ignored
+ * @param points vertex points, z is ignored for 2d points
+ * @param offsets face i is made of indices[offsets[i], offsets[i + 1])
+ * @param indices vertex indices of faces
+ * @return true if sucessfully parsed, otherwise false
+ */
+template <typename Point>
+bool parse_off(const char* begin, const char* end, std::vector<Point>& points,
+               std::vector<unsigned>& offsets,
+               std::vector<unsigned>& indices) {
+  points.clear();
+  offsets.assign(1, 0);
+  indices.clear();
+
+  // "OFF", "COFF", "NOFF" ... optionally followed by the counts
+  Scanner scanner(begin, end);
+  const char *key, *key_end;
+  unsigned nv, nf, ne;
+  bool ok = scanner.next_record() && scanner.token(key, key_end) &&
+            key_end - key >= 3 && std::memcmp(key_end - 3, "OFF", 3) == 0;
+  if (ok && scanner.eol()) {
+    scanner.next_line();
+    ok = scanner.next_record();
+  }
+  ok = ok && scanner.number(nv) && scanner.number(nf) && scanner.number(ne);
+  if (!ok) {
+    std::cerr << "error while reading off header." << std::endl;
+    return false;
+  }
+  scanner.next_line();
+
+  // three coordinates per vertex, then a degree and three indices per face
+  if (!scanner.can_hold(nv, 3)) {
+    std::cerr << "error while reading off, more vertices than data."
+              << std::endl;
+    return false;
+  }
+  points.resize(nv);
+  for (unsigned i = 0; i < nv; ++i, scanner.next_line()) {
+    Point& p = points[i];
+    double z;
+    ok = scanner.next_record() && scanner.number(p[0]) && scanner.number(p[1]);
+    if (Point::dimension() == 3)
+      ok = ok && scanner.number(p[2]);
+    else
+      ok = ok && scanner.number(z);
+    if (!ok) {
+      std::cerr << "error while reading off vertex." << std::endl;
+      return false;
+    }
+  }
+
+  if (!scanner.can_hold(nf, 4)) {
+    std::cerr << "error while reading off, more faces than data." << std::endl;
+    return false;
+  }
+  offsets.reserve(nf + 1);
+  indices.reserve(3 * nf);
+  for (unsigned f = 0; f < nf; ++f, scanner.next_line()) {
+    unsigned degree, vid;
+    ok = scanner.next_record() && scanner.number(degree) && degree >= 3;
+    for (unsigned i = 0; ok && i < degree; ++i) {
+      ok = scanner.number(vid) && vid < nv;
+      indices.push_back(vid);
+    }
+    if (!ok) {
+      std::cerr << "error while reading off face." << std::endl;
+      return false;
+    }
+    offsets.push_back(indices.size());
+  }
+  return true;
+}
+
+}  // namespace internal
+}  // namespace io
+}  // namespace CMTL
+
+#endif  // __io_common_off_parser__
@@ -0,0 +1,131 @@
+#ifndef __io_common_output_buffer__
+#define __io_common_output_buffer__
+
+#include <algorithm>
+#include <charconv>
+#include <fstream>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace CMTL {
+namespace io {
+
+/**
+ * @brief text output buffer used by the writers, numbers are formatted with
+ * std::to_chars into a large buffer which is written to the stream in blocks
+ * @note floating point numbers are printed in the shortest form which reads
+ * back to the same value
+ */
+class OutputBuffer {
+ public:
+  /**
+   * @brief write to a stream
+   */
+  explicit OutputBuffer(std::ostream& out, size_t capacity = 1 << 20)
+      : _out(&out) {
+    _buffer.resize(capacity);
+  }
+
+  /**
+   * @brief write to a file, the file is truncated
+   */
+  explicit OutputBuffer(const std::string& file, size_t capacity = 1 << 20)
+      : _file(file.c_str(), std::ofstream::trunc | std::ofstream::binary),
+        _out(&_file) {
+    _buffer.resize(capacity);
+  }
+
+  OutputBuffer(const OutputBuffer&) = delete;
+
+  OutputBuffer& operator=(const OutputBuffer&) = delete;
+
+  ~OutputBuffer() { flush(); }
+
+ public:
+  /** @brief check whether the stream is good */
+  bool good() const { return _out->good(); }
+
+  /** @brief write the buffered content into the stream */
+  void flush() {
+    if (_size > 0) _out->write(_buffer.data(), _size);
+    _size = 0;
+    _out->flush();
+  }
+
+  /** @brief append a character */
+  OutputBuffer& put(char c) {
+    reserve(1);
+    _buffer[_size++] = c;
+    return *this;
+  }
+
+  /** @brief append a string */
+  OutputBuffer& write(const char* str, size_t n) {
+    if (n > _buffer.size()) {
+      flush();
+      _out->write(str, n);
+      return *this;
+    }
+    reserve(n);
+    std::copy(str, str + n, _buffer.data() + _size);
+    _size += n;
+    return *this;
+  }
+
+  OutputBuffer& operator<<(char c) { return put(c); }
+
+  OutputBuffer& operator<<(const char* str) {
+    return write(str, std::char_traits<char>::length(str));
+  }
+
+  OutputBuffer& operator<<(const std::string& str) {
+    return write(str.data(), str.size());
+  }
+
+  /**
+   * @brief append a number, arithmetic types are formatted by std::to_chars,
+   * other types such as mpq_class by operator<<
+   */
+  template <typename T>
+  typename std::enable_if<!std::is_convertible<T, const char*>::value &&
+                              !std::is_same<T, std::string>::value &&
+                              !std::is_same<T, char>::value,
+                          OutputBuffer&>::type
+  operator<<(const T& v) {
+    if constexpr (std::is_arithmetic<T>::value) {
+      // enough for the longest double and 64 bits integer
+      reserve(32);
+      auto result =
+          std::to_chars(_buffer.data() + _size, _buffer.data() + _size + 32, v);
+      _size = result.ptr - _buffer.data();
+    } else {
+      std::ostringstream stream;
+      stream << v;
+      *this << stream.str();
+    }
+    return *this;
+  }
+
+ private:
+  /* make room for n characters */
+  void reserve(size_t n) {
+    if (_size + n > _buffer.size()) {
+      _out->write(_buffer.data(), _size);
+      _size = 0;
+    }
+  }
+
+ private:
+  std::ofstream _file;
+  std::ostream* _out;
+  std::vector<char> _buffer;
+  size_t _size = 0;
+};
+
+}  // namespace io
+}  // namespace CMTL
+
+#endif  // __io_common_output_buffer__
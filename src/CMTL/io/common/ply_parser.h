@@ -0,0 +1,467 @@
+#ifndef __io_common_ply_parser__
+#define __io_common_ply_parser__
+
+#include "binary_utils.h"
+#include "scanner.h"
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace CMTL {
+namespace io {
+
+/**
+ * @brief scalar properties of a .ply file besides coordinates and face
+ * indices, e.g. vertex quality or face label, each property is a column with
+ * one value per vertex or face
+ */
+struct PlyProperties {
+  /* per-vertex properties */
+  std::map<std::string, std::vector<double>> vertex;
+  /* per-face properties */
+  std::map<std::string, std::vector<double>> face;
+};
+
+namespace internal {
+
+/* scalar types of .ply format */
+enum class PlyType {
+  INT8,
+  UINT8,
+  INT16,
+  UINT16,
+  INT32,
+  UINT32,
+  FLOAT32,
+  FLOAT64,
+  INVALID
+};
+
+inline PlyType ply_type(const std::string& name) {
+  if (name == "char" || name == "int8") return PlyType::INT8;
+  if (name == "uchar" || name == "uint8") return PlyType::UINT8;
+  if (name == "short" || name == "int16") return PlyType::INT16;
+  if (name == "ushort" || name == "uint16") return PlyType::UINT16;
+  if (name == "int" || name == "int32") return PlyType::INT32;
+  if (name == "uint" || name == "uint32") return PlyType::UINT32;
+  if (name == "float" || name == "float32") return PlyType::FLOAT32;
+  if (name == "double" || name == "float64") return PlyType::FLOAT64;
+  return PlyType::INVALID;
+}
+
+inline unsigned ply_type_size(PlyType type) {
+  static const unsigned sizes[] = {1, 1, 2, 2, 4, 4, 4, 8, 0};
+  return sizes[static_cast<int>(type)];
+}
+
+/* parse an element count, false unless the word is a decimal number which
+ * fits in size_t */
+inline bool parse_ply_count(const std::string& word, size_t& count) {
+  if (word.empty() || word[0] < '0' || word[0] > '9') return false;
+  errno = 0;
+  char* word_end;
+  unsigned long long value = std::strtoull(word.c_str(), &word_end, 10);
+  if (errno == ERANGE || *word_end != '\0' || value > SIZE_MAX) return false;
+  count = static_cast<size_t>(value);
+  return true;
+}
+
+/* a property of a .ply element, list properties have a count type */
+struct PlyProperty {
+  std::string name;
+  PlyType type;
+  bool is_list = false;
+  PlyType count_type = PlyType::INVALID;
+};
+
+struct PlyElement {
+  std::string name;
+  size_t count = 0;
+  std::vector<PlyProperty> properties;
+};
+
+struct PlyHeader {
+  enum Format { ASCII, BINARY_LITTLE_ENDIAN, BINARY_BIG_ENDIAN };
+  Format format = ASCII;
+  std::vector<PlyElement> elements;
+  /* begin of the element data */
+  const char* data = nullptr;
+};
+
+/* parse the header of .ply content */
+inline bool parse_ply_header(const char* begin, const char* end,
+                             PlyHeader& header) {
+  Scanner scanner(begin, end);
+  const char *key, *key_end;
+  if (!scanner.token(key, key_end) || std::string(key, key_end) != "ply")
+    return false;
+  for (scanner.next_line(); !scanner.eof(); scanner.next_line()) {
+    if (!scanner.token(key, key_end)) continue;
+    std::string k(key, key_end);
+    std::vector<std::string> words;
+    const char *w, *w_end;
+    while (scanner.token(w, w_end)) words.emplace_back(w, w_end);
+
+    if (k == "format") {
+      if (words.empty()) return false;
+      if (words[0] == "ascii")
+        header.format = PlyHeader::ASCII;
+      else if (words[0] == "binary_little_endian")
+        header.format = PlyHeader::BINARY_LITTLE_ENDIAN;
+      else if (words[0] == "binary_big_endian")
+        header.format = PlyHeader::BINARY_BIG_ENDIAN;
+      else
+        return false;
+    } else if (k == "element") {
+      if (words.size() != 2) return false;
+      PlyElement element;
+      element.name = words[0];
+      if (!parse_ply_count(words[1], element.count)) return false;
+      header.elements.push_back(element);
+    } else if (k == "property") {
+      if (header.elements.empty()) return false;
+      PlyProperty property;
+      if (words.size() == 4 && words[0] == "list") {
+        property.is_list = true;
+        property.count_type = ply_type(words[1]);
+        property.type = ply_type(words[2]);
+        property.name = words[3];
+        if (property.count_type == PlyType::INVALID) return false;
+      } else if (words.size() == 2) {
+        property.type = ply_type(words[0]);
+        property.name = words[1];
+      } else {
+        return false;
+      }
+      if (property.type == PlyType::INVALID) return false;
+      header.elements.back().properties.push_back(property);
+    } else if (k == "end_header") {
+      scanner.next_line();
+      header.data = scanner.position();
+      return true;
+    }
+    // comment and obj_info are ignored
+  }
+  return false;
+}
+
+/* reader of the element data of .ply content */
+class PlyDataReader {
+ public:
+  PlyDataReader(const PlyHeader& header, const char* end)
+      : _format(header.format),
+        _swap(header.format != PlyHeader::ASCII &&
+              (header.format == PlyHeader::BINARY_LITTLE_ENDIAN) !=
+                  is_little_endian()),
+        _cur(header.data),
+        _end(end),
+        _scanner(header.data, end) {}
+
+ public:
+  bool is_binary() const { return _format != PlyHeader::ASCII; }
+
+  const char* position() const { return is_binary() ? _cur : nullptr; }
+
+  /* number of bytes left */
+  size_t remaining() const {
+    return _end - (is_binary() ? _cur : _scanner.position());
+  }
+
+  bool skip_bytes(size_t n) {
+    if (static_cast<size_t>(_end - _cur) < n) return false;
+    _cur += n;
+    return true;
+  }
+
+  /* decode a binary value at p without moving */
+  double decode(const char* p, PlyType type) const {
+    switch (type) {
+      case PlyType::INT8:
+        return load<int8_t>(p);
+      case PlyType::UINT8:
+        return load<uint8_t>(p);
+      case PlyType::INT16:
+        return load<int16_t>(p);
+      case PlyType::UINT16:
+        return load<uint16_t>(p);
+      case PlyType::INT32:
+        return load<int32_t>(p);
+      case PlyType::UINT32:
+        return load<uint32_t>(p);
+      case PlyType::FLOAT32:
+        return load<float>(p);
+      case PlyType::FLOAT64:
+        return load<double>(p);
+      default:
+        return 0.;
+    }
+  }
+
+  /* read the next value */
+  bool read(PlyType type, double& v) {
+    if (is_binary()) {
+      unsigned size = ply_type_size(type);
+      if (static_cast<size_t>(_end - _cur) < size) return false;
+      v = decode(_cur, type);
+      _cur += size;
+      return true;
+    }
+    return next_ascii_token() && _scanner.number(v);
+  }
+
+  /* read the next value as a coordinate, ascii values are parsed exactly */
+  template <typename T>
+  bool read_coordinate(PlyType type, T& v) {
+    if (is_binary()) {
+      double d;
+      if (!read(type, d)) return false;
+      v = T(d);
+      return true;
+    }
+    return next_ascii_token() && _scanner.number(v);
+  }
+
+  /* finish an element entry, ascii entries end with the line */
+  void end_entry() {
+    if (!is_binary()) _scanner.next_line();
+  }
+
+ private:
+  template <typename V>
+  V load(const char* p) const {
+    V v;
+    if (_swap) {
+      char bytes[sizeof(V)];
+      for (unsigned i = 0; i < sizeof(V); ++i) bytes[i] = p[sizeof(V) - 1 - i];
+      std::memcpy(&v, bytes, sizeof(V));
+    } else {
+      std::memcpy(&v, p, sizeof(V));
+    }
+    return v;
+  }
+
+  /* skip blank lines between ascii entries */
+  bool next_ascii_token() {
+    _scanner.skip_spaces();
+    while (!_scanner.eof() && _scanner.eol()) {
+      _scanner.next_line();
+      _scanner.skip_spaces();
+    }
+    return !_scanner.eof();
+  }
+
+ private:
+  PlyHeader::Format _format;
+  bool _swap;
+  const char* _cur;
+  const char* _end;
+  Scanner _scanner;
+};
+
+/* read the vertex element, binary vertices without list properties are
+ * decoded straight from the file block */
+template <typename Point>
+bool read_ply_vertices(PlyDataReader& reader, const PlyElement& element,
+                       std::vector<Point>& points, PlyProperties& properties) {
+  unsigned dim = Point::dimension();
+  // role of each property, coordinate index or -1 for scalar property
+  std::vector<int> coordinate(element.properties.size(), -1);
+  std::vector<std::vector<double>*> columns(element.properties.size(), 0);
+  bool fixed_size = true;
+  unsigned stride = 0;
+  std::vector<unsigned> offset(element.properties.size(), 0);
+  for (unsigned i = 0; i < element.properties.size(); ++i) {
+    const PlyProperty& property = element.properties[i];
+    const char* axis[] = {"x", "y", "z"};
+    for (unsigned k = 0; k < dim; ++k)
+      if (property.name == axis[k] && !property.is_list) coordinate[i] = k;
+    // z of 2d points is dropped
+    if (coordinate[i] < 0 && !property.is_list &&
+        !(dim == 2 && property.name == "z")) {
+      columns[i] = &properties.vertex[property.name];
+      columns[i]->resize(element.count);
+    }
+    offset[i] = stride;
+    stride += ply_type_size(property.type);
+    fixed_size = fixed_size && !property.is_list;
+  }
+
+  points.resize(element.count);
+  if (reader.is_binary() && fixed_size) {
+    const char* block = reader.position();
+    if (!reader.skip_bytes(element.count * stride)) return false;
+    for (size_t v = 0; v < element.count; ++v, block += stride) {
+      Point& p = points[v];
+      for (unsigned i = 0; i < element.properties.size(); ++i) {
+        PlyType type = element.properties[i].type;
+        if (coordinate[i] >= 0)
+          p[coordinate[i]] = reader.decode(block + offset[i], type);
+        else if (columns[i])
+          (*columns[i])[v] = reader.decode(block + offset[i], type);
+      }
+    }
+    return true;
+  }
+
+  for (size_t v = 0; v < element.count; ++v) {
+    Point& p = points[v];
+    for (unsigned i = 0; i < element.properties.size(); ++i) {
+      const PlyProperty& property = element.properties[i];
+      double value, count;
+      if (property.is_list) {
+        if (!reader.read(property.count_type, count)) return false;
+        for (unsigned j = 0; j < count; ++j)
+          if (!reader.read(property.type, value)) return false;
+      } else if (coordinate[i] >= 0) {
+        if (!reader.read_coordinate(property.type, p[coordinate[i]]))
+          return false;
+      } else {
+        if (!reader.read(property.type, value)) return false;
+        if (columns[i]) (*columns[i])[v] = value;
+      }
+    }
+    reader.end_entry();
+  }
+  return true;
+}
+
+/* read the face element, the first list property gives the vertex indices */
+inline bool read_ply_faces(PlyDataReader& reader, const PlyElement& element,
+                           size_t n_vertices, std::vector<unsigned>& offsets,
+                           std::vector<unsigned>& indices,
+                           PlyProperties& properties) {
+  int index_property = -1;
+  for (unsigned i = 0; i < element.properties.size(); ++i) {
+    const PlyProperty& property = element.properties[i];
+    if (property.is_list && index_property < 0 &&
+        (property.name == "vertex_indices" || property.name == "vertex_index"))
+      index_property = i;
+  }
+  if (index_property < 0) return false;
+  std::vector<std::vector<double>*> columns(element.properties.size(), 0);
+  for (unsigned i = 0; i < element.properties.size(); ++i) {
+    const PlyProperty& property = element.properties[i];
+    if (!property.is_list) {
+      columns[i] = &properties.face[property.name];
+      columns[i]->resize(element.count);
+    }
+  }
+
+  offsets.assign(1, 0);
+  offsets.reserve(element.count + 1);
+  indices.reserve(3 * element.count);
+  for (size_t f = 0; f < element.count; ++f) {
+    for (unsigned i = 0; i < element.properties.size(); ++i) {
+      const PlyProperty& property = element.properties[i];
+      double value, count;
+      if (!property.is_list) {
+        if (!reader.read(property.type, value)) return false;
+        (*columns[i])[f] = value;
+        continue;
+      }
+      if (!reader.read(property.count_type, count)) return false;
+      for (unsigned j = 0; j < count; ++j) {
+        if (!reader.read(property.type, value)) return false;
+        if (static_cast<int>(i) != index_property) continue;
+        if (value < 0 || value >= n_vertices) return false;
+        indices.push_back(static_cast<unsigned>(value));
+      }
+      if (static_cast<int>(i) == index_property && count < 3) return false;
+    }
+    reader.end_entry();
+    offsets.push_back(indices.size());
+  }
+  return true;
+}
+
+/* smallest size of an element entry in bytes, at least one so that the
+ * count is bounded by the size of the data: binary lists take their count,
+ * ascii values take a digit and a separator */
+inline size_t min_ply_entry_size(const PlyElement& element, bool binary) {
+  size_t size = 0;
+  for (const PlyProperty& property : element.properties)
+    size += binary ? ply_type_size(property.is_list ? property.count_type
+                                                    : property.type)
+                   : 2;
+  return size > 0 ? size : 1;
+}
+
+/* skip an element which is neither vertex nor face */
+inline bool skip_ply_element(PlyDataReader& reader, const PlyElement& element) {
+  for (size_t e = 0; e < element.count; ++e) {
+    for (const PlyProperty& property : element.properties) {
+      double value, count = 1;
+      if (property.is_list && !reader.read(property.count_type, count))
+        return false;
+      for (unsigned j = 0; j < count; ++j)
+        if (!reader.read(property.type, value)) return false;
+    }
+    reader.end_entry();
+  }
+  return true;
+}
+
+/**
+ * @brief parse the vertices and faces of .ply content
+ * @param points vertex points
+ * @param offsets face i is made of indices[offsets[i], offsets[i + 1])
+ * @param indices vertex indices of faces
+ * @param properties other scalar properties of vertices and faces
+ * @return true if sucessfully parsed, otherwise false
+ */
+template <typename Point>
+bool parse_ply(const char* begin, const char* end, std::vector<Point>& points,
+               std::vector<unsigned>& offsets, std::vector<unsigned>& indices,
+               PlyProperties& properties) {
+  points.clear();
+  offsets.assign(1, 0);
+  indices.clear();
+  properties.vertex.clear();
+  properties.face.clear();
+
+  PlyHeader header;
+  if (!parse_ply_header(begin, end, header)) {
+    std::cerr << "error while reading ply header." << std::endl;
+    return false;
+  }
+
+  PlyDataReader reader(header, end);
+  for (const PlyElement& element : header.elements) {
+    // the last ascii value may end the file without a separator
+    size_t min_size = min_ply_entry_size(element, reader.is_binary());
+    if (element.count > (reader.remaining() + 1) / min_size) {
+      std::cerr << "error while reading ply " << element.name
+                << ", more entries than data." << std::endl;
+      return false;
+    }
+    if (element.name == "vertex") {
+      if (!read_ply_vertices(reader, element, points, properties)) {
+        std::cerr << "error while reading ply vertex." << std::endl;
+        return false;
+      }
+    } else if (element.name == "face") {
+      if (!read_ply_faces(reader, element, points.size(), offsets, indices,
+                          properties)) {
+        std::cerr << "error while reading ply face." << std::endl;
+        return false;
+      }
+    } else if (!skip_ply_element(reader, element)) {
+      std::cerr << "error while reading ply " << element.name << "."
+                << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace internal
+}  // namespace io
+}  // namespace CMTL
+
+#endif  // __io_common_ply_parser__
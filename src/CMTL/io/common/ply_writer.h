@@ -0,0 +1,138 @@
+#ifndef __io_common_ply_writer__
+#define __io_common_ply_writer__
+
+#include "../../common/numeric_utils.h"
+#include "binary_utils.h"
+#include "output_buffer.h"
+#include "ply_parser.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+namespace CMTL {
+namespace io {
+namespace internal {
+
+/* append a value in ascii or binary format */
+template <typename V>
+void write_ply_value(OutputBuffer& fout, bool binary, V v) {
+  if (binary)
+    write_little_endian(fout, v);
+  else
+    fout << v;
+}
+
+/* drop the properties whose size does not match the element count */
+inline std::vector<std::pair<std::string, const std::vector<double>*>>
+valid_ply_properties(const std::map<std::string, std::vector<double>>& columns,
+                     size_t count) {
+  std::vector<std::pair<std::string, const std::vector<double>*>> valid;
+  for (const auto& column : columns) {
+    if (column.second.size() == count)
+      valid.emplace_back(column.first, &column.second);
+    else
+      std::cerr << "ply property " << column.first
+                << " has wrong size, ignored." << std::endl;
+  }
+  return valid;
+}
+
+/**
+ * @brief write vertices and faces into .ply format
+ * @tparam Coord float or double, type of coordinates in the file
+ * @param coords 3 coordinates of each vertex
+ * @param offsets face i is made of indices[offsets[i], offsets[i + 1])
+ * @param indices vertex indices of faces
+ * @param properties scalar properties of vertices and faces
+ * @param binary binary little endian format if true, otherwise ascii
+ */
+template <typename Coord>
+void write_ply(std::ostream& out, const std::vector<Coord>& coords,
+               const std::vector<unsigned>& offsets,
+               const std::vector<unsigned>& indices,
+               const PlyProperties& properties, bool binary) {
+  size_t n_vertices = coords.size() / 3;
+  size_t n_faces = offsets.size() - 1;
+  auto vertex_columns = valid_ply_properties(properties.vertex, n_vertices);
+  auto face_columns = valid_ply_properties(properties.face, n_faces);
+  unsigned max_degree = 0;
+  for (size_t f = 0; f < n_faces; ++f)
+    max_degree = std::max(max_degree, offsets[f + 1] - offsets[f]);
+  bool small_degree = max_degree < 256;
+  const char* coord_type =
+      std::is_same<Coord, float>::value ? "float" : "double";
+
+  OutputBuffer fout(out);
+  fout << "ply\n"
+       << (binary ? "format binary_little_endian 1.0\n" : "format ascii 1.0\n")
+       << "element vertex " << n_vertices << '\n';
+  for (const char* axis : {"x", "y", "z"})
+    fout << "property " << coord_type << ' ' << axis << '\n';
+  for (const auto& column : vertex_columns)
+    fout << "property double " << column.first << '\n';
+  fout << "element face " << n_faces << '\n'
+       << "property list " << (small_degree ? "uchar" : "uint")
+       << " int vertex_indices\n";
+  for (const auto& column : face_columns)
+    fout << "property double " << column.first << '\n';
+  fout << "end_header\n";
+
+  // vertex block
+  if (binary && vertex_columns.empty() && is_little_endian()) {
+    fout.write(reinterpret_cast<const char*>(coords.data()),
+               coords.size() * sizeof(Coord));
+  } else {
+    for (size_t v = 0; v < n_vertices; ++v) {
+      for (unsigned k = 0; k < 3; ++k) {
+        if (!binary && k > 0) fout << ' ';
+        write_ply_value(fout, binary, coords[3 * v + k]);
+      }
+      for (const auto& column : vertex_columns) {
+        if (!binary) fout << ' ';
+        write_ply_value(fout, binary, (*column.second)[v]);
+      }
+      if (!binary) fout << '\n';
+    }
+  }
+
+  for (size_t f = 0; f < n_faces; ++f) {
+    unsigned degree = offsets[f + 1] - offsets[f];
+    if (small_degree)
+      write_ply_value(fout, binary, static_cast<uint8_t>(degree));
+    else
+      write_ply_value(fout, binary, static_cast<uint32_t>(degree));
+    for (unsigned i = offsets[f]; i < offsets[f + 1]; ++i) {
+      if (!binary) fout << ' ';
+      write_ply_value(fout, binary, static_cast<int32_t>(indices[i]));
+    }
+    for (const auto& column : face_columns) {
+      if (!binary) fout << ' ';
+      write_ply_value(fout, binary, (*column.second)[f]);
+    }
+    if (!binary) fout << '\n';
+  }
+}
+
+/* coordinate type written into .ply file for number type T */
+template <typename T>
+using ply_coord_t =
+    typename std::conditional<std::is_same<T, float>::value, float,
+                              double>::type;
+
+/* append the coordinates of a point converted into the file type */
+template <typename Coord, typename T>
+void append_ply_coords(std::vector<Coord>& coords, const T& x, const T& y,
+                       const T& z) {
+  coords.push_back(static_cast<Coord>(to_double(x)));
+  coords.push_back(static_cast<Coord>(to_double(y)));
+  coords.push_back(static_cast<Coord>(to_double(z)));
+}
+
+}  // namespace internal
+}  // namespace io
+}  // namespace CMTL
+
+#endif  // __io_common_ply_writer__
@@ -0,0 +1,155 @@
+#ifndef __io_common_scanner__
+#define __io_common_scanner__
+
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <type_traits>
+
+namespace CMTL {
+namespace io {
+
+/**
+ * @brief pointer based scanner of a text buffer, used by the readers instead
+ * of std::istream
+ */
+class Scanner {
+ public:
+  Scanner(const char* begin, const char* end) : _cur(begin), _end(end) {}
+
+ public:
+  /** @brief current position */
+  const char* position() const { return _cur; }
+
+  /**
+   * @brief check whether the rest of the buffer may hold a number of records
+   * of some values, each value takes at least a digit and a separator, used to
+   * bound the counts read from headers
+   */
+  bool can_hold(size_t n_records, size_t n_values) const {
+    size_t remaining = _cur < _end ? static_cast<size_t>(_end - _cur) : 0;
+    // the last value may end the buffer without a separator
+    return n_records <= (remaining + 1) / (2 * n_values);
+  }
+
+  /** @brief check whether the whole buffer has been scanned */
+  bool eof() const { return _cur >= _end; }
+
+  /** @brief check whether the current line has been scanned */
+  bool eol() const { return _cur >= _end || *_cur == '\n' || *_cur == '\r'; }
+
+  /** @brief skip spaces and tabs in current line */
+  void skip_spaces() {
+    while (_cur < _end && (*_cur == ' ' || *_cur == '\t')) ++_cur;
+  }
+
+  /** @brief skip the rest of current line and the line break */
+  void next_line() {
+    const char* p = static_cast<const char*>(
+        std::memchr(_cur, '\n', static_cast<size_t>(_end - _cur)));
+    _cur = p ? p + 1 : _end;
+  }
+
+  /**
+   * @brief skip a character if it is the current one
+   * @return true if skipped
+   */
+  bool consume(char c) {
+    if (_cur >= _end || *_cur != c) return false;
+    ++_cur;
+    return true;
+  }
+
+  /**
+   * @brief move to the next line with content, empty lines and lines
+   * starting with '#' are skipped
+   * @return false if the buffer has no more content
+   */
+  bool next_record() {
+    while (!eof()) {
+      skip_spaces();
+      if (!eol() && *_cur != '#') return true;
+      next_line();
+    }
+    return false;
+  }
+
+  /** @brief skip characters until a space or the end of line */
+  void skip_token() {
+    while (_cur < _end && !is_space(*_cur)) ++_cur;
+  }
+
+  /**
+   * @brief read a token in current line
+   * @return false if the line has no more tokens
+   */
+  bool token(const char*& begin, const char*& end) {
+    skip_spaces();
+    begin = _cur;
+    skip_token();
+    end = _cur;
+    return begin != end;
+  }
+
+  /**
+   * @brief read a number in current line, arithmetic types are parsed by
+   * std::from_chars, other types such as mpq_class by operator>>, or from
+   * double if operator>> can not read the whole token (e.g. "0.5" for mpq)
+   * @return false if there is no number or the number is malformed
+   */
+  template <typename T>
+  bool number(T& v) {
+    skip_spaces();
+    const char* p = _cur;
+    if (p < _end && *p == '+') ++p;
+    if constexpr (std::is_arithmetic<T>::value) {
+      auto result = std::from_chars(p, _end, v);
+      if (result.ec != std::errc()) return false;
+      _cur = result.ptr;
+      return true;
+    } else {
+      const char* begin = _cur;
+      skip_token();
+      if (begin == _cur) return false;
+      std::istringstream stream(std::string(begin, _cur));
+      stream >> v;
+      if (!stream.fail() && stream.peek() == EOF) return true;
+      double d;
+      auto result = std::from_chars(p, _cur, d);
+      if (result.ec != std::errc() || result.ptr != _cur) return false;
+      v = T(d);
+      return true;
+    }
+  }
+
+  /** @brief count the lines starting with key, leading spaces are ignored */
+  static size_t count_lines(const char* begin, const char* end,
+                            const char* key) {
+    size_t n = 0, key_size = std::strlen(key);
+    Scanner scanner(begin, end);
+    while (!scanner.eof()) {
+      scanner.skip_spaces();
+      const char* p = scanner.position();
+      if (static_cast<size_t>(end - p) > key_size &&
+          std::memcmp(p, key, key_size) == 0 && is_space(p[key_size]))
+        ++n;
+      scanner.next_line();
+    }
+    return n;
+  }
+
+  static bool is_space(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+  }
+
+ private:
+  const char* _cur;
+  const char* _end;
+};
+
+}  // namespace io
+}  // namespace CMTL
+
+#endif  // __io_common_scanner__
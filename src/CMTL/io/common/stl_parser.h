@@ -0,0 +1,132 @@
+#ifndef __io_common_stl_parser__
+#define __io_common_stl_parser__
+
+#include "binary_utils.h"
+#include "scanner.h"
+#include "vertex_welder.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+namespace CMTL {
+namespace io {
+namespace internal {
+
+/* check whether the content is a binary .stl file, ascii files start with
+ * "solid" but some binary files do too, so the size is checked first */
+inline bool is_binary_stl(const char* begin, const char* end) {
+  size_t size = end - begin;
+  if (size < 84) return false;
+  uint32_t n_triangles = read_little_endian<uint32_t>(begin + 80);
+  return size == 84 + 50 * static_cast<size_t>(n_triangles);
+}
+
+/* add a welded triangle, degenerated triangles are dropped */
+inline void add_stl_triangle(const unsigned* tri,
+                             std::vector<unsigned>& offsets,
+                             std::vector<unsigned>& indices) {
+  if (tri[0] == tri[1] || tri[1] == tri[2] || tri[2] == tri[0]) return;
+  indices.insert(indices.end(), tri, tri + 3);
+  offsets.push_back(indices.size());
+}
+
+/* parse the triangles of a binary .stl file */
+inline bool parse_binary_stl(const char* begin, const char* end,
+                             VertexWelder& welder,
+                             std::vector<unsigned>& offsets,
+                             std::vector<unsigned>& indices) {
+  uint32_t n_triangles = read_little_endian<uint32_t>(begin + 80);
+  offsets.reserve(n_triangles + 1);
+  indices.reserve(3 * static_cast<size_t>(n_triangles));
+  const char* p = begin + 84;
+  for (uint32_t t = 0; t < n_triangles; ++t, p += 50) {
+    // skip the facet normal, it is recomputed from the vertices
+    unsigned tri[3];
+    for (unsigned k = 0; k < 3; ++k) {
+      const char* v = p + 12 + 12 * k;
+      tri[k] = welder.insert(read_little_endian<float>(v),
+                             read_little_endian<float>(v + 4),
+                             read_little_endian<float>(v + 8));
+    }
+    add_stl_triangle(tri, offsets, indices);
+  }
+  return p == end;
+}
+
+/* parse the triangles of an ascii .stl file */
+inline bool parse_ascii_stl(const char* begin, const char* end,
+                            VertexWelder& welder,
+                            std::vector<unsigned>& offsets,
+                            std::vector<unsigned>& indices) {
+  Scanner scanner(begin, end);
+  const char *key, *key_end;
+  unsigned tri[3], n = 0;
+  for (; !scanner.eof(); scanner.next_line()) {
+    if (!scanner.token(key, key_end)) continue;
+    size_t size = key_end - key;
+    if (size == 6 && std::memcmp(key, "vertex", 6) == 0) {
+      double x, y, z;
+      if (n == 3 || !scanner.number(x) || !scanner.number(y) ||
+          !scanner.number(z))
+        return false;
+      tri[n++] = welder.insert(x, y, z);
+    } else if (size == 8 && std::memcmp(key, "endfacet", 8) == 0) {
+      if (n != 3) return false;
+      add_stl_triangle(tri, offsets, indices);
+      n = 0;
+    }
+  }
+  return n == 0;
+}
+
+/**
+ * @brief parse the triangles of binary or ascii .stl content, the vertices of
+ * the triangles are welded and degenerated triangles are dropped
+ * @param epsilon vertices closer than epsilon are welded, only identical
+ * vertices are welded if 0
+ * @param points welded vertex points
+ * @param offsets face i is made of indices[offsets[i], offsets[i + 1])
+ * @param indices vertex indices of faces
+ * @return true if sucessfully parsed, otherwise false
+ */
+template <typename Point>
+bool parse_stl(const char* begin, const char* end, double epsilon,
+               std::vector<Point>& points, std::vector<unsigned>& offsets,
+               std::vector<unsigned>& indices) {
+  points.clear();
+  offsets.assign(1, 0);
+  indices.clear();
+
+  bool binary = is_binary_stl(begin, end);
+  if (!binary && (end - begin < 5 || std::memcmp(begin, "solid", 5) != 0)) {
+    std::cerr << "error while reading stl header." << std::endl;
+    return false;
+  }
+
+  // a closed triangle mesh has about half as many vertices as triangles
+  size_t n_triangles =
+      binary ? read_little_endian<uint32_t>(begin + 80) : (end - begin) / 256;
+  VertexWelder welder(epsilon, n_triangles / 2 + 1);
+  bool ok = binary ? parse_binary_stl(begin, end, welder, offsets, indices)
+                   : parse_ascii_stl(begin, end, welder, offsets, indices);
+  if (!ok) {
+    std::cerr << "error while reading stl facet." << std::endl;
+    return false;
+  }
+
+  points.resize(welder.size());
+  for (unsigned i = 0; i < welder.size(); ++i) {
+    const double* c = welder.coords(i);
+    points[i] = Point(c[0], c[1], c[2]);
+  }
+  return true;
+}
+
+}  // namespace internal
+}  // namespace io
+}  // namespace CMTL
+
+#endif  // __io_common_stl_parser__
@@ -0,0 +1,48 @@
+#ifndef __io_common_surface_mesh_builder__
+#define __io_common_surface_mesh_builder__
+
+#include <vector>
+
+namespace CMTL {
+namespace io {
+namespace internal {
+
+/* build a surface mesh from parsed points and faces, face_ids receives the
+ * face index of each input face in the mesh, -1 if it can not be added */
+template <typename SurfaceMesh>
+void build_surface_mesh(SurfaceMesh& sm,
+                        const std::vector<typename SurfaceMesh::Point>& points,
+                        const std::vector<unsigned>& offsets,
+                        const std::vector<unsigned>& indices,
+                        std::vector<int>* face_ids = nullptr) {
+  typedef typename SurfaceMesh::VertexHandle VertexHandle;
+
+  sm.clear();
+  unsigned n_faces = offsets.size() - 1;
+  sm.reserve(points.size(), points.size() + n_faces, n_faces);
+  for (unsigned i = 0; i < points.size(); ++i) sm.add_vertex(points[i]);
+
+  // fall back to add faces one by one if they are not manifold
+  if (sm.add_faces(offsets, indices)) {
+    if (face_ids) {
+      face_ids->resize(n_faces);
+      for (unsigned f = 0; f < n_faces; ++f) (*face_ids)[f] = f;
+    }
+  } else {
+    if (face_ids) face_ids->assign(n_faces, -1);
+    std::vector<VertexHandle> fvhs;
+    for (unsigned f = 0; f < n_faces; ++f) {
+      fvhs.clear();
+      for (unsigned i = offsets[f]; i < offsets[f + 1]; ++i)
+        fvhs.push_back(VertexHandle(indices[i]));
+      auto fh = sm.add_face(fvhs);
+      if (face_ids) (*face_ids)[f] = fh.idx();
+    }
+  }
+}
+
+}  // namespace internal
+}  // namespace io
+}  // namespace CMTL
+
+#endif  // __io_common_surface_mesh_builder__
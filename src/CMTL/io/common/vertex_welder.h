@@ -0,0 +1,147 @@
+#ifndef __io_common_vertex_welder__
+#define __io_common_vertex_welder__
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+
+namespace CMTL {
+namespace io {
+
+/**
+ * @brief merge identical or close vertices with a spatial hash, used by the
+ * readers of formats without shared vertices such as .stl
+ * @note with a positive epsilon a vertex is merged into the first inserted
+ * vertex within epsilon, so the result depends on the insertion order
+ */
+class VertexWelder {
+ public:
+  /**
+   * @brief constructor
+   * @param epsilon vertices closer than epsilon are merged, only identical
+   * vertices are merged if epsilon is 0
+   * @param expected expected number of welded vertices
+   */
+  explicit VertexWelder(double epsilon = 0, size_t expected = 0)
+      : _epsilon(epsilon) {
+    _cells.reserve(expected);
+    _coords.reserve(3 * expected);
+    _next.reserve(expected);
+  }
+
+ public:
+  /**
+   * @brief insert a vertex
+   * @return index of the welded vertex
+   */
+  unsigned insert(double x, double y, double z) {
+    // avoid -0 and 0 to be different keys
+    x += 0.0, y += 0.0, z += 0.0;
+    Cell cell = cell_of(x, y, z);
+    if (_epsilon > 0) {
+      // the first inserted one of all the vertices within epsilon
+      unsigned first = INVALID;
+      for (int64_t dx = -1; dx <= 1; ++dx)
+        for (int64_t dy = -1; dy <= 1; ++dy)
+          for (int64_t dz = -1; dz <= 1; ++dz) {
+            Cell c = {cell.x + dx, cell.y + dy, cell.z + dz};
+            unsigned found = find(c, x, y, z);
+            if (found < first) first = found;
+          }
+      if (first != INVALID) return first;
+    } else {
+      unsigned found = find(cell, x, y, z);
+      if (found != INVALID) return found;
+    }
+
+    unsigned index = _next.size();
+    _coords.push_back(x);
+    _coords.push_back(y);
+    _coords.push_back(z);
+    auto it = _cells.emplace(cell, INVALID).first;
+    _next.push_back(it->second);
+    it->second = index;
+    return index;
+  }
+
+  /** @brief number of welded vertices */
+  size_t size() const { return _next.size(); }
+
+  /** @brief coordinates of welded vertex i, 3 doubles */
+  const double* coords(unsigned i) const { return &_coords[3 * i]; }
+
+ private:
+  static constexpr unsigned INVALID = ~0u;
+
+  struct Cell {
+    int64_t x, y, z;
+
+    bool operator==(const Cell& c) const {
+      return x == c.x && y == c.y && z == c.z;
+    }
+  };
+
+  struct CellHash {
+    size_t operator()(const Cell& c) const {
+      uint64_t h = static_cast<uint64_t>(c.x) * 0x9E3779B97F4A7C15ull;
+      h ^= static_cast<uint64_t>(c.y) + 0x9E3779B97F4A7C15ull + (h << 6) +
+           (h >> 2);
+      h ^= static_cast<uint64_t>(c.z) + 0x9E3779B97F4A7C15ull + (h << 6) +
+           (h >> 2);
+      return static_cast<size_t>(h);
+    }
+  };
+
+  /* grid coordinate of a coordinate, clamped so that the cast is defined and
+   * the neighbor offsets do not overflow, NaN goes to the lowest cell */
+  int64_t grid_of(double c) const {
+    c = std::floor(c / _epsilon);
+    c = c > -0x1p62 ? (c < 0x1p62 ? c : 0x1p62) : -0x1p62;
+    return static_cast<int64_t>(c);
+  }
+
+  /* grid cell of a point, or the bit pattern if only identical points are
+   * welded */
+  Cell cell_of(double x, double y, double z) const {
+    Cell cell;
+    if (_epsilon > 0) {
+      cell.x = grid_of(x);
+      cell.y = grid_of(y);
+      cell.z = grid_of(z);
+    } else {
+      std::memcpy(&cell.x, &x, sizeof(double));
+      std::memcpy(&cell.y, &y, sizeof(double));
+      std::memcpy(&cell.z, &z, sizeof(double));
+    }
+    return cell;
+  }
+
+  /* find the first inserted vertex of a cell which can be welded with the
+   * point, the vertices of a cell are listed from the last inserted */
+  unsigned find(const Cell& cell, double x, double y, double z) const {
+    auto it = _cells.find(cell);
+    if (it == _cells.end()) return INVALID;
+    unsigned first = INVALID;
+    for (unsigned i = it->second; i != INVALID; i = _next[i]) {
+      const double* p = coords(i);
+      double dx = p[0] - x, dy = p[1] - y, dz = p[2] - z;
+      if (dx * dx + dy * dy + dz * dz <= _epsilon * _epsilon) first = i;
+    }
+    return first;
+  }
+
+ private:
+  double _epsilon;
+  /* first vertex of each non-empty cell */
+  std::unordered_map<Cell, unsigned, CellHash> _cells;
+  /* next vertex in the same cell */
+  std::vector<unsigned> _next;
+  std::vector<double> _coords;
+};
+
+}  // namespace io
+}  // namespace CMTL
+
+#endif  // __io_common_vertex_welder__
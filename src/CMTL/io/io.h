@@ -2,10 +2,22 @@
 #define __algorithm_io__
 
 #include "polygon/write_obj.h"
+#include "polygon_soup/read_obj.h"
+#include "polygon_soup/read_off.h"
+#include "polygon_soup/read_ply.h"
 #include "polygon_soup/write_obj.h"
+#include "polygon_soup/write_ply.h"
 #include "polyline/write_obj.h"
+#include "pslg/read_poly.h"
+#include "surface_mesh/read_cmesh.h"
 #include "surface_mesh/read_obj.h"
+#include "surface_mesh/read_off.h"
+#include "surface_mesh/read_ply.h"
+#include "surface_mesh/read_stl.h"
+#include "surface_mesh/write_cmesh.h"
 #include "surface_mesh/write_obj.h"
+#include "surface_mesh/write_ply.h"
+#include "surface_mesh/write_stl.h"
 
 namespace CMTL {
 namespace algorithm {}  // namespace algorithm
@@ -1,10 +1,10 @@
 #ifndef __io_polygon_write_obj__
 #define __io_polygon_write_obj__
 
+#include "../../common/numeric_utils.h"
 #include "../../geo2d/polygon.h"
 #include "../../geo3d/polygon.h"
-
-#include <fstream>
+#include "../common/output_buffer.h"
 
 namespace CMTL {
 
@@ -16,50 +16,65 @@ namespace io {
 /**
  * @brief export a 2d polygon into .obj format
  * @param poly 2d simple polygon
- * @param file target .obj file position
+ * @param out target stream
  */
 template <typename T>
-void write_obj(const geo2d::Polygon<T>& poly, const std::string& file) {
-  std::ofstream fout;
-  fout.open(file.c_str(), std::ofstream::trunc);
-
+void write_obj(const geo2d::Polygon<T>& poly, std::ostream& out) {
+  OutputBuffer fout(out);
   for (unsigned i = 0; i < poly.size(); ++i) {
     const geo2d::Point<T>& p = poly[i];
-    fout << "v " << std::setprecision(15) << to_double(p[0]) << " \t"
-         << to_double(p[1]) << " \t " << 0 << '\n';
+    fout << "v " << to_double(p[0]) << ' ' << to_double(p[1]) << " 0\n";
   }
-  fout << std::endl;
+  fout << '\n';
 
-  fout << "f";
-  for (unsigned i = 0; i < poly.size(); ++i) fout << " " << i + 1;
+  fout << 'f';
+  for (unsigned i = 0; i < poly.size(); ++i) fout << ' ' << i + 1;
+  fout << '\n';
+}
 
-  fout.close();
+/**
+ * @brief export a 2d polygon into .obj format
+ * @param poly 2d simple polygon
+ * @param file target .obj file position
+ */
+template <typename T>
+void write_obj(const geo2d::Polygon<T>& poly, const std::string& file) {
+  std::ofstream fout(file.c_str(), std::ofstream::trunc);
+  write_obj(poly, fout);
 }
 
 /**
  * @brief export a 3d polygon into .obj format
  * @param poly 3d simple polygon
- * @param file target .obj file position
+ * @param out target stream
  */
 template <typename T>
-void write_obj(const geo3d::Polygon<T>& poly, const std::string& file) {
-  std::ofstream fout;
-  fout.open(file.c_str(), std::ofstream::trunc);
-
+void write_obj(const geo3d::Polygon<T>& poly, std::ostream& out) {
+  OutputBuffer fout(out);
   for (unsigned i = 0; i < poly.size(); ++i) {
     const geo3d::Point<T>& p = poly[i];
-    fout << "v " << std::setprecision(15) << to_double(p[0]) << " \t"
-         << to_double(p[1]) << " \t " << to_double(p[2]) << '\n';
+    fout << "v " << to_double(p[0]) << ' ' << to_double(p[1]) << ' '
+         << to_double(p[2]) << '\n';
   }
-  fout << std::endl;
+  fout << '\n';
 
-  fout << "f";
-  for (unsigned i = 0; i < poly.size(); ++i) fout << " " << i + 1;
+  fout << 'f';
+  for (unsigned i = 0; i < poly.size(); ++i) fout << ' ' << i + 1;
+  fout << '\n';
+}
 
-  fout.close();
+/**
+ * @brief export a 3d polygon into .obj format
+ * @param poly 3d simple polygon
+ * @param file target .obj file position
+ */
+template <typename T>
+void write_obj(const geo3d::Polygon<T>& poly, const std::string& file) {
+  std::ofstream fout(file.c_str(), std::ofstream::trunc);
+  write_obj(poly, fout);
 }
 
 }  // namespace io
 }  // namespace CMTL
 
-#endif  // __io_polygon_write_obj__
\ No newline at end of file
+#endif  // __io_polygon_write_obj__
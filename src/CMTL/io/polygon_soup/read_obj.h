@@ -0,0 +1,73 @@
+#ifndef __io_polygon_soup_read_obj__
+#define __io_polygon_soup_read_obj__
+
+#include "../../geo3d/polygon_soup.h"
+#include "../common/mapped_file.h"
+#include "../common/obj_parser.h"
+
+namespace CMTL {
+namespace io {
+
+namespace internal {
+
+/* read a polygon soup from .obj content with n_threads threads */
+template <typename T>
+bool read_polygon_soup(geo3d::PolygonSoup<T>& soup, const char* begin,
+                       const char* end, unsigned n_threads) {
+  std::vector<geo3d::Point<T>> points;
+  std::vector<unsigned> offsets, indices;
+  if (!parse_obj(begin, end, n_threads, points, offsets, indices)) {
+    soup = geo3d::PolygonSoup<T>();
+    return false;
+  }
+  soup = geo3d::PolygonSoup<T>(std::move(points), std::move(offsets),
+                               std::move(indices));
+  return true;
+}
+
+}  // namespace internal
+
+/**
+ * @brief build a 3d polygon soup form .obj format file
+ * @param soup polygon soup
+ * @param file target .obj file position
+ * @return true if sucessfully import, otherwise false
+ */
+template <typename T>
+bool read_obj(geo3d::PolygonSoup<T>& soup, const std::string& file) {
+  MappedFile in(file);
+
+  if (!in.is_open()) {
+    std::cerr << "error while opening file " << file << std::endl;
+    return false;
+  }
+
+  return internal::read_polygon_soup(soup, in.begin(), in.end(), 1);
+}
+
+/**
+ * @brief build a 3d polygon soup form .obj format file with multiple threads,
+ * the result is the same as read_obj
+ * @param soup polygon soup
+ * @param file target .obj file position
+ * @param n_threads number of threads, decided by file size if 0
+ * @return true if sucessfully import, otherwise false
+ */
+template <typename T>
+bool read_obj_parallel(geo3d::PolygonSoup<T>& soup, const std::string& file,
+                       unsigned n_threads = 0) {
+  MappedFile in(file);
+
+  if (!in.is_open()) {
+    std::cerr << "error while opening file " << file << std::endl;
+    return false;
+  }
+
+  if (n_threads == 0) n_threads = default_threads(in.size(), 1 << 20);
+  return internal::read_polygon_soup(soup, in.begin(), in.end(), n_threads);
+}
+
+}  // namespace io
+}  // namespace CMTL
+
+#endif  // __io_polygon_soup_read_obj__
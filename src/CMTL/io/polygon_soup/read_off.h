@@ -0,0 +1,65 @@
+#ifndef __io_polygon_soup_read_off__
+#define __io_polygon_soup_read_off__
+
+#include "../../geo2d/polygon_soup.h"
+#include "../../geo3d/polygon_soup.h"
+#include "../common/mapped_file.h"
+#include "../common/off_parser.h"
+
+namespace CMTL {
+namespace io {
+
+namespace internal {
+
+/* read a polygon soup from an .off file */
+template <typename PolygonSoup, typename Point>
+bool read_polygon_soup_off(PolygonSoup& soup, const std::string& file) {
+  MappedFile in(file);
+
+  if (!in.is_open()) {
+    std::cerr << "error while opening file " << file << std::endl;
+    return false;
+  }
+
+  std::vector<Point> points;
+  std::vector<unsigned> offsets, indices;
+  if (!parse_off(in.begin(), in.end(), points, offsets, indices)) {
+    soup = PolygonSoup();
+    return false;
+  }
+  soup = PolygonSoup(std::move(points), std::move(offsets),
+                     std::move(indices));
+  return true;
+}
+
+}  // namespace internal
+
+/**
+ * @brief build a 2d polygon soup from .off format file, the z coordinates
+ * are ignored
+ * @param soup polygon soup
+ * @param file target .off file position
+ * @return true if sucessfully import, otherwise false
+ */
+template <typename T>
+bool read_off(geo2d::PolygonSoup<T>& soup, const std::string& file) {
+  return internal::read_polygon_soup_off<geo2d::PolygonSoup<T>,
+                                         geo2d::Point<T>>(soup, file);
+}
+
+/**
+ * @brief build a 3d polygon soup from .off format file
+ * @param soup polygon soup
+ * @param file target .off file position
+ * @return true if sucessfully import, otherwise false
+ */
+template <typename T>
+bool read_off(geo3d::PolygonSoup<T>& soup, const std::string& file) {
+  return internal::read_polygon_soup_off<geo3d::PolygonSoup<T>,
+                                         geo3d::Point<T>>(soup, file);
+}
+
+}  // namespace io
+}  // namespace CMTL
+
+#endif  // __io_polygon_soup_read_off__
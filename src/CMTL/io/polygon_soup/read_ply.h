@@ -0,0 +1,97 @@
+#ifndef __io_polygon_soup_read_ply__
+#define __io_polygon_soup_read_ply__
+
+#include "../../geo2d/polygon_soup.h"
+#include "../../geo3d/polygon_soup.h"
+#include "../common/mapped_file.h"
+#include "../common/ply_parser.h"
+
+namespace CMTL {
+namespace io {
+
+namespace internal {
+
+/* read a polygon soup from a .ply file */
+template <typename PolygonSoup, typename Point>
+bool read_polygon_soup_ply(PolygonSoup& soup, const std::string& file,
+                           PlyProperties& properties) {
+  MappedFile in(file);
+
+  if (!in.is_open()) {
+    std::cerr << "error while opening file " << file << std::endl;
+    return false;
+  }
+
+  std::vector<Point> points;
+  std::vector<unsigned> offsets, indices;
+  if (!parse_ply(in.begin(), in.end(), points, offsets, indices,
+                 properties)) {
+    soup = PolygonSoup();
+    return false;
+  }
+  soup = PolygonSoup(std::move(points), std::move(offsets),
+                     std::move(indices));
+  return true;
+}
+
+}  // namespace internal
+
+/**
+ * @brief build a 2d polygon soup from ascii or binary .ply format file, the z
+ * coordinates are ignored
+ * @param soup polygon soup
+ * @param file target .ply file position
+ * @param properties other scalar properties of vertices and faces
+ * @return true if sucessfully import, otherwise false
+ */
+template <typename T>
+bool read_ply(geo2d::PolygonSoup<T>& soup, const std::string& file,
+              PlyProperties& properties) {
+  return internal::read_polygon_soup_ply<geo2d::PolygonSoup<T>,
+                                         geo2d::Point<T>>(soup, file,
+                                                          properties);
+}
+
+/**
+ * @brief build a 2d polygon soup from ascii or binary .ply format file
+ * @param soup polygon soup
+ * @param file target .ply file position
+ * @return true if sucessfully import, otherwise false
+ */
+template <typename T>
+bool read_ply(geo2d::PolygonSoup<T>& soup, const std::string& file) {
+  PlyProperties properties;
+  return read_ply(soup, file, properties);
+}
+
+/**
+ * @brief build a 3d polygon soup from ascii or binary .ply format file
+ * @param soup polygon soup
+ * @param file target .ply file position
+ * @param properties other scalar properties of vertices and faces
+ * @return true if sucessfully import, otherwise false
+ */
+template <typename T>
+bool read_ply(geo3d::PolygonSoup<T>& soup, const std::string& file,
+              PlyProperties& properties) {
+  return internal::read_polygon_soup_ply<geo3d::PolygonSoup<T>,
+                                         geo3d::Point<T>>(soup, file,
+                                                          properties);
+}
+
+/**
+ * @brief build a 3d polygon soup from ascii or binary .ply format file
+ * @param soup polygon soup
+ * @param file target .ply file position
+ * @return true if sucessfully import, otherwise false
+ */
+template <typename T>
+bool read_ply(geo3d::PolygonSoup<T>& soup, const std::string& file) {
+  PlyProperties properties;
+  return read_ply(soup, file, properties);
+}
+
+}  // namespace io
+}  // namespace CMTL
+
+#endif  // __io_polygon_soup_read_ply__
@@ -1,75 +1,86 @@
 #ifndef __io_polygon_soup_write_obj__
 #define __io_polygon_soup_write_obj__
 
+#include "../../common/numeric_utils.h"
 #include "../../geo2d/polygon_soup.h"
 #include "../../geo3d/polygon_soup.h"
-
-#include <fstream>
+#include "../common/output_buffer.h"
 
 namespace CMTL {
 namespace io {
 
+namespace internal {
+
+/* write the polygons of a polygon soup */
+template <typename PolygonSoup>
+void write_obj_polygons(const PolygonSoup& poly, OutputBuffer& fout) {
+  for (unsigned i = 0; i < poly.n_polygons(); ++i) {
+    const auto& polygon = poly.polygon(i);
+    if (polygon.empty()) continue;
+    fout << 'f';
+    for (unsigned j = 0; j < polygon.size(); ++j) fout << ' ' << polygon[j] + 1;
+    fout << '\n';
+  }
+}
+
+}  // namespace internal
+
 /**
  * @brief export a 2d polygon soup into .obj format
  * @param poly 2d simple polygon soup
- * @param file target .obj file position
+ * @param out target stream
  */
 template <typename T>
-void write_obj(const geo2d::PolygonSoup<T>& poly, const std::string& file) {
-  std::ofstream fout;
-  fout.open(file.c_str(), std::ofstream::trunc);
-
+void write_obj(const geo2d::PolygonSoup<T>& poly, std::ostream& out) {
+  OutputBuffer fout(out);
   for (unsigned i = 0; i < poly.n_points(); ++i) {
     const geo2d::Point<T>& p = poly.point(i);
-    fout << "v " << std::setprecision(15) << to_double(p[0]) << " \t"
-         << to_double(p[1]) << " \t " << 0 << '\n';
-  }
-  fout << std::endl;
-
-  for (unsigned i = 0; i < poly.n_polygons(); ++i) {
-    const std::vector<unsigned>& polygon = poly.polygon(i);
-    if (polygon.empty()) continue;
-    fout << "f";
-    for (unsigned j = 0; j < polygon.size(); ++j) {
-      fout << " " << polygon[j] + 1;
-    }
-    fout << std::endl;
+    fout << "v " << to_double(p[0]) << ' ' << to_double(p[1]) << " 0\n";
   }
+  fout << '\n';
+  internal::write_obj_polygons(poly, fout);
+}
 
-  fout.close();
+/**
+ * @brief export a 2d polygon soup into .obj format
+ * @param poly 2d simple polygon soup
+ * @param file target .obj file position
+ */
+template <typename T>
+void write_obj(const geo2d::PolygonSoup<T>& poly, const std::string& file) {
+  std::ofstream fout(file.c_str(), std::ofstream::trunc);
+  write_obj(poly, fout);
 }
 
 /**
  * @brief export a 3d polygon soup into .obj format
  * @param poly 3d simple polygon soup
- * @param file target .obj file position
+ * @param out target stream
  */
 template <typename T>
-void write_obj(const geo3d::PolygonSoup<T>& poly, const std::string& file) {
-  std::ofstream fout;
-  fout.open(file.c_str(), std::ofstream::trunc);
-
+void write_obj(const geo3d::PolygonSoup<T>& poly, std::ostream& out) {
+  OutputBuffer fout(out);
   for (unsigned i = 0; i < poly.n_points(); ++i) {
     const geo3d::Point<T>& p = poly.point(i);
-    fout << "v " << std::setprecision(15) << to_double(p[0]) << " \t"
-         << to_double(p[1]) << " \t " << to_double(p[2]) << '\n';
-  }
-  fout << std::endl;
-
-  for (unsigned i = 0; i < poly.n_polygons(); ++i) {
-    const std::vector<unsigned>& polygon = poly.polygon(i);
-    if (polygon.empty()) continue;
-    fout << "f";
-    for (unsigned j = 0; j < polygon.size(); ++j) {
-      fout << " " << polygon[j] + 1;
-    }
-    fout << std::endl;
+    fout << "v " << to_double(p[0]) << ' ' << to_double(p[1]) << ' '
+         << to_double(p[2]) << '\n';
   }
+  fout << '\n';
+  internal::write_obj_polygons(poly, fout);
+}
 
-  fout.close();
+/**
+ * @brief export a 3d polygon soup into .obj format
+ * @param poly 3d simple polygon soup
+ * @param file target .obj file position
+ */
+template <typename T>
+void write_obj(const geo3d::PolygonSoup<T>& poly, const std::string& file) {
+  std::ofstream fout(file.c_str(), std::ofstream::trunc);
+  write_obj(poly, fout);
 }
 
 }  // namespace io
 }  // namespace CMTL
 
-#endif  // __io_polygon_soup_write_obj__
\ No newline at end of file
+#endif  // __io_polygon_soup_write_obj__
@@ -0,0 +1,96 @@
+#ifndef __io_polygon_soup_write_ply__
+#define __io_polygon_soup_write_ply__
+
+#include "../../geo2d/polygon_soup.h"
+#include "../../geo3d/polygon_soup.h"
+#include "../common/ply_writer.h"
+
+#include <fstream>
+
+namespace CMTL {
+namespace io {
+
+/**
+ * @brief export a 2d polygon soup into .ply format with z = 0, exact number
+ * types are converted to double
+ * @param soup polygon soup
+ * @param out target stream, should be opened in binary mode
+ * @param properties scalar properties of vertices and faces, columns of wrong
+ * size are ignored
+ * @param binary binary little endian format if true, otherwise ascii
+ */
+template <typename T>
+void write_ply(const geo2d::PolygonSoup<T>& soup, std::ostream& out,
+               const PlyProperties& properties = PlyProperties(),
+               bool binary = true) {
+  typedef internal::ply_coord_t<T> Coord;
+  std::vector<Coord> coords;
+  coords.reserve(3 * soup.n_points());
+  for (unsigned i = 0; i < soup.n_points(); ++i) {
+    const geo2d::Point<T>& p = soup.point(i);
+    internal::append_ply_coords(coords, p[0], p[1], T(0));
+  }
+  internal::write_ply(out, coords, soup.offsets(), soup.indices(), properties,
+                      binary);
+}
+
+/**
+ * @brief export a 2d polygon soup into .ply format with z = 0
+ * @param soup polygon soup
+ * @param file target .ply file position
+ * @param properties scalar properties of vertices and faces
+ * @param binary binary little endian format if true, otherwise ascii
+ */
+template <typename T>
+void write_ply(const geo2d::PolygonSoup<T>& soup, const std::string& file,
+               const PlyProperties& properties = PlyProperties(),
+               bool binary = true) {
+  std::ofstream fout(file.c_str(),
+                     std::ofstream::trunc | std::ofstream::binary);
+  write_ply(soup, fout, properties, binary);
+}
+
+/**
+ * @brief export a 3d polygon soup into .ply format, exact number types are
+ * converted to double
+ * @param soup polygon soup
+ * @param out target stream, should be opened in binary mode
+ * @param properties scalar properties of vertices and faces, columns of wrong
+ * size are ignored
+ * @param binary binary little endian format if true, otherwise ascii
+ */
+template <typename T>
+void write_ply(const geo3d::PolygonSoup<T>& soup, std::ostream& out,
+               const PlyProperties& properties = PlyProperties(),
+               bool binary = true) {
+  typedef internal::ply_coord_t<T> Coord;
+  std::vector<Coord> coords;
+  coords.reserve(3 * soup.n_points());
+  for (unsigned i = 0; i < soup.n_points(); ++i) {
+    const geo3d::Point<T>& p = soup.point(i);
+    internal::append_ply_coords(coords, p[0], p[1], p[2]);
+  }
+  internal::write_ply(out, coords, soup.offsets(), soup.indices(), properties,
+                      binary);
+}
+
+/**
+ * @brief export a 3d polygon soup into .ply format
+ * @param soup polygon soup
+ * @param file target .ply file position
+ * @param properties scalar properties of vertices and faces
+ * @param binary binary little endian format if true, otherwise ascii
+ */
+template <typename T>
+void write_ply(const geo3d::PolygonSoup<T>& soup, const std::string& file,
+               const PlyProperties& properties = PlyProperties(),
+               bool binary = true) {
+  std::ofstream fout(file.c_str(),
+                     std::ofstream::trunc | std::ofstream::binary);
+  write_ply(soup, fout, properties, binary);
+}
+
+}  // namespace io
+}  // namespace CMTL
+
+#endif  // __io_polygon_soup_write_ply__
@@ -2,37 +2,50 @@
 #define __io_polyline_write_obj__
 
 #include "../../common/numeric_utils.h"
+#include "../common/output_buffer.h"
 
-#include <fstream>
 #include <vector>
 
 namespace CMTL {
 namespace io {
 
+/**
+ * @brief export segments into .obj format
+ * @param edges segments given by end points
+ * @param out target stream
+ */
 template <typename Point>
 void write_obj(const std::vector<std::pair<Point, Point>>& edges,
-               const std::string& file) {
-  std::ofstream fout;
-  fout.open(file.c_str(), std::ofstream::trunc);
-
+               std::ostream& out) {
+  OutputBuffer fout(out);
   for (size_t i = 0; i < edges.size(); ++i) {
-    for (const Point& p : {edges[i].first, edges[i].second}) {
-      if (p.size() == 2)
-        fout << "v " << std::setprecision(15) << to_double(p[0]) << " \t"
-             << to_double(p[1]) << " \t " << 0 << '\n';
+    for (const Point* p : {&edges[i].first, &edges[i].second}) {
+      fout << "v " << to_double((*p)[0]) << ' ' << to_double((*p)[1]) << ' ';
+      if (p->size() == 2)
+        fout << '0';
       else
-        fout << "v " << std::setprecision(15) << to_double(p[0]) << " \t"
-             << to_double(p[1]) << " \t " << to_double(p[2]) << '\n';
+        fout << to_double((*p)[2]);
+      fout << '\n';
     }
   }
 
   for (size_t i = 0; i < edges.size(); ++i)
-    fout << "l " << 2 * i + 1 << " " << 2 * i + 2 << std::endl;
+    fout << "l " << 2 * i + 1 << ' ' << 2 * i + 2 << '\n';
+}
 
-  fout.close();
+/**
+ * @brief export segments into .obj format
+ * @param edges segments given by end points
+ * @param file target .obj file position
+ */
+template <typename Point>
+void write_obj(const std::vector<std::pair<Point, Point>>& edges,
+               const std::string& file) {
+  std::ofstream fout(file.c_str(), std::ofstream::trunc);
+  write_obj(edges, fout);
 }
 
 }  // namespace io
 }  // namespace CMTL
 
-#endif  // __io_polyline_write_obj__
\ No newline at end of file
+#endif  // __io_polyline_write_obj__
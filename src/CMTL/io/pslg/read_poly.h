@@ -0,0 +1,169 @@
+#ifndef __io_pslg_read_poly__
+#define __io_pslg_read_poly__
+
+#include "../../geo2d/pslg.h"
+#include "../common/mapped_file.h"
+#include "../common/scanner.h"
+
+namespace CMTL {
+namespace io {
+
+namespace internal {
+
+/* parse a node section of a .node or .poly file, the first index decides
+ * whether the file is 0-based or 1-based */
+template <typename T>
+bool parse_triangle_nodes(Scanner& scanner, geo2d::PSLG<T>& pslg,
+                          int& base) {
+  unsigned n, dim, n_attributes, n_markers;
+  if (!scanner.next_record() || !scanner.number(n) || !scanner.number(dim) ||
+      !scanner.number(n_attributes) || !scanner.number(n_markers) ||
+      (n > 0 && dim != 2))
+    return false;
+  scanner.next_line();
+
+  // index and coordinates
+  if (!scanner.can_hold(n, 3)) return false;
+  pslg._points.resize(n);
+  for (unsigned i = 0; i < n; ++i, scanner.next_line()) {
+    int idx;
+    // attributes and markers are ignored
+    if (!scanner.next_record() || !scanner.number(idx) ||
+        !scanner.number(pslg._points[i][0]) ||
+        !scanner.number(pslg._points[i][1]))
+      return false;
+    if (i == 0) base = idx;
+  }
+  return true;
+}
+
+/* parse the segment and hole sections of a .poly file */
+template <typename T>
+bool parse_triangle_segments(Scanner& scanner, geo2d::PSLG<T>& pslg,
+                             int base) {
+  unsigned n, n_markers;
+  if (!scanner.next_record() || !scanner.number(n) ||
+      !scanner.number(n_markers))
+    return false;
+  scanner.next_line();
+
+  // index and end points
+  if (!scanner.can_hold(n, 3)) return false;
+  pslg._segments.resize(n);
+  pslg._segmentmarks.assign(n, 0);
+  for (unsigned i = 0; i < n; ++i, scanner.next_line()) {
+    int idx, a, b;
+    if (!scanner.next_record() || !scanner.number(idx) || !scanner.number(a) ||
+        !scanner.number(b) || a < base || b < base)
+      return false;
+    pslg._segments[i] = std::make_pair(a - base, b - base);
+    if (n_markers > 0 && !scanner.number(pslg._segmentmarks[i])) return false;
+  }
+
+  // the hole section may be missing in some files
+  if (!scanner.next_record()) return true;
+  if (!scanner.number(n)) return false;
+  scanner.next_line();
+  if (!scanner.can_hold(n, 3)) return false;
+  pslg._holes.resize(n);
+  for (unsigned i = 0; i < n; ++i, scanner.next_line()) {
+    int idx;
+    if (!scanner.next_record() || !scanner.number(idx) ||
+        !scanner.number(pslg._holes[i][0]) ||
+        !scanner.number(pslg._holes[i][1]))
+      return false;
+  }
+  return true;
+}
+
+/* check that the segments refer to existing points */
+template <typename T>
+bool check_pslg_segments(const geo2d::PSLG<T>& pslg) {
+  for (const auto& seg : pslg._segments)
+    if (seg.first >= pslg._points.size() || seg.second >= pslg._points.size())
+      return false;
+  return true;
+}
+
+/* read the points of a .node file */
+template <typename T>
+bool read_node_points(geo2d::PSLG<T>& pslg, const std::string& file,
+                      int& base) {
+  MappedFile in(file);
+
+  if (!in.is_open()) {
+    std::cerr << "error while opening file " << file << std::endl;
+    return false;
+  }
+
+  Scanner scanner(in.begin(), in.end());
+  if (!parse_triangle_nodes(scanner, pslg, base)) {
+    std::cerr << "error while reading node vertex." << std::endl;
+    return false;
+  }
+  return true;
+}
+
+}  // namespace internal
+
+/**
+ * @brief read the points of Triangle's .node format file into a pslg, the
+ * segments and holes are cleared
+ * @param pslg planar straight line graph
+ * @param file target .node file position
+ * @return true if sucessfully import, otherwise false
+ */
+template <typename T>
+bool read_node(geo2d::PSLG<T>& pslg, const std::string& file) {
+  pslg = geo2d::PSLG<T>();
+  int base = 0;
+  if (internal::read_node_points(pslg, file, base)) return true;
+  pslg = geo2d::PSLG<T>();
+  return false;
+}
+
+/**
+ * @brief read Triangle's .poly format file into a pslg, including points,
+ * segments with markers and holes, the points are read from the .node file
+ * with the same base name if the .poly file has no point
+ * @param pslg planar straight line graph
+ * @param file target .poly file position
+ * @return true if sucessfully import, otherwise false
+ */
+template <typename T>
+bool read_poly(geo2d::PSLG<T>& pslg, const std::string& file) {
+  pslg = geo2d::PSLG<T>();
+  MappedFile in(file);
+
+  if (!in.is_open()) {
+    std::cerr << "error while opening file " << file << std::endl;
+    return false;
+  }
+
+  Scanner scanner(in.begin(), in.end());
+  int base = 0;
+  if (!internal::parse_triangle_nodes(scanner, pslg, base)) {
+    std::cerr << "error while reading poly vertex." << std::endl;
+    pslg = geo2d::PSLG<T>();
+    return false;
+  }
+  if (pslg._points.empty()) {
+    std::string node_file = file.substr(0, file.find_last_of('.')) + ".node";
+    if (!internal::read_node_points(pslg, node_file, base)) {
+      pslg = geo2d::PSLG<T>();
+      return false;
+    }
+  }
+  if (!internal::parse_triangle_segments(scanner, pslg, base) ||
+      !internal::check_pslg_segments(pslg)) {
+    std::cerr << "error while reading poly segment." << std::endl;
+    pslg = geo2d::PSLG<T>();
+    return false;
+  }
+  return true;
+}
+
+}  // namespace io
+}  // namespace CMTL
+
+#endif  // __io_pslg_read_poly__
@@ -0,0 +1,57 @@
+#ifndef __io_surface_mesh_read_cmesh__
+#define __io_surface_mesh_read_cmesh__
+
+#include "../../geo2d/surface_mesh.h"
+#include "../../geo3d/surface_mesh.h"
+#include "../common/cmesh_format.h"
+#include "../common/mapped_file.h"
+
+namespace CMTL {
+namespace io {
+
+/**
+ * @brief load a 2d surface mesh from native binary .cmesh format file written
+ * by write_cmesh, no halfedge construction is needed
+ * @param sm surface mesh
+ * @param file target .cmesh file position
+ * @return true if sucessfully import, otherwise false
+ * @note the file must be written with the same number type, traits and byte
+ * order
+ */
+template <typename T, class Traits = geo2d::SurfaceMeshTraits>
+bool read_cmesh(geo2d::SurfaceMesh<T, Traits>& sm, const std::string& file) {
+  MappedFile in(file);
+
+  if (!in.is_open()) {
+    std::cerr << "error while opening file " << file << std::endl;
+    return false;
+  }
+
+  return internal::read_cmesh(sm, in.begin(), in.end());
+}
+
+/**
+ * @brief load a 3d surface mesh from native binary .cmesh format file written
+ * by write_cmesh, no halfedge construction is needed
+ * @param sm surface mesh
+ * @param file target .cmesh file position
+ * @return true if sucessfully import, otherwise false
+ * @note the file must be written with the same number type, traits and byte
+ * order
+ */
+template <typename T, class Traits = geo3d::SurfaceMeshTraits>
+bool read_cmesh(geo3d::SurfaceMesh<T, Traits>& sm, const std::string& file) {
+  MappedFile in(file);
+
+  if (!in.is_open()) {
+    std::cerr << "error while opening file " << file << std::endl;
+    return false;
+  }
+
+  return internal::read_cmesh(sm, in.begin(), in.end());
+}
+
+}  // namespace io
+}  // namespace CMTL
+
+#endif  // __io_surface_mesh_read_cmesh__
@@ -3,8 +3,12 @@
 
 #include "../../geo2d/surface_mesh.h"
 #include "../../geo3d/surface_mesh.h"
+#include "../common/mapped_file.h"
+#include "../common/obj_parser.h"
+#include "../common/surface_mesh_builder.h"
 
 #include <fstream>
+#include <iterator>
 
 namespace CMTL {
 namespace io {
@@ -22,73 +26,93 @@ inline void trim_line_string(std::string& str) {
     str = str.substr(start, end - start + 1);
 }
 
+namespace internal {
+
+/* copy the corner values of the parsed faces onto the halfedges */
 template <typename SurfaceMesh>
-bool read_surface_mesh(SurfaceMesh& sm, std::istream& in) {
-  sm.clear();
-
-  typedef typename SurfaceMesh::VertexHandle VertexHandle;
-  typedef typename SurfaceMesh::Point Point;
-
-  std::vector<VertexHandle> vhandles;
-  std::vector<VertexHandle> fvhs;
-
-  std::string line;
-  std::string key;
-  std::stringstream stream;
-  while (in && !in.eof()) {
-    std::getline(in, line);
-    if (in.bad()) {
-      std::cerr << "error while reading obj line." << std::endl;
-      return false;
+void assign_obj_corners(const SurfaceMesh& sm,
+                        const std::vector<unsigned>& offsets,
+                        const std::vector<unsigned>& indices,
+                        const std::vector<int>& face_ids,
+                        const ObjCornerData& data,
+                        ObjCornerAttributes& corners) {
+  unsigned nh = sm.n_halfedges();
+  corners.uv.assign(data.uvs.empty() ? 0 : 2 * nh, 0.0);
+  corners.normal.assign(data.normals.empty() ? 0 : 3 * nh, 0.0);
+  for (unsigned f = 0; f < face_ids.size(); ++f) {
+    if (face_ids[f] < 0) continue;
+    unsigned first = offsets[f], degree = offsets[f + 1] - first;
+    auto heh = sm.halfedge_handle(sm.face_handle(face_ids[f]));
+    // the face halfedges follow the corner order from any start
+    unsigned k = 0;
+    while (indices[first + k] !=
+           static_cast<unsigned>(sm.to_vertex_handle(heh).idx()))
+      ++k;
+    for (unsigned n = 0; n < degree; ++n) {
+      unsigned corner = first + (k + n) % degree, h = heh.idx();
+      int uv = data.uv_indices[corner], normal = data.normal_indices[corner];
+      if (uv >= 0 && !corners.uv.empty())
+        std::copy(&data.uvs[2 * uv], &data.uvs[2 * uv] + 2,
+                  &corners.uv[2 * h]);
+      if (normal >= 0 && !corners.normal.empty())
+        std::copy(&data.normals[3 * normal], &data.normals[3 * normal] + 3,
+                  &corners.normal[3 * h]);
+      heh = sm.next_halfedge_handle(heh);
     }
+  }
+}
 
-    trim_line_string(line);
-
-    if (line.empty() || line[0] == '#' || isspace(line[0])) continue;
-
-    stream.str(line);
-    stream.clear();
-    stream >> key;
-
-    if (key == "v") {
-      Point p;
-      stream >> p[0];
-      stream >> p[1];
-      if (Point::dimension() == 3) stream >> p[2];
-      if (stream.bad() || stream.fail()) {
-        std::cerr << "error while reading obj vertex." << std::endl;
-        return false;
-      }
-      vhandles.push_back(sm.add_vertex(p));
-    } else if (key == "f") {
-      int vid;
-      fvhs.clear();
-      while (stream >> vid) {
-        if (vid > static_cast<int>(vhandles.size()) || vid == 0) {
-          std::cerr << "error while reading obj face." << std::endl;
-          return false;
-        }
-        if (vid < 0)
-          fvhs.push_back(vhandles[static_cast<int>(vhandles.size()) + vid]);
-        else
-          fvhs.push_back(vhandles[vid - 1]);
-
-        // we only read vertex in "v/vt/vn" format
-        stream.ignore(256, ' ');
-      }
-      if (stream.bad()) {
-        std::cerr << "error while reading obj face." << std::endl;
-        return false;
-      }
-      sm.add_face(fvhs);
-    } else if (key == "vt") {
-      // TODO
-    } else if (key == "vn") {
-      // TODO
-    }
+/* read a surface mesh from .obj content with n_threads threads, the corner
+ * texture coordinates and normals are read if corners is not null */
+template <typename SurfaceMesh>
+bool read_surface_mesh(SurfaceMesh& sm, const char* begin, const char* end,
+                       unsigned n_threads,
+                       ObjCornerAttributes* corners = nullptr) {
+  std::vector<typename SurfaceMesh::Point> points;
+  std::vector<unsigned> offsets, indices;
+  ObjCornerData data;
+  if (!parse_obj(begin, end, n_threads, points, offsets, indices,
+                 corners ? &data : nullptr)) {
+    sm.clear();
+    return false;
   }
+  std::vector<int> face_ids;
+  build_surface_mesh(sm, points, offsets, indices,
+                     corners ? &face_ids : nullptr);
+  if (corners)
+    assign_obj_corners(sm, offsets, indices, face_ids, data, *corners);
+  return true;
+}
 
-  return !in.fail();
+}  // namespace internal
+
+/**
+ * @brief build a surface mesh from the content of an .obj file
+ * @param sm surface mesh
+ * @param begin begin of the file content
+ * @param end end of the file content
+ * @return true if sucessfully import, otherwise false
+ */
+template <typename SurfaceMesh>
+bool read_surface_mesh(SurfaceMesh& sm, const char* begin, const char* end) {
+  return internal::read_surface_mesh(sm, begin, end, 1);
+}
+
+/**
+ * @brief build a surface mesh from an .obj format stream
+ * @param sm surface mesh
+ * @param in input stream
+ * @return true if sucessfully import, otherwise false
+ */
+template <typename SurfaceMesh>
+bool read_surface_mesh(SurfaceMesh& sm, std::istream& in) {
+  std::string content((std::istreambuf_iterator<char>(in)),
+                      std::istreambuf_iterator<char>());
+  if (in.bad()) {
+    std::cerr << "error while reading obj stream." << std::endl;
+    return false;
+  }
+  return read_surface_mesh(sm, content.data(), content.data() + content.size());
 }
 
 /**
@@ -99,17 +123,14 @@ bool read_surface_mesh(SurfaceMesh& sm, std::istream& in) {
  */
 template <typename T>
 bool read_obj(geo2d::SurfaceMesh<T>& sm, const std::string& file) {
-  std::fstream in(file.c_str(), std::ios_base::in);
+  MappedFile in(file);
 
-  if (!in.is_open() || !in.good()) {
+  if (!in.is_open()) {
     std::cerr << "error while opening file " << file << std::endl;
     return false;
   }
 
-  bool result = read_surface_mesh(sm, in);
-  in.close();
-
-  return result;
+  return read_surface_mesh(sm, in.begin(), in.end());
 }
 
 /**
@@ -120,17 +141,100 @@ bool read_obj(geo2d::SurfaceMesh<T>& sm, const std::string& file) {
  */
 template <typename T>
 bool read_obj(geo3d::SurfaceMesh<T>& sm, const std::string& file) {
-  std::fstream in(file.c_str(), std::ios_base::in);
+  MappedFile in(file);
+
+  if (!in.is_open()) {
+    std::cerr << "error while opening file " << file << std::endl;
+    return false;
+  }
+
+  return read_surface_mesh(sm, in.begin(), in.end());
+}
+
+/**
+ * @brief build a 2d surface mesh form .obj format file with the texture
+ * coordinates and normals of the face corners
+ * @param sm surface mesh
+ * @param file target .obj file position
+ * @param corners per halfedge vt and vn values
+ * @return true if sucessfully import, otherwise false
+ */
+template <typename T>
+bool read_obj(geo2d::SurfaceMesh<T>& sm, const std::string& file,
+              ObjCornerAttributes& corners) {
+  MappedFile in(file);
 
-  if (!in.is_open() || !in.good()) {
+  if (!in.is_open()) {
     std::cerr << "error while opening file " << file << std::endl;
     return false;
   }
 
-  bool result = read_surface_mesh(sm, in);
-  in.close();
+  return internal::read_surface_mesh(sm, in.begin(), in.end(), 1, &corners);
+}
+
+/**
+ * @brief build a 3d surface mesh form .obj format file with the texture
+ * coordinates and normals of the face corners
+ * @param sm surface mesh
+ * @param file target .obj file position
+ * @param corners per halfedge vt and vn values
+ * @return true if sucessfully import, otherwise false
+ */
+template <typename T>
+bool read_obj(geo3d::SurfaceMesh<T>& sm, const std::string& file,
+              ObjCornerAttributes& corners) {
+  MappedFile in(file);
+
+  if (!in.is_open()) {
+    std::cerr << "error while opening file " << file << std::endl;
+    return false;
+  }
+
+  return internal::read_surface_mesh(sm, in.begin(), in.end(), 1, &corners);
+}
+
+/**
+ * @brief build a 2d surface mesh form .obj format file with multiple threads,
+ * the result is the same as read_obj
+ * @param sm surface mesh
+ * @param file target .obj file position
+ * @param n_threads number of threads, decided by file size if 0
+ * @return true if sucessfully import, otherwise false
+ */
+template <typename T>
+bool read_obj_parallel(geo2d::SurfaceMesh<T>& sm, const std::string& file,
+                       unsigned n_threads = 0) {
+  MappedFile in(file);
+
+  if (!in.is_open()) {
+    std::cerr << "error while opening file " << file << std::endl;
+    return false;
+  }
+
+  if (n_threads == 0) n_threads = default_threads(in.size(), 1 << 20);
+  return internal::read_surface_mesh(sm, in.begin(), in.end(), n_threads);
+}
+
+/**
+ * @brief build a 3d surface mesh form .obj format file with multiple threads,
+ * the result is the same as read_obj
+ * @param sm surface mesh
+ * @param file target .obj file position
+ * @param n_threads number of threads, decided by file size if 0
+ * @return true if sucessfully import, otherwise false
+ */
+template <typename T>
+bool read_obj_parallel(geo3d::SurfaceMesh<T>& sm, const std::string& file,
+                       unsigned n_threads = 0) {
+  MappedFile in(file);
+
+  if (!in.is_open()) {
+    std::cerr << "error while opening file " << file << std::endl;
+    return false;
+  }
 
-  return result;
+  if (n_threads == 0) n_threads = default_threads(in.size(), 1 << 20);
+  return internal::read_surface_mesh(sm, in.begin(), in.end(), n_threads);
 }
 
 }  // namespace io
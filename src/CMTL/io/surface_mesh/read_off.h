@@ -0,0 +1,63 @@
+#ifndef __io_surface_mesh_read_off__
+#define __io_surface_mesh_read_off__
+
+#include "../../geo2d/surface_mesh.h"
+#include "../../geo3d/surface_mesh.h"
+#include "../common/mapped_file.h"
+#include "../common/off_parser.h"
+#include "../common/surface_mesh_builder.h"
+
+namespace CMTL {
+namespace io {
+
+namespace internal {
+
+/* read a surface mesh from an .off file */
+template <typename SurfaceMesh>
+bool read_surface_mesh_off(SurfaceMesh& sm, const std::string& file) {
+  MappedFile in(file);
+
+  if (!in.is_open()) {
+    std::cerr << "error while opening file " << file << std::endl;
+    return false;
+  }
+
+  std::vector<typename SurfaceMesh::Point> points;
+  std::vector<unsigned> offsets, indices;
+  if (!parse_off(in.begin(), in.end(), points, offsets, indices)) {
+    sm.clear();
+    return false;
+  }
+  build_surface_mesh(sm, points, offsets, indices);
+  return true;
+}
+
+}  // namespace internal
+
+/**
+ * @brief build a 2d surface mesh from .off format file, the z coordinates
+ * are ignored
+ * @param sm surface mesh
+ * @param file target .off file position
+ * @return true if sucessfully import, otherwise false
+ */
+template <typename T>
+bool read_off(geo2d::SurfaceMesh<T>& sm, const std::string& file) {
+  return internal::read_surface_mesh_off(sm, file);
+}
+
+/**
+ * @brief build a 3d surface mesh from .off format file
+ * @param sm surface mesh
+ * @param file target .off file position
+ * @return true if sucessfully import, otherwise false
+ */
+template <typename T>
+bool read_off(geo3d::SurfaceMesh<T>& sm, const std::string& file) {
+  return internal::read_surface_mesh_off(sm, file);
+}
+
+}  // namespace io
+}  // namespace CMTL
+
+#endif  // __io_surface_mesh_read_off__
@@ -0,0 +1,93 @@
+#ifndef __io_surface_mesh_read_ply__
+#define __io_surface_mesh_read_ply__
+
+#include "../../geo2d/surface_mesh.h"
+#include "../../geo3d/surface_mesh.h"
+#include "../common/mapped_file.h"
+#include "../common/ply_parser.h"
+#include "../common/surface_mesh_builder.h"
+
+namespace CMTL {
+namespace io {
+
+namespace internal {
+
+/* read a surface mesh from a .ply file */
+template <typename SurfaceMesh>
+bool read_surface_mesh_ply(SurfaceMesh& sm, const std::string& file,
+                           PlyProperties& properties) {
+  MappedFile in(file);
+
+  if (!in.is_open()) {
+    std::cerr << "error while opening file " << file << std::endl;
+    return false;
+  }
+
+  std::vector<typename SurfaceMesh::Point> points;
+  std::vector<unsigned> offsets, indices;
+  if (!parse_ply(in.begin(), in.end(), points, offsets, indices,
+                 properties)) {
+    sm.clear();
+    return false;
+  }
+  build_surface_mesh(sm, points, offsets, indices);
+  return true;
+}
+
+}  // namespace internal
+
+/**
+ * @brief build a 2d surface mesh from ascii or binary .ply format file, the z
+ * coordinates are ignored
+ * @param sm surface mesh
+ * @param file target .ply file position
+ * @param properties other scalar properties of vertices and faces
+ * @return true if sucessfully import, otherwise false
+ */
+template <typename T>
+bool read_ply(geo2d::SurfaceMesh<T>& sm, const std::string& file,
+              PlyProperties& properties) {
+  return internal::read_surface_mesh_ply(sm, file, properties);
+}
+
+/**
+ * @brief build a 2d surface mesh from ascii or binary .ply format file
+ * @param sm surface mesh
+ * @param file target .ply file position
+ * @return true if sucessfully import, otherwise false
+ */
+template <typename T>
+bool read_ply(geo2d::SurfaceMesh<T>& sm, const std::string& file) {
+  PlyProperties properties;
+  return internal::read_surface_mesh_ply(sm, file, properties);
+}
+
+/**
+ * @brief build a 3d surface mesh from ascii or binary .ply format file
+ * @param sm surface mesh
+ * @param file target .ply file position
+ * @param properties other scalar properties of vertices and faces
+ * @return true if sucessfully import, otherwise false
+ */
+template <typename T>
+bool read_ply(geo3d::SurfaceMesh<T>& sm, const std::string& file,
+              PlyProperties& properties) {
+  return internal::read_surface_mesh_ply(sm, file, properties);
+}
+
+/**
+ * @brief build a 3d surface mesh from ascii or binary .ply format file
+ * @param sm surface mesh
+ * @param file target .ply file position
+ * @return true if sucessfully import, otherwise false
+ */
+template <typename T>
+bool read_ply(geo3d::SurfaceMesh<T>& sm, const std::string& file) {
+  PlyProperties properties;
+  return internal::read_surface_mesh_ply(sm, file, properties);
+}
+
+}  // namespace io
+}  // namespace CMTL
+
+#endif  // __io_surface_mesh_read_ply__
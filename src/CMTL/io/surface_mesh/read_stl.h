@@ -0,0 +1,46 @@
+#ifndef __io_surface_mesh_read_stl__
+#define __io_surface_mesh_read_stl__
+
+#include "../../geo3d/surface_mesh.h"
+#include "../common/mapped_file.h"
+#include "../common/stl_parser.h"
+#include "../common/surface_mesh_builder.h"
+
+namespace CMTL {
+namespace io {
+
+/**
+ * @brief build a 3d surface mesh from binary or ascii .stl format file, the
+ * unshared triangle vertices are welded with a spatial hash and degenerated
+ * triangles are dropped
+ * @param sm surface mesh
+ * @param file target .stl file position
+ * @param epsilon vertices closer than epsilon are welded, only identical
+ * vertices are welded if 0
+ * @return true if sucessfully import, otherwise false
+ */
+template <typename T>
+bool read_stl(geo3d::SurfaceMesh<T>& sm, const std::string& file,
+              double epsilon = 0) {
+  MappedFile in(file);
+
+  if (!in.is_open()) {
+    std::cerr << "error while opening file " << file << std::endl;
+    return false;
+  }
+
+  std::vector<geo3d::Point<T>> points;
+  std::vector<unsigned> offsets, indices;
+  if (!internal::parse_stl(in.begin(), in.end(), epsilon, points, offsets,
+                           indices)) {
+    sm.clear();
+    return false;
+  }
+  internal::build_surface_mesh(sm, points, offsets, indices);
+  return true;
+}
+
+}  // namespace io
+}  // namespace CMTL
+
+#endif  // __io_surface_mesh_read_stl__
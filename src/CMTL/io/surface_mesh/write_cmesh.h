@@ -0,0 +1,64 @@
+#ifndef __io_surface_mesh_write_cmesh__
+#define __io_surface_mesh_write_cmesh__
+
+#include "../../geo2d/surface_mesh.h"
+#include "../../geo3d/surface_mesh.h"
+#include "../common/cmesh_format.h"
+
+#include <fstream>
+
+namespace CMTL {
+namespace io {
+
+/**
+ * @brief dump a 2d surface mesh into native binary .cmesh format, the
+ * vertex, edge and face arrays are written as they are in memory
+ * @param sm surface mesh with arithmetic number type
+ * @param out target stream, should be opened in binary mode
+ */
+template <typename T, class Traits = geo2d::SurfaceMeshTraits>
+void write_cmesh(const geo2d::SurfaceMesh<T, Traits>& sm, std::ostream& out) {
+  internal::write_cmesh(sm, out);
+}
+
+/**
+ * @brief dump a 2d surface mesh into native binary .cmesh format
+ * @param sm surface mesh with arithmetic number type
+ * @param file target .cmesh file position
+ */
+template <typename T, class Traits = geo2d::SurfaceMeshTraits>
+void write_cmesh(const geo2d::SurfaceMesh<T, Traits>& sm,
+                 const std::string& file) {
+  std::ofstream fout(file.c_str(),
+                     std::ofstream::trunc | std::ofstream::binary);
+  internal::write_cmesh(sm, fout);
+}
+
+/**
+ * @brief dump a 3d surface mesh into native binary .cmesh format, the
+ * vertex, edge and face arrays are written as they are in memory
+ * @param sm surface mesh with arithmetic number type
+ * @param out target stream, should be opened in binary mode
+ */
+template <typename T, class Traits = geo3d::SurfaceMeshTraits>
+void write_cmesh(const geo3d::SurfaceMesh<T, Traits>& sm, std::ostream& out) {
+  internal::write_cmesh(sm, out);
+}
+
+/**
+ * @brief dump a 3d surface mesh into native binary .cmesh format
+ * @param sm surface mesh with arithmetic number type
+ * @param file target .cmesh file position
+ */
+template <typename T, class Traits = geo3d::SurfaceMeshTraits>
+void write_cmesh(const geo3d::SurfaceMesh<T, Traits>& sm,
+                 const std::string& file) {
+  std::ofstream fout(file.c_str(),
+                     std::ofstream::trunc | std::ofstream::binary);
+  internal::write_cmesh(sm, fout);
+}
+
+}  // namespace io
+}  // namespace CMTL
+
+#endif  // __io_surface_mesh_write_cmesh__
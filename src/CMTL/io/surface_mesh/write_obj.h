@@ -3,71 +3,200 @@
 
 #include "../../geo2d/surface_mesh.h"
 #include "../../geo3d/surface_mesh.h"
-
-#include <fstream>
+#include "../common/obj_corner_attributes.h"
+#include "../common/output_buffer.h"
 
 namespace CMTL {
 namespace io {
 
+namespace internal {
+
+/* write the faces of a surface mesh */
+template <typename SurfaceMesh>
+void write_obj_faces(const SurfaceMesh& sm, OutputBuffer& fout) {
+  for (auto fit = sm.faces_begin(); fit != sm.faces_end(); ++fit) {
+    fout << 'f';
+    for (auto fv = sm.fv_begin(*fit); fv != sm.fv_end(*fit); ++fv)
+      fout << ' ' << fv->idx() + 1;
+    fout << '\n';
+  }
+}
+
+/* write the corner texture coordinates and normals of a surface mesh and the
+ * faces referring to them, columns of wrong size are ignored */
+template <typename SurfaceMesh>
+void write_obj_corner_faces(const SurfaceMesh& sm,
+                            const ObjCornerAttributes& corners,
+                            OutputBuffer& fout) {
+  bool has_uv = corners.uv.size() == 2 * sm.n_halfedges();
+  bool has_normal = corners.normal.size() == 3 * sm.n_halfedges();
+  // one record per face corner, in the order of the faces
+  for (auto fit = sm.faces_begin(); has_uv && fit != sm.faces_end(); ++fit) {
+    for (auto fh = sm.fh_begin(*fit); fh != sm.fh_end(*fit); ++fh) {
+      unsigned h = fh->idx();
+      fout << "vt " << corners.uv[2 * h] << ' ' << corners.uv[2 * h + 1]
+           << '\n';
+    }
+  }
+  for (auto fit = sm.faces_begin(); has_normal && fit != sm.faces_end();
+       ++fit) {
+    for (auto fh = sm.fh_begin(*fit); fh != sm.fh_end(*fit); ++fh) {
+      unsigned h = fh->idx();
+      fout << "vn " << corners.normal[3 * h] << ' '
+           << corners.normal[3 * h + 1] << ' ' << corners.normal[3 * h + 2]
+           << '\n';
+    }
+  }
+  fout << '\n';
+
+  unsigned corner = 0;
+  for (auto fit = sm.faces_begin(); fit != sm.faces_end(); ++fit) {
+    fout << 'f';
+    for (auto fh = sm.fh_begin(*fit); fh != sm.fh_end(*fit); ++fh) {
+      fout << ' ' << sm.to_vertex_handle(*fh).idx() + 1;
+      ++corner;
+      if (has_uv && has_normal)
+        fout << '/' << corner << '/' << corner;
+      else if (has_uv)
+        fout << '/' << corner;
+      else if (has_normal)
+        fout << "//" << corner;
+    }
+    fout << '\n';
+  }
+}
+
+}  // namespace internal
+
 /**
- * @brief export a 2d surface mesh into .obj format
+ * @brief export a 2d surface mesh into .obj format, exact number types are
+ * printed in rational format
+ * @param sm surface mesh
+ * @param out target stream
+ */
+template <typename T, class Traits = geo2d::SurfaceMeshTraits>
+void write_obj(const geo2d::SurfaceMesh<T, Traits>& sm, std::ostream& out) {
+  OutputBuffer fout(out);
+  for (auto vit = sm.vertices_begin(); vit != sm.vertices_end(); ++vit) {
+    const auto& p = sm.point(*vit);
+    fout << "v " << p[0] << ' ' << p[1] << " 0\n";
+  }
+  fout << '\n';
+  internal::write_obj_faces(sm, fout);
+}
+
+/**
+ * @brief export a 2d surface mesh into .obj format, exact number types are
+ * printed in rational format
  * @param sm surface mesh
- * @param exact if exact is true, we print point into rational format
  * @param file target .obj file position
  */
 template <typename T, class Traits = geo2d::SurfaceMeshTraits>
 void write_obj(const geo2d::SurfaceMesh<T, Traits>& sm,
                const std::string& file) {
-  std::ofstream fout;
-  fout.open(file.c_str(), std::ofstream::trunc);
+  std::ofstream fout(file.c_str(), std::ofstream::trunc);
+  write_obj(sm, fout);
+}
 
+/**
+ * @brief export a 3d surface mesh into .obj format, exact number types are
+ * printed in rational format
+ * @param sm surface mesh
+ * @param out target stream
+ */
+template <typename T, class Traits = geo3d::SurfaceMeshTraits>
+void write_obj(const geo3d::SurfaceMesh<T, Traits>& sm, std::ostream& out) {
+  OutputBuffer fout(out);
   for (auto vit = sm.vertices_begin(); vit != sm.vertices_end(); ++vit) {
-    const typename geo2d::SurfaceMesh<T>::Point& p = sm.point(*vit);
-    fout << "v " << std::setprecision(15) << p[0] << " \t" << p[1] << " \t "
-         << 0 << '\n';
+    const auto& p = sm.point(*vit);
+    fout << "v " << p[0] << ' ' << p[1] << ' ' << p[2] << '\n';
   }
-  fout << std::endl;
-
-  for (auto fit = sm.faces_begin(); fit != sm.faces_end(); ++fit) {
-    fout << "f";
-    for (auto fv = sm.fv_begin(*fit); fv != sm.fv_end(*fit); ++fv) {
-      fout << " " << fv->idx() + 1;
-    }
-    fout << std::endl;
-  }
-  fout.close();
+  fout << '\n';
+  internal::write_obj_faces(sm, fout);
 }
 
 /**
- * @brief export a 3d surface mesh into .obj format
+ * @brief export a 3d surface mesh into .obj format, exact number types are
+ * printed in rational format
  * @param sm surface mesh
- * @param exact if exact is true, we print point into rational format
  * @param file target .obj file position
  */
 template <typename T, class Traits = geo3d::SurfaceMeshTraits>
 void write_obj(const geo3d::SurfaceMesh<T, Traits>& sm,
                const std::string& file) {
-  std::ofstream fout;
-  fout.open(file.c_str(), std::ofstream::trunc);
+  std::ofstream fout(file.c_str(), std::ofstream::trunc);
+  write_obj(sm, fout);
+}
 
+/**
+ * @brief export a 2d surface mesh into .obj format with the texture
+ * coordinates and normals of the face corners
+ * @param sm surface mesh
+ * @param out target stream
+ * @param corners per halfedge vt and vn values, see read_obj
+ */
+template <typename T, class Traits = geo2d::SurfaceMeshTraits>
+void write_obj(const geo2d::SurfaceMesh<T, Traits>& sm,
+               std::ostream& out, const ObjCornerAttributes& corners) {
+  OutputBuffer fout(out);
   for (auto vit = sm.vertices_begin(); vit != sm.vertices_end(); ++vit) {
-    const typename geo3d::SurfaceMesh<T>::Point& p = sm.point(*vit);
-    fout << "v " << std::setprecision(15) << p[0] << " \t" << p[1] << " \t "
-         << p[2] << '\n';
+    const auto& p = sm.point(*vit);
+    fout << "v " << p[0] << ' ' << p[1] << " 0\n";
   }
-  fout << std::endl;
+  fout << '\n';
+  internal::write_obj_corner_faces(sm, corners, fout);
+}
 
-  for (auto fit = sm.faces_begin(); fit != sm.faces_end(); ++fit) {
-    fout << "f";
-    for (auto fv = sm.fv_begin(*fit); fv != sm.fv_end(*fit); ++fv) {
-      fout << " " << fv->idx() + 1;
-    }
-    fout << std::endl;
+/**
+ * @brief export a 2d surface mesh into .obj format with the texture
+ * coordinates and normals of the face corners
+ * @param sm surface mesh
+ * @param file target .obj file position
+ * @param corners per halfedge vt and vn values, see read_obj
+ */
+template <typename T, class Traits = geo2d::SurfaceMeshTraits>
+void write_obj(const geo2d::SurfaceMesh<T, Traits>& sm,
+               const std::string& file,
+               const ObjCornerAttributes& corners) {
+  std::ofstream fout(file.c_str(), std::ofstream::trunc);
+  write_obj(sm, fout, corners);
+}
+
+/**
+ * @brief export a 3d surface mesh into .obj format with the texture
+ * coordinates and normals of the face corners
+ * @param sm surface mesh
+ * @param out target stream
+ * @param corners per halfedge vt and vn values, see read_obj
+ */
+template <typename T, class Traits = geo3d::SurfaceMeshTraits>
+void write_obj(const geo3d::SurfaceMesh<T, Traits>& sm,
+               std::ostream& out, const ObjCornerAttributes& corners) {
+  OutputBuffer fout(out);
+  for (auto vit = sm.vertices_begin(); vit != sm.vertices_end(); ++vit) {
+    const auto& p = sm.point(*vit);
+    fout << "v " << p[0] << ' ' << p[1] << ' ' << p[2] << '\n';
   }
-  fout.close();
+  fout << '\n';
+  internal::write_obj_corner_faces(sm, corners, fout);
+}
+
+/**
+ * @brief export a 3d surface mesh into .obj format with the texture
+ * coordinates and normals of the face corners
+ * @param sm surface mesh
+ * @param file target .obj file position
+ * @param corners per halfedge vt and vn values, see read_obj
+ */
+template <typename T, class Traits = geo3d::SurfaceMeshTraits>
+void write_obj(const geo3d::SurfaceMesh<T, Traits>& sm,
+               const std::string& file,
+               const ObjCornerAttributes& corners) {
+  std::ofstream fout(file.c_str(), std::ofstream::trunc);
+  write_obj(sm, fout, corners);
 }
 
 }  // namespace io
 }  // namespace CMTL
 
-#endif  // __io_surface_mesh_write_obj__
\ No newline at end of file
+#endif  // __io_surface_mesh_write_obj__
@@ -0,0 +1,118 @@
+#ifndef __io_surface_mesh_write_ply__
+#define __io_surface_mesh_write_ply__
+
+#include "../../geo2d/surface_mesh.h"
+#include "../../geo3d/surface_mesh.h"
+#include "../common/ply_writer.h"
+
+#include <fstream>
+
+namespace CMTL {
+namespace io {
+
+namespace internal {
+
+/* collect the faces of a surface mesh */
+template <typename SurfaceMesh>
+void collect_ply_faces(const SurfaceMesh& sm, std::vector<unsigned>& offsets,
+                       std::vector<unsigned>& indices) {
+  offsets.assign(1, 0);
+  offsets.reserve(sm.n_faces() + 1);
+  indices.reserve(3 * sm.n_faces());
+  for (auto fit = sm.faces_begin(); fit != sm.faces_end(); ++fit) {
+    for (auto fv = sm.fv_begin(*fit); fv != sm.fv_end(*fit); ++fv)
+      indices.push_back(fv->idx());
+    offsets.push_back(indices.size());
+  }
+}
+
+}  // namespace internal
+
+/**
+ * @brief export a 2d surface mesh into .ply format with z = 0, exact number
+ * types are converted to double
+ * @param sm surface mesh
+ * @param out target stream, should be opened in binary mode
+ * @param properties scalar properties of vertices and faces, columns of wrong
+ * size are ignored
+ * @param binary binary little endian format if true, otherwise ascii
+ */
+template <typename T, class Traits = geo2d::SurfaceMeshTraits>
+void write_ply(const geo2d::SurfaceMesh<T, Traits>& sm, std::ostream& out,
+               const PlyProperties& properties = PlyProperties(),
+               bool binary = true) {
+  typedef internal::ply_coord_t<T> Coord;
+  std::vector<Coord> coords;
+  coords.reserve(3 * sm.n_vertices());
+  for (auto vit = sm.vertices_begin(); vit != sm.vertices_end(); ++vit) {
+    const auto& p = sm.point(*vit);
+    internal::append_ply_coords(coords, p[0], p[1], T(0));
+  }
+  std::vector<unsigned> offsets, indices;
+  internal::collect_ply_faces(sm, offsets, indices);
+  internal::write_ply(out, coords, offsets, indices, properties, binary);
+}
+
+/**
+ * @brief export a 2d surface mesh into .ply format with z = 0
+ * @param sm surface mesh
+ * @param file target .ply file position
+ * @param properties scalar properties of vertices and faces
+ * @param binary binary little endian format if true, otherwise ascii
+ */
+template <typename T, class Traits = geo2d::SurfaceMeshTraits>
+void write_ply(const geo2d::SurfaceMesh<T, Traits>& sm,
+               const std::string& file,
+               const PlyProperties& properties = PlyProperties(),
+               bool binary = true) {
+  std::ofstream fout(file.c_str(),
+                     std::ofstream::trunc | std::ofstream::binary);
+  write_ply(sm, fout, properties, binary);
+}
+
+/**
+ * @brief export a 3d surface mesh into .ply format, exact number types are
+ * converted to double
+ * @param sm surface mesh
+ * @param out target stream, should be opened in binary mode
+ * @param properties scalar properties of vertices and faces, columns of wrong
+ * size are ignored
+ * @param binary binary little endian format if true, otherwise ascii
+ */
+template <typename T, class Traits = geo3d::SurfaceMeshTraits>
+void write_ply(const geo3d::SurfaceMesh<T, Traits>& sm, std::ostream& out,
+               const PlyProperties& properties = PlyProperties(),
+               bool binary = true) {
+  typedef internal::ply_coord_t<T> Coord;
+  std::vector<Coord> coords;
+  coords.reserve(3 * sm.n_vertices());
+  for (auto vit = sm.vertices_begin(); vit != sm.vertices_end(); ++vit) {
+    const auto& p = sm.point(*vit);
+    internal::append_ply_coords(coords, p[0], p[1], p[2]);
+  }
+  std::vector<unsigned> offsets, indices;
+  internal::collect_ply_faces(sm, offsets, indices);
+  internal::write_ply(out, coords, offsets, indices, properties, binary);
+}
+
+/**
+ * @brief export a 3d surface mesh into .ply format
+ * @param sm surface mesh
+ * @param file target .ply file position
+ * @param properties scalar properties of vertices and faces
+ * @param binary binary little endian format if true, otherwise ascii
+ */
+template <typename T, class Traits = geo3d::SurfaceMeshTraits>
+void write_ply(const geo3d::SurfaceMesh<T, Traits>& sm,
+               const std::string& file,
+               const PlyProperties& properties = PlyProperties(),
+               bool binary = true) {
+  std::ofstream fout(file.c_str(),
+                     std::ofstream::trunc | std::ofstream::binary);
+  write_ply(sm, fout, properties, binary);
+}
+
+}  // namespace io
+}  // namespace CMTL
+
+#endif  // __io_surface_mesh_write_ply__
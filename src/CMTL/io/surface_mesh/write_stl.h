@@ -0,0 +1,74 @@
+#ifndef __io_surface_mesh_write_stl__
+#define __io_surface_mesh_write_stl__
+
+#include "../../common/numeric_utils.h"
+#include "../../geo3d/surface_mesh.h"
+#include "../common/binary_utils.h"
+#include "../common/output_buffer.h"
+
+#include <cmath>
+#include <fstream>
+
+namespace CMTL {
+namespace io {
+
+/**
+ * @brief export a 3d surface mesh into binary .stl format, polygonal faces are
+ * split into triangle fans sharing the face normal
+ * @param sm surface mesh
+ * @param out target stream, should be opened in binary mode
+ */
+template <typename T, class Traits = geo3d::SurfaceMeshTraits>
+void write_stl(const geo3d::SurfaceMesh<T, Traits>& sm, std::ostream& out) {
+  uint32_t n_triangles = 0;
+  for (auto fit = sm.faces_begin(); fit != sm.faces_end(); ++fit)
+    n_triangles += sm.degree(*fit) - 2;
+
+  OutputBuffer fout(out);
+  char header[80] = "binary stl";
+  fout.write(header, sizeof(header));
+  internal::write_little_endian(fout, n_triangles);
+
+  std::vector<float> corners;
+  for (auto fit = sm.faces_begin(); fit != sm.faces_end(); ++fit) {
+    auto n = sm.normal(*fit);
+    double nx = to_double(n[0]), ny = to_double(n[1]), nz = to_double(n[2]);
+    double length = std::sqrt(nx * nx + ny * ny + nz * nz);
+    if (length > 0) nx /= length, ny /= length, nz /= length;
+
+    corners.clear();
+    for (auto fv = sm.fv_begin(*fit); fv != sm.fv_end(*fit); ++fv) {
+      const auto& p = sm.point(*fv);
+      for (unsigned k = 0; k < 3; ++k)
+        corners.push_back(static_cast<float>(to_double(p[k])));
+    }
+    for (unsigned i = 1; i + 1 < corners.size() / 3; ++i) {
+      internal::write_little_endian(fout, static_cast<float>(nx));
+      internal::write_little_endian(fout, static_cast<float>(ny));
+      internal::write_little_endian(fout, static_cast<float>(nz));
+      for (unsigned c : {0u, i, i + 1})
+        for (unsigned k = 0; k < 3; ++k)
+          internal::write_little_endian(fout, corners[3 * c + k]);
+      // attribute byte count
+      internal::write_little_endian(fout, uint16_t(0));
+    }
+  }
+}
+
+/**
+ * @brief export a 3d surface mesh into binary .stl format
+ * @param sm surface mesh
+ * @param file target .stl file position
+ */
+template <typename T, class Traits = geo3d::SurfaceMeshTraits>
+void write_stl(const geo3d::SurfaceMesh<T, Traits>& sm,
+               const std::string& file) {
+  std::ofstream fout(file.c_str(),
+                     std::ofstream::trunc | std::ofstream::binary);
+  write_stl(sm, fout);
+}
+
+}  // namespace io
+}  // namespace CMTL
+
+#endif  // __io_surface_mesh_write_stl__
@@ -0,0 +1,92 @@
+#ifndef __io_triangulation_write_node__
+#define __io_triangulation_write_node__
+
+#include "../../algorithm/triangulation.h"
+#include "../common/output_buffer.h"
+
+namespace CMTL {
+namespace io {
+
+/**
+ * @brief export the vertices of a triangulation into Triangle's .node
+ * format, vertices are numbered from 1 by their index
+ * @param triangulation triangulation
+ * @param out target stream
+ */
+template <typename T>
+void write_node(
+    const CMTL::algorithm::Internal::TriangulationStorage<T>& triangulation,
+    std::ostream& out) {
+  OutputBuffer fout(out);
+
+  std::vector<unsigned> perm(triangulation._vertices.size());
+  for (unsigned i = 0; i < triangulation._vertices.size(); ++i) {
+    perm[triangulation._vertices[i]->idx] = i;
+  }
+
+  fout << perm.size() << " 2 0 0\n";
+  for (unsigned i = 0; i < perm.size(); ++i) {
+    const auto& p = triangulation._vertices[perm[i]]->crd;
+    fout << i + 1 << ' ' << p[0] << ' ' << p[1] << '\n';
+  }
+}
+
+/**
+ * @brief export the vertices of a triangulation into Triangle's .node format
+ * @param triangulation triangulation
+ * @param file target .node file position
+ */
+template <typename T>
+void write_node(
+    const CMTL::algorithm::Internal::TriangulationStorage<T>& triangulation,
+    const std::string& file) {
+  std::ofstream fout(file.c_str(), std::ofstream::trunc);
+  write_node(triangulation, fout);
+}
+
+/**
+ * @brief export the non-dummy, non-hole triangles of a triangulation into
+ * Triangle's .ele format, the vertex numbers match write_node
+ * @param triangulation triangulation
+ * @param out target stream
+ */
+template <typename T>
+void write_ele(
+    const CMTL::algorithm::Internal::TriangulationStorage<T>& triangulation,
+    std::ostream& out) {
+  OutputBuffer fout(out);
+
+  unsigned n_triangles = 0;
+  for (unsigned i = 0; i < triangulation._triangles.size(); ++i)
+    if (!triangulation._triangles[i]->is_dummy() &&
+        !triangulation._triangles[i]->is_hole())
+      ++n_triangles;
+
+  fout << n_triangles << " 3 0\n";
+  unsigned count = 0;
+  for (unsigned i = 0; i < triangulation._triangles.size(); ++i) {
+    const auto& tri = triangulation._triangles[i];
+    if (tri->is_dummy() || tri->is_hole()) continue;
+    fout << ++count << ' ' << tri->vrt[0]->idx + 1 << ' '
+         << tri->vrt[1]->idx + 1 << ' ' << tri->vrt[2]->idx + 1 << '\n';
+  }
+}
+
+/**
+ * @brief export the non-dummy, non-hole triangles of a triangulation into
+ * Triangle's .ele format
+ * @param triangulation triangulation
+ * @param file target .ele file position
+ */
+template <typename T>
+void write_ele(
+    const CMTL::algorithm::Internal::TriangulationStorage<T>& triangulation,
+    const std::string& file) {
+  std::ofstream fout(file.c_str(), std::ofstream::trunc);
+  write_ele(triangulation, fout);
+}
+
+}  // namespace io
+}  // namespace CMTL
+
+#endif  // __io_triangulation_write_node__
@@ -2,18 +2,22 @@
 #define __io_triangulation_write_obj__
 
 #include "../../algorithm/triangulation.h"
-
-#include <fstream>
+#include "../common/output_buffer.h"
 
 namespace CMTL {
 namespace io {
 
+/**
+ * @brief export the non-dummy, non-hole triangles of a triangulation into
+ * .obj format
+ * @param triangulation triangulation
+ * @param out target stream
+ */
 template <typename T>
 void write_obj(
     const CMTL::algorithm::Internal::TriangulationStorage<T>& triangulation,
-    const std::string& file) {
-  std::ofstream fout;
-  fout.open(file.c_str(), std::ofstream::trunc);
+    std::ostream& out) {
+  OutputBuffer fout(out);
 
   std::vector<unsigned> perm(triangulation._vertices.size());
   for (unsigned i = 0; i < triangulation._vertices.size(); ++i) {
@@ -22,21 +26,33 @@ void write_obj(
 
   for (unsigned i = 0; i < perm.size(); ++i) {
     const auto& p = triangulation._vertices[perm[i]]->crd;
-    fout << "v " << std::setprecision(15) << p[0] << " \t" << p[1] << " \t "
-         << 0 << '\n';
+    fout << "v " << p[0] << ' ' << p[1] << " 0\n";
   }
-  fout << std::endl;
+  fout << '\n';
 
   for (unsigned i = 0; i < triangulation._triangles.size(); ++i) {
     const auto& tri = triangulation._triangles[i];
-    if (tri->is_dummy()) continue;
-    fout << "f " << tri->vrt[0]->idx + 1 << " " << tri->vrt[1]->idx + 1 << " "
-         << tri->vrt[2]->idx + 1 << std::endl;
+    if (tri->is_dummy() || tri->is_hole()) continue;
+    fout << "f " << tri->vrt[0]->idx + 1 << ' ' << tri->vrt[1]->idx + 1 << ' '
+         << tri->vrt[2]->idx + 1 << '\n';
   }
-  fout.close();
+}
+
+/**
+ * @brief export the non-dummy, non-hole triangles of a triangulation into
+ * .obj format
+ * @param triangulation triangulation
+ * @param file target .obj file position
+ */
+template <typename T>
+void write_obj(
+    const CMTL::algorithm::Internal::TriangulationStorage<T>& triangulation,
+    const std::string& file) {
+  std::ofstream fout(file.c_str(), std::ofstream::trunc);
+  write_obj(triangulation, fout);
 }
 
 }  // namespace io
 }  // namespace CMTL
 
-#endif  // __io_triangulation_write_obj__
\ No newline at end of file
+#endif  // __io_triangulation_write_obj__
@@ -1,6 +1,7 @@
 #ifndef __topologic_halfedge_h__
 #define __topologic_halfedge_h__
 
+#include <algorithm>
 #include <cassert>
 #include <iostream>
 #include <vector>
@@ -929,6 +930,35 @@ class GraphTopology {
     _faces.clear();
   }
 
+  /** @brief reserve storage for elements */
+  void reserve(unsigned nv, unsigned ne, unsigned nf) {
+    _vertices.reserve(nv);
+    _edges.reserve(ne);
+    _faces.reserve(nf);
+  }
+
+  /** @brief raw vertex items, used by binary serialization */
+  const std::vector<VertexItem>& vertex_items() const { return _vertices; }
+
+  /** @brief raw edge items, used by binary serialization */
+  const std::vector<EdgeItem>& edge_items() const { return _edges; }
+
+  /** @brief raw face items, used by binary serialization */
+  const std::vector<FaceItem>& face_items() const { return _faces; }
+
+  /**
+   * @brief replace all elements by raw items, used by binary serialization
+   * @note the items should come from vertex_items(), edge_items() and
+   * face_items() of a valid graph
+   */
+  void assign_items(const VertexItem* vertices, unsigned nv,
+                    const EdgeItem* edges, unsigned ne, const FaceItem* faces,
+                    unsigned nf) {
+    _vertices.assign(vertices, vertices + nv);
+    _edges.assign(edges, edges + ne);
+    _faces.assign(faces, faces + nf);
+  }
+
   /** @brief get i'th graph vertex */
   GraphVertexHandle vertex(VertexHandle vh) const {
     assert(vh.is_valid() && vh.idx() < (int)n_vertices());
@@ -1940,6 +1970,136 @@ class GraphTopology {
     return face(fh);
   }
 
+  /**
+   * @brief add all the faces into an empty graph at once, the edges are
+   * numbered the same as adding the faces one by one with add_face
+   * @param offsets face i is made of indices[offsets[i], offsets[i + 1])
+   * @param indices vertex indices of all the faces
+   * @return false if the graph already has edges or faces, or the faces are
+   * not manifold, the graph is not modified and add_face should be used
+   */
+  bool add_faces(const std::vector<unsigned>& offsets,
+                 const std::vector<unsigned>& indices) {
+    if (n_edges() != 0 || n_faces() != 0 || offsets.empty()) return false;
+    unsigned nv = n_vertices();
+    unsigned nf = offsets.size() - 1;
+    unsigned nc = offsets.back();
+    if (nc > indices.size()) return false;
+
+    auto next_corner = [&](unsigned f, unsigned c) {
+      return c + 1 == offsets[f + 1] ? offsets[f] : c + 1;
+    };
+
+    // bucket the corners by the smaller vertex of their edge
+    std::vector<unsigned> bucket(nv + 1, 0);
+    for (unsigned f = 0; f < nf; ++f) {
+      if (offsets[f + 1] < offsets[f] + 3) return false;
+      for (unsigned c = offsets[f]; c < offsets[f + 1]; ++c) {
+        unsigned a = indices[c], b = indices[next_corner(f, c)];
+        if (a >= nv || b >= nv || a == b) return false;
+        ++bucket[std::min(a, b) + 1];
+      }
+    }
+    for (unsigned v = 0; v < nv; ++v) bucket[v + 1] += bucket[v];
+
+    // match the corners into edges in the order add_face creates them
+    std::vector<unsigned> bucket_size(nv, 0);
+    std::vector<unsigned> bucket_edge(nc);
+    std::vector<std::pair<unsigned, unsigned> > edge_vertices;
+    std::vector<unsigned char> edge_full;
+    std::vector<int> corner_halfedge(nc);
+    edge_vertices.reserve(nc);
+    edge_full.reserve(nc);
+    for (unsigned f = 0; f < nf; ++f) {
+      for (unsigned c = offsets[f]; c < offsets[f + 1]; ++c) {
+        unsigned a = indices[c], b = indices[next_corner(f, c)];
+        unsigned lo = std::min(a, b), hi = std::max(a, b);
+        int found = -1;
+        for (unsigned k = bucket[lo]; k < bucket[lo] + bucket_size[lo]; ++k) {
+          const auto& ev = edge_vertices[bucket_edge[k]];
+          if (ev.first + ev.second - lo == hi) {
+            found = bucket_edge[k];
+            break;
+          }
+        }
+        if (found < 0) {
+          bucket_edge[bucket[lo] + bucket_size[lo]++] = edge_vertices.size();
+          corner_halfedge[c] = 2 * edge_vertices.size();
+          edge_vertices.push_back(std::make_pair(a, b));
+          edge_full.push_back(0);
+        } else {
+          if (edge_full[found] || edge_vertices[found].first == a)
+            return false;
+          edge_full[found] = 1;
+          corner_halfedge[c] = 2 * found + 1;
+        }
+      }
+    }
+
+    // build the items
+    unsigned ne = edge_vertices.size();
+    _edges.resize(ne);
+    _faces.resize(nf);
+    std::vector<unsigned> out_degree(nv, 0);
+    for (unsigned f = 0; f < nf; ++f) {
+      unsigned prev_c = offsets[f + 1] - 1;
+      for (unsigned c = offsets[f]; c < offsets[f + 1]; prev_c = c++) {
+        unsigned next_c = next_corner(f, c);
+        HalfedgeHandle heh(corner_halfedge[c]);
+        HalfedgeItem& item = halfedge_item(heh);
+        item._face_handle = FaceHandle(f);
+        item._vertex_handle = VertexHandle(indices[next_c]);
+        item._next_halfedge_handle = HalfedgeHandle(corner_halfedge[next_c]);
+        item._prev_halfedge_handle = HalfedgeHandle(corner_halfedge[prev_c]);
+        VertexItem& vitem = _vertices[indices[c]];
+        if (!vitem._halfedge_handle.is_valid()) vitem._halfedge_handle = heh;
+        ++out_degree[indices[c]];
+      }
+      _faces[f]._halfedge_handle =
+          HalfedgeHandle(corner_halfedge[offsets[f + 1] - 1]);
+    }
+
+    // boundary halfedges, each vertex can start at most one of them
+    bool manifold = true;
+    std::vector<HalfedgeHandle> boundary_out(nv);
+    for (unsigned e = 0; e < ne && manifold; ++e) {
+      if (edge_full[e]) continue;
+      HalfedgeHandle heh(2 * e + 1);
+      halfedge_item(heh)._vertex_handle = VertexHandle(edge_vertices[e].first);
+      unsigned from = edge_vertices[e].second;
+      if (boundary_out[from].is_valid()) manifold = false;
+      boundary_out[from] = heh;
+      _vertices[from]._halfedge_handle = heh;
+      ++out_degree[from];
+    }
+    for (unsigned e = 0; e < ne && manifold; ++e) {
+      if (edge_full[e]) continue;
+      HalfedgeHandle heh(2 * e + 1);
+      HalfedgeHandle next = boundary_out[edge_vertices[e].first];
+      halfedge_item(heh)._next_halfedge_handle = next;
+      halfedge_item(next)._prev_halfedge_handle = heh;
+    }
+
+    // every vertex must have a single fan of faces
+    for (unsigned v = 0; v < nv && manifold; ++v) {
+      HalfedgeHandle start = _vertices[v]._halfedge_handle;
+      if (!start.is_valid()) continue;
+      unsigned count = 0;
+      HalfedgeHandle heh = start;
+      do {
+        heh = next_halfedge_handle(opposite_halfedge_handle(heh));
+      } while (++count <= out_degree[v] && heh != start);
+      manifold = (count == out_degree[v]);
+    }
+
+    if (!manifold) {
+      _edges.clear();
+      _faces.clear();
+      for (unsigned v = 0; v < nv; ++v) _vertices[v] = VertexItem();
+    }
+    return manifold;
+  }
+
  public:
   /** @brief print the halfedge items */
   void print() {
@@ -2144,6 +2304,14 @@ class Graph : public GraphTopology {
     return vertex(vh);
   }
 
+  /**
+   * @brief reserve storage for elements and points
+   */
+  void reserve(unsigned nv, unsigned ne, unsigned nf) {
+    GraphTopology::reserve(nv, ne, nf);
+    _points.reserve(nv);
+  }
+
   /**
    * @brief clear all elements and attributes
    */
@@ -2216,16 +2384,39 @@ class Graph : public GraphTopology {
 
   /** @brief get the writable face attribute */
   FaceAttribute& attribute(FaceHandle fh) {
-    assert(fh.is_valid() && fh.idx() < n_edges());
+    assert(fh.is_valid() && fh.idx() < n_faces());
     if (fh.idx() >= _face_attr.size()) _face_attr.resize(fh.idx() + 1);
-    return _edge_attr[fh.idx()];
+    return _face_attr[fh.idx()];
   }
 
-  /** @brief get a const edge attribute */
+  /** @brief get a const face attribute */
   const FaceAttribute& attribute(FaceHandle fh) const {
-    assert(fh.is_valid() && fh.idx() < n_edges() &&
+    assert(fh.is_valid() && fh.idx() < n_faces() &&
            fh.idx() < _face_attr.size());
-    return _edge_attr[fh.idx()];
+    return _face_attr[fh.idx()];
+  }
+
+  /** @brief all vertex points, used by binary serialization */
+  const std::vector<Point>& points() const { return _points; }
+
+  /** @brief all vertex attributes, may be shorter than the vertices */
+  const std::vector<VertexAttribute>& vertex_attributes() const {
+    return _vertex_attr;
+  }
+
+  /** @brief all halfedge attributes, may be shorter than the halfedges */
+  const std::vector<HalfedgeAttribute>& halfedge_attributes() const {
+    return _halfedge_attr;
+  }
+
+  /** @brief all edge attributes, may be shorter than the edges */
+  const std::vector<EdgeAttribute>& edge_attributes() const {
+    return _edge_attr;
+  }
+
+  /** @brief all face attributes, may be shorter than the faces */
+  const std::vector<FaceAttribute>& face_attributes() const {
+    return _face_attr;
   }
 
  protected:
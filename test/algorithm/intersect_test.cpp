@@ -2,6 +2,9 @@
 
 #include <gtest/gtest.h>
 
+#include <random>
+#include <set>
+
 typedef CMTL::geo2d::Point<mpq_class> Point2R;
 typedef CMTL::geo2d::Box<mpq_class> Box2R;
 typedef CMTL::geo2d::Segment<mpq_class> Segment2R;
@@ -9,6 +12,7 @@ typedef CMTL::geo2d::Line<mpq_class> Line2R;
 typedef CMTL::geo2d::Ray<mpq_class> Ray2R;
 
 using CMTL::algorithm::intersect;
+using CMTL::algorithm::orient_2d;
 
 TEST(IntersectTest, BoxSegment2DIntersectTest) {
   mpq_class tr0, tr1;
@@ -217,4 +221,157 @@ TEST(IntersectTest, SegmentSegmentIntersectTest) {
 
   Segment2R seg16(Point2R(-1, -1), Point2R(2, 2));
   EXPECT_TRUE(intersect(seg1, seg16));
-}
\ No newline at end of file
+}
+
+// compare the batch clipping with the scalar one, end points are on a coarse
+// grid so that many segments are axis parallel, degenerated or touch the box
+template <typename T>
+void check_batch_intersect(unsigned n) {
+  typedef CMTL::geo2d::Point<T> Point;
+  typedef CMTL::geo2d::Segment<T> Segment;
+  std::mt19937 rng(7);
+  std::uniform_int_distribution<int> coord(-4, 12);
+  auto random = [&]() -> T { return T(coord(rng)) / T(8); };
+
+  CMTL::geo2d::Box<T> box(Point(0, 0), Point(1, 1));
+  std::vector<T> x0(n), y0(n), x1(n), y1(n), t0(n), t1(n);
+  std::vector<unsigned char> hit(n);
+  for (unsigned i = 0; i < n; ++i) {
+    x0[i] = random();
+    y0[i] = random();
+    x1[i] = random();
+    y1[i] = random();
+  }
+  size_t n_hits = CMTL::algorithm::intersect_segments(
+      box, x0.data(), y0.data(), x1.data(), y1.data(), n, t0.data(),
+      t1.data(), hit.data());
+  size_t n_expected = 0;
+  for (unsigned i = 0; i < n; ++i) {
+    Segment segment(Point(x0[i], y0[i]), Point(x1[i], y1[i]));
+    if (segment.first() == segment.second()) {
+      bool inside = x0[i] >= 0 && x0[i] <= 1 && y0[i] >= 0 && y0[i] <= 1;
+      EXPECT_EQ(hit[i], inside) << i;
+      n_expected += inside;
+      continue;
+    }
+    T s0, s1;
+    bool expected = intersect(box, segment, s0, s1);
+    ASSERT_EQ(hit[i], expected) << i;
+    n_expected += expected;
+    if (expected) {
+      EXPECT_EQ(t0[i], s0) << i;
+      EXPECT_EQ(t1[i], s1) << i;
+    }
+  }
+  EXPECT_EQ(n_hits, n_expected);
+
+  // one segment against the boxes made by the segments
+  std::vector<T> left(n), right(n), bottom(n), top(n);
+  for (unsigned i = 0; i < n; ++i) {
+    left[i] = std::min(x0[i], x1[i]);
+    right[i] = std::max(x0[i], x1[i]);
+    bottom[i] = std::min(y0[i], y1[i]);
+    top[i] = std::max(y0[i], y1[i]);
+  }
+  Segment segment(Point(T(-1) / T(8), T(3) / T(8)), Point(T(11) / T(8), 1));
+  n_hits = CMTL::algorithm::intersect_boxes(
+      segment, left.data(), right.data(), bottom.data(), top.data(), n,
+      t0.data(), t1.data(), hit.data());
+  n_expected = 0;
+  for (unsigned i = 0; i < n; ++i) {
+    CMTL::geo2d::Box<T> other(left[i], right[i], bottom[i], top[i]);
+    T s0, s1;
+    bool expected = intersect(other, segment, s0, s1);
+    ASSERT_EQ(hit[i], expected) << i;
+    n_expected += expected;
+    if (expected) {
+      EXPECT_EQ(t0[i], s0) << i;
+      EXPECT_EQ(t1[i], s1) << i;
+    }
+  }
+  EXPECT_EQ(n_hits, n_expected);
+}
+
+TEST(IntersectTest, BoxSegmentBatchIntersectTest) {
+  check_batch_intersect<float>(1003);
+  check_batch_intersect<double>(1003);
+  check_batch_intersect<mpq_class>(101);
+}
+
+// compare the sweep with the pairwise predicate, end points are on a small
+// grid so that there are many touching, collinear and vertical segments
+TEST(IntersectTest, SegmentsSweepIntersectTest) {
+  std::mt19937 rng(11);
+  std::uniform_int_distribution<int> coord(0, 6);
+  for (unsigned round = 0; round < 6; ++round) {
+    std::vector<Segment2R> segments;
+    for (unsigned i = 0; i < 24; ++i)
+      segments.emplace_back(Point2R(coord(rng), coord(rng)),
+                            Point2R(coord(rng), coord(rng)));
+    for (bool open : {false, true}) {
+      std::set<std::pair<unsigned, unsigned>> expected, found;
+      for (unsigned i = 0; i < segments.size(); ++i) {
+        for (unsigned j = i + 1; j < segments.size(); ++j) {
+          // the predicate does not handle degenerated segments
+          if (segments[i].first() == segments[i].second() ||
+              segments[j].first() == segments[j].second())
+            continue;
+          if (intersect(segments[i], segments[j], open))
+            expected.insert(std::make_pair(i, j));
+        }
+      }
+      std::vector<CMTL::algorithm::SegmentIntersection<mpq_class>> result;
+      EXPECT_EQ(intersect(segments, result, open), !expected.empty());
+      for (const auto& x : result) {
+        if (segments[x.first].first() == segments[x.first].second() ||
+            segments[x.second].first() == segments[x.second].second())
+          continue;
+        EXPECT_TRUE(found.insert(std::make_pair(x.first, x.second)).second)
+            << "reported twice " << x.first << " " << x.second;
+        // the point lies on both segments
+        for (unsigned s : {x.first, x.second}) {
+          const Segment2R& seg = segments[s];
+          EXPECT_EQ(orient_2d(seg.first(), seg.second(), x.point),
+                    CMTL::ORIENTATION::ON);
+          for (unsigned k = 0; k < 2; ++k) {
+            EXPECT_LE(std::min(seg.first()[k], seg.second()[k]), x.point[k]);
+            EXPECT_GE(std::max(seg.first()[k], seg.second()[k]), x.point[k]);
+          }
+        }
+      }
+      EXPECT_EQ(found, expected) << "round " << round << " open " << open;
+    }
+  }
+
+  // short random segments with rounded crossing points
+  typedef CMTL::geo2d::Point<double> Point2d;
+  typedef CMTL::geo2d::Segment<double> Segment2d;
+  std::uniform_real_distribution<double> position(0, 1), offset(-0.1, 0.1);
+  std::vector<Segment2d> segments2d;
+  for (unsigned i = 0; i < 300; ++i) {
+    Point2d p(position(rng), position(rng));
+    segments2d.emplace_back(p, p + Point2d(offset(rng), offset(rng)));
+  }
+  unsigned n_expected = 0;
+  for (unsigned i = 0; i < segments2d.size(); ++i)
+    for (unsigned j = i + 1; j < segments2d.size(); ++j)
+      n_expected += intersect(segments2d[i], segments2d[j]);
+  std::vector<CMTL::algorithm::SegmentIntersection<double>> result2d;
+  intersect(segments2d, result2d);
+  EXPECT_EQ(result2d.size(), n_expected);
+
+  // crossing diagonals and a free segment
+  std::vector<Segment2R> segments = {
+      Segment2R(Point2R(0, 0), Point2R(2, 2)),
+      Segment2R(Point2R(0, 2), Point2R(2, 0)),
+      Segment2R(Point2R(3, 0), Point2R(4, 1))};
+  std::vector<CMTL::algorithm::SegmentIntersection<mpq_class>> result;
+  EXPECT_TRUE(intersect(segments, result, true, true));
+  ASSERT_EQ(result.size(), 1u);
+  EXPECT_EQ(result[0].first, 0u);
+  EXPECT_EQ(result[0].second, 1u);
+  EXPECT_EQ(result[0].point, Point2R(1, 1));
+  segments.pop_back();
+  segments[1] = Segment2R(Point2R(0, 2), Point2R(1, 1));
+  EXPECT_FALSE(intersect(segments, result, true, true));
+}
@@ -0,0 +1,73 @@
+#include "CMTL/algorithm/intrinsic_delaunay.h"
+
+#include <gtest/gtest.h>
+
+using namespace CMTL::algorithm;
+
+typedef CMTL::geo3d::SurfaceMesh<double> SurfaceMesh;
+
+/* a bumpy sheared grid, the long diagonals make it far from delaunay */
+static void build_grid(SurfaceMesh& sm, unsigned n) {
+  for (unsigned j = 0; j < n; ++j)
+    for (unsigned i = 0; i < n; ++i)
+      sm.add_vertex(SurfaceMesh::Point(i + 0.9 * j, 0.3 * j,
+                                       0.2 * std::sin(i) * std::cos(j)));
+  for (unsigned j = 0; j + 1 < n; ++j) {
+    for (unsigned i = 0; i + 1 < n; ++i) {
+      SurfaceMesh::VertexHandle v00 = sm.vertex_handle(j * n + i);
+      SurfaceMesh::VertexHandle v10 = sm.vertex_handle(j * n + i + 1);
+      SurfaceMesh::VertexHandle v01 = sm.vertex_handle((j + 1) * n + i);
+      SurfaceMesh::VertexHandle v11 = sm.vertex_handle((j + 1) * n + i + 1);
+      sm.add_face(std::vector<SurfaceMesh::VertexHandle>{v00, v10, v11});
+      sm.add_face(std::vector<SurfaceMesh::VertexHandle>{v00, v11, v01});
+    }
+  }
+}
+
+static double polyline_length(
+    const std::vector<IntrinsicTriangulation<double>::Point>& polyline) {
+  double l = 0.;
+  for (unsigned i = 0; i + 1 < polyline.size(); ++i) {
+    auto d = polyline[i + 1] - polyline[i];
+    l += std::sqrt(d * d);
+  }
+  return l;
+}
+
+TEST(IntrinsicDelaunayTest, FlipToDelaunay) {
+  SurfaceMesh sm;
+  build_grid(sm, 8);
+  IntrinsicTriangulation<double> it(sm);
+  for (auto eit = sm.edges_begin(); eit != sm.edges_end(); ++eit)
+    EXPECT_EQ(it.input_edge(*eit), *eit);
+
+  unsigned n_flips = it.flip_to_delaunay();
+  EXPECT_GT(n_flips, 0u);
+  EXPECT_EQ(it.topology().n_faces(), sm.n_faces());
+
+  unsigned n_flipped = 0;
+  const auto& topo = it.topology();
+  for (auto eit = topo.edges_begin(); eit != topo.edges_end(); ++eit) {
+    EXPECT_TRUE(it.is_delaunay(*eit));
+    if (!it.input_edge(*eit).is_valid()) ++n_flipped;
+  }
+  EXPECT_GT(n_flipped, 0u);
+}
+
+TEST(IntrinsicDelaunayTest, Trace) {
+  SurfaceMesh sm;
+  build_grid(sm, 8);
+  IntrinsicTriangulation<double> it = intrinsic_delaunay(sm);
+  const auto& topo = it.topology();
+  for (auto eit = topo.edges_begin(); eit != topo.edges_end(); ++eit) {
+    auto polyline = it.trace(*eit);
+    auto heh = topo.halfedge_handle(*eit, 0);
+    EXPECT_EQ(polyline.front(), sm.point(topo.from_vertex_handle(heh)));
+    EXPECT_EQ(polyline.back(), sm.point(topo.to_vertex_handle(heh)));
+    // a traced edge is a geodesic of the input surface
+    EXPECT_NEAR(polyline_length(polyline), it.length(*eit), 1e-8);
+    if (!it.input_edge(*eit).is_valid()) {
+      EXPECT_GT(polyline.size(), 2u);
+    }
+  }
+}
@@ -24,7 +24,42 @@ void test1() {
   CMTL::io::write_obj(sm, "lawson_flip_test1_after.obj");
 }
 
+void test2() {
+  typedef CMTL::geo2d::SurfaceMesh<double> SurfaceMesh;
+  SurfaceMesh sm;
+  CMTL::io::read_obj(sm, "../mesh_data/leaf.obj");
+  CMTL::algorithm::lawson_flip(sm);
+  // split some interior edges, only the region around them need flipping
+  std::vector<SurfaceMesh::VertexHandle> seed_vertices;
+  for (unsigned i = 0; i < sm.n_edges(); i += 97) {
+    SurfaceMesh::EdgeHandle eh = sm.edge_handle(i);
+    if (sm.is_boundary(eh)) continue;
+    SurfaceMesh::HalfedgeHandle heh = sm.halfedge_handle(eh, 0);
+    auto p0 = sm.point(sm.from_vertex_handle(heh));
+    auto p1 = sm.point(sm.to_vertex_handle(heh));
+    sm.split(eh, p0 * 0.7 + p1 * 0.3);
+    seed_vertices.push_back(sm.vertex_handle(sm.n_vertices() - 1));
+  }
+  CMTL::algorithm::lawson_flip_local(sm, seed_vertices);
+  unsigned non_delaunay = 0;
+  for (auto eit = sm.edges_begin(); eit != sm.edges_end(); ++eit) {
+    if (sm.is_boundary(*eit) || !sm.is_flip_ok(*eit)) continue;
+    SurfaceMesh::HalfedgeHandle h0 = sm.halfedge_handle(*eit, 0);
+    SurfaceMesh::HalfedgeHandle h1 = sm.halfedge_handle(*eit, 1);
+    if (!CMTL::algorithm::is_locally_delaunay(
+            sm.point(sm.to_vertex_handle(sm.next_halfedge_handle(h0))),
+            sm.point(sm.from_vertex_handle(h0)),
+            sm.point(sm.to_vertex_handle(h0)),
+            sm.point(sm.to_vertex_handle(sm.next_halfedge_handle(h1)))))
+      ++non_delaunay;
+  }
+  std::cout << "non delaunay edges after local flip: " << non_delaunay
+            << std::endl;
+  CMTL::io::write_obj(sm, "lawson_flip_test2_after.obj");
+}
+
 int main() {
   test0();
   test1();
+  test2();
 }
\ No newline at end of file
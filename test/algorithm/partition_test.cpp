@@ -15,7 +15,7 @@ TEST(PartitionTest, ConnectedManifoldPartition3DTest) {
   std::vector<std::vector<unsigned>> res1;
   connected_manifold_partition_3d(faces1, res1);
   EXPECT_EQ(res1, std::vector<std::vector<unsigned>>(
-                      {{0, 4, 5, 1, 3, 2}, {6, 11, 10, 9, 7, 8}}));
+                      {{0, 1, 2, 3, 4, 5}, {6, 7, 8, 9, 10, 11}}));
 
   // for(unsigned i = 0; i < res1.size(); ++i) {
   //     for(unsigned j = 0; j < res1[i].size(); ++j) {
@@ -35,7 +35,7 @@ TEST(PartitionTest, ConnectedManifoldPartition3DTest) {
   std::vector<std::vector<std::size_t>> res2;
   connected_manifold_partition_3d(faces2, res2);
   EXPECT_EQ(res2, std::vector<std::vector<std::size_t>>(
-                      {{0, 4, 5, 1, 3, 2}, {6, 9, 7, 10, 11, 8}}));
+                      {{0, 1, 2, 3, 4, 5}, {6, 7, 8, 9, 10, 11}}));
 
   // two cubes sharing an edge
   std::vector<std::vector<int>> faces3 = {
@@ -47,5 +47,102 @@ TEST(PartitionTest, ConnectedManifoldPartition3DTest) {
   std::vector<std::vector<int>> res3;
   connected_manifold_partition_3d(faces3, res3);
   EXPECT_EQ(res3, std::vector<std::vector<int>>(
-                      {{0, 4, 5, 1, 3, 2}, {6, 11, 7, 10, 9, 8}}));
-}
\ No newline at end of file
+                      {{0, 1, 2, 3, 4, 5}, {6, 7, 8, 9, 10, 11}}));
+}
+
+TEST(PartitionTest, ConnectedManifoldPartition3DThreadsTest) {
+  // strips of quads, the strips share their boundary edges with a fin so
+  // every strip is a manifold of its own
+  const unsigned n_strips = 8, n_quads = 500;
+  std::vector<std::vector<unsigned>> faces;
+  for (unsigned s = 0; s < n_strips; ++s) {
+    for (unsigned q = 0; q < n_quads; ++q) {
+      unsigned v = s * (n_quads + 1) + q;
+      faces.push_back({v, v + 1, v + n_quads + 2, v + n_quads + 1});
+    }
+  }
+  unsigned n_vertices = (n_strips + 1) * (n_quads + 1);
+  for (unsigned s = 1; s < n_strips; ++s) {
+    for (unsigned q = 0; q < n_quads; ++q) {
+      unsigned v = s * (n_quads + 1) + q;
+      faces.push_back({v, v + 1, n_vertices + q});
+    }
+  }
+  std::vector<std::vector<unsigned>> res1, res4;
+  connected_manifold_partition_3d(faces, res1, 1);
+  connected_manifold_partition_3d(faces, res4, 4);
+  EXPECT_EQ(res1, res4);
+  // the strips and the fin triangles, which only share non-manifold edges
+  // or vertices
+  ASSERT_EQ(res1.size(), n_strips + (n_strips - 1) * n_quads);
+  for (unsigned s = 0; s < n_strips; ++s) {
+    ASSERT_EQ(res1[s].size(), n_quads);
+    EXPECT_EQ(res1[s].front(), s * n_quads);
+  }
+}
+
+typedef CMTL::geo3d::SurfaceMesh<double> SurfaceMesh;
+
+// n x n grid of quads in the plane z = height
+static void add_grid(SurfaceMesh& sm, unsigned n, double height) {
+  unsigned base = sm.n_vertices();
+  for (unsigned i = 0; i <= n; ++i)
+    for (unsigned j = 0; j <= n; ++j)
+      sm.add_vertex(SurfaceMesh::Point(i, j, height));
+  for (unsigned i = 0; i < n; ++i) {
+    for (unsigned j = 0; j < n; ++j) {
+      unsigned v = base + i * (n + 1) + j;
+      sm.add_face(SurfaceMesh::VertexHandle(v),
+                  SurfaceMesh::VertexHandle(v + n + 1),
+                  SurfaceMesh::VertexHandle(v + n + 2),
+                  SurfaceMesh::VertexHandle(v + 1));
+    }
+  }
+}
+
+TEST(PartitionTest, SurfaceMeshComponentsTest) {
+  SurfaceMesh sm;
+  add_grid(sm, 2, 0);
+  add_grid(sm, 3, 1);
+  for (unsigned i = 0; i < sm.n_faces(); ++i)
+    sm.attribute(SurfaceMesh::FaceHandle(i)).set<unsigned>("id") = i;
+
+  std::vector<int> component;
+  EXPECT_EQ(face_components(sm, component), 2u);
+  EXPECT_EQ(component,
+            std::vector<int>({0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1}));
+
+  std::vector<std::vector<SurfaceMesh::HalfedgeHandle>> loops;
+  boundary_loops(sm, loops);
+  ASSERT_EQ(loops.size(), 2u);
+  EXPECT_EQ(loops[0].size(), 8u);
+  EXPECT_EQ(loops[1].size(), 12u);
+  for (const auto& loop : loops) {
+    for (unsigned i = 0; i < loop.size(); ++i) {
+      EXPECT_TRUE(sm.is_boundary(loop[i]));
+      EXPECT_EQ(sm.to_vertex_handle(loop[i]),
+                sm.from_vertex_handle(loop[(i + 1) % loop.size()]));
+    }
+  }
+
+  std::vector<SurfaceMesh> parts;
+  ASSERT_TRUE(extract_components(sm, parts, 2));
+  ASSERT_EQ(parts.size(), 2u);
+  EXPECT_EQ(parts[0].n_vertices(), 9u);
+  EXPECT_EQ(parts[0].n_faces(), 4u);
+  EXPECT_EQ(parts[1].n_vertices(), 16u);
+  EXPECT_EQ(parts[1].n_faces(), 9u);
+  EXPECT_EQ(parts[1].attribute(SurfaceMesh::FaceHandle(0)).get<unsigned>("id"),
+            4u);
+  for (unsigned i = 0; i < parts[1].n_vertices(); ++i)
+    EXPECT_EQ(parts[1].point(SurfaceMesh::VertexHandle(i)).z(), 1);
+
+  // a sub-mesh made of two opposite corners of the second grid
+  SurfaceMesh sub;
+  EXPECT_TRUE(extract_submesh(
+      sm, {SurfaceMesh::FaceHandle(4), SurfaceMesh::FaceHandle(12)}, sub));
+  EXPECT_EQ(sub.n_vertices(), 8u);
+  EXPECT_EQ(sub.n_faces(), 2u);
+  EXPECT_EQ(sub.attribute(SurfaceMesh::FaceHandle(1)).get<unsigned>("id"),
+            12u);
+}
@@ -0,0 +1,129 @@
+#include "CMTL/algorithm/repair.h"
+
+#include <gtest/gtest.h>
+
+#include <set>
+
+typedef CMTL::geo3d::PolygonSoup<double> PolygonSoup;
+typedef CMTL::geo3d::SurfaceMesh<double> SurfaceMesh;
+typedef CMTL::geo3d::Point<double> Point;
+using namespace CMTL::algorithm;
+
+static unsigned count_boundary_edges(const SurfaceMesh& sm) {
+  unsigned n = 0;
+  for (unsigned i = 0; i < sm.n_edges(); ++i)
+    n += sm.is_boundary(SurfaceMesh::EdgeHandle(i));
+  return n;
+}
+
+TEST(RepairTest, FlipInconsistentPolygonsTest) {
+  // the second triangle has the same direction on the shared edge 1-2
+  std::vector<Point> points = {Point(0, 0, 0), Point(1, 0, 0), Point(0, 1, 0),
+                               Point(1, 1, 0)};
+  PolygonSoup soup(points, std::vector<std::vector<unsigned>>{{0, 1, 2},
+                                                              {1, 2, 3}});
+  SurfaceMesh sm;
+  SoupToMeshReport report;
+  polygon_soup_to_surface_mesh(soup, sm, &report);
+  EXPECT_EQ(sm.n_vertices(), 4u);
+  EXPECT_EQ(sm.n_faces(), 2u);
+  EXPECT_EQ(sm.n_edges(), 5u);
+  EXPECT_EQ(report.n_flipped_polygons, 1u);
+  EXPECT_EQ(report.n_components, 1u);
+  EXPECT_EQ(report.n_rejected_polygons, 0u);
+}
+
+TEST(RepairTest, ClosedCubeTest) {
+  std::vector<Point> points = {Point(0, 0, 0), Point(1, 0, 0), Point(1, 1, 0),
+                               Point(0, 1, 0), Point(0, 0, 1), Point(1, 0, 1),
+                               Point(1, 1, 1), Point(0, 1, 1)};
+  // half of the faces are reversed, the majority keeps its orientation
+  std::vector<std::vector<unsigned>> faces = {
+      {0, 1, 2, 3}, {0, 1, 5, 4}, {1, 5, 6, 2},
+      {3, 2, 6, 7}, {0, 4, 7, 3}, {4, 5, 6, 7}};
+  SurfaceMesh sm;
+  SoupToMeshReport report;
+  polygon_soup_to_surface_mesh(PolygonSoup(points, faces), sm, &report);
+  EXPECT_EQ(sm.n_vertices(), 8u);
+  EXPECT_EQ(sm.n_faces(), 6u);
+  EXPECT_EQ(sm.n_edges(), 12u);
+  EXPECT_EQ(count_boundary_edges(sm), 0u);
+  EXPECT_EQ(report.n_flipped_polygons, 3u);
+  EXPECT_EQ(report.n_non_orientable_edges, 0u);
+}
+
+TEST(RepairTest, NonManifoldTest) {
+  // two triangles touching at vertex 0, a degenerated polygon and a fin of
+  // three triangles on the edge 5-6
+  std::vector<Point> points = {
+      Point(0, 0, 0), Point(1, 0, 0),  Point(1, 1, 0),  Point(-1, 0, 0),
+      Point(-1, -1, 0), Point(2, 0, 0), Point(2, 1, 0), Point(3, 0, 0),
+      Point(3, 1, 1), Point(3, 1, -1)};
+  std::vector<std::vector<unsigned>> faces = {
+      {0, 1, 2}, {0, 3, 4}, {1, 1, 2}, {5, 6, 7}, {6, 5, 8}, {5, 6, 9}};
+  SurfaceMesh sm;
+  SoupToMeshReport report;
+  polygon_soup_to_surface_mesh(PolygonSoup(points, faces), sm, &report);
+  EXPECT_EQ(report.n_removed_polygons, 1u);
+  EXPECT_EQ(report.n_non_manifold_edges, 1u);
+  // vertex 0 is split, and so are 5 and 6 on the cut fin
+  EXPECT_EQ(report.n_duplicated_vertices, 5u);
+  EXPECT_EQ(report.n_rejected_polygons, 0u);
+  EXPECT_EQ(sm.n_faces(), 5u);
+  EXPECT_EQ(sm.n_vertices(), 15u);
+  EXPECT_EQ(count_boundary_edges(sm), 15u);
+}
+
+TEST(RepairTest, MobiusStripTest) {
+  // a strip of 4 quads whose ends are glued with a half twist
+  std::vector<Point> points;
+  for (unsigned i = 0; i < 5; ++i) {
+    points.push_back(Point(i, 0, 0));
+    points.push_back(Point(i, 1, 0));
+  }
+  std::vector<std::vector<unsigned>> faces = {
+      {0, 2, 3, 1}, {2, 4, 5, 3}, {4, 6, 7, 5}, {6, 1, 0, 7}};
+  SurfaceMesh sm;
+  SoupToMeshReport report;
+  polygon_soup_to_surface_mesh(PolygonSoup(points, faces), sm, &report);
+  EXPECT_EQ(report.n_non_orientable_edges, 1u);
+  EXPECT_EQ(report.n_rejected_polygons, 0u);
+  EXPECT_EQ(sm.n_faces(), 4u);
+}
+
+TEST(RepairTest, CleanPSLGTest) {
+  typedef CMTL::geo2d::Point<mpq_class> Point2R;
+  CMTL::geo2d::PSLG<mpq_class> pslg;
+  pslg._points = {Point2R(0, 0), Point2R(2, 2), Point2R(0, 2), Point2R(2, 0),
+                  Point2R(0, 0), Point2R(1, 0), Point2R(3, 0), Point2R(1, -1),
+                  Point2R(1, 3)};
+  pslg._segments = {{0, 1}, {2, 3}, {4, 3}, {5, 6}, {7, 5},
+                    {4, 0}, {1, 0}, {8, 1}};
+  pslg._segmentmarks = {1, 2, 3, 4, 5, 6, 7, 8};
+  CMTL::algorithm::PSLGCleanReport report;
+  CMTL::algorithm::clean_pslg(pslg, &report);
+
+  // point 4 is point 0, segment 4-0 is degenerated and 1-0 is duplicated
+  EXPECT_EQ(report.n_merged_points, 1u);
+  EXPECT_EQ(report.n_removed_segments, 2u);
+  // the diagonals cross at (1, 1), 0-3 and 5-6 overlap on [1, 2] and 7-5
+  // touches 0-3 at 5
+  EXPECT_EQ(report.n_added_points, 1u);
+  EXPECT_EQ(report.n_split_segments, 4u);
+  ASSERT_EQ(pslg._points.size(), 9u);
+  EXPECT_EQ(pslg._points[8], Point2R(1, 1));
+  std::set<std::pair<unsigned, unsigned>> segments;
+  for (const auto& s : pslg._segments)
+    segments.insert(std::minmax(s.first, s.second));
+  EXPECT_EQ(segments, (std::set<std::pair<unsigned, unsigned>>{
+                          {0, 8}, {1, 8}, {2, 8}, {3, 8}, {0, 4},
+                          {3, 4}, {3, 5}, {4, 6}, {1, 7}}));
+  EXPECT_EQ(pslg._segmentmarks.size(), pslg._segments.size());
+
+  // only end points are shared now
+  std::vector<CMTL::geo2d::Segment<mpq_class>> geometry;
+  for (const auto& s : pslg._segments)
+    geometry.emplace_back(pslg._points[s.first], pslg._points[s.second]);
+  std::vector<CMTL::algorithm::SegmentIntersection<mpq_class>> result;
+  EXPECT_FALSE(CMTL::algorithm::intersect(geometry, result, true, true));
+}
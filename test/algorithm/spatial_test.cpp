@@ -0,0 +1,514 @@
+#include "CMTL/algorithm/spatial.h"
+#include "CMTL/geo3d/polygon_soup.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+
+typedef CMTL::geo2d::Point<double> Point2d;
+typedef CMTL::geo2d::Segment<double> Segment2d;
+typedef CMTL::geo2d::Ray<double> Ray2d;
+typedef CMTL::geo2d::Point<mpq_class> Point2R;
+typedef CMTL::geo2d::Box<mpq_class> Box2R;
+typedef CMTL::geo2d::Triangle<mpq_class> Triangle2R;
+typedef CMTL::geo3d::Point<double> Point3d;
+typedef CMTL::geo3d::Point<mpq_class> Point3R;
+
+using namespace CMTL::algorithm;
+
+/* compare every query of a hierarchy with brute force over its primitives */
+template <typename T, typename Primitives>
+void check_bvh(const BVH2D<T, Primitives>& bvh, const Primitives& primitives,
+               std::mt19937& rng, double range) {
+  typedef CMTL::geo2d::Point<T> Point;
+  std::uniform_real_distribution<double> coord(-range, range);
+  auto random_point = [&]() { return Point(T(coord(rng)), T(coord(rng))); };
+  std::vector<unsigned> result, expected;
+  for (unsigned round = 0; round < 20; ++round) {
+    CMTL::geo2d::Box<T> box(random_point(), random_point());
+    bvh.overlap(box, result);
+    expected.clear();
+    for (unsigned i = 0; i < primitives.size(); ++i)
+      if (primitives.overlap(i, box)) expected.push_back(i);
+    std::sort(result.begin(), result.end());
+    EXPECT_EQ(result, expected);
+
+    Point p = random_point(), closest, q;
+    unsigned primitive;
+    ASSERT_TRUE(bvh.closest_point(p, primitive, closest));
+    T best = primitives.squared_distance(0, p, q);
+    for (unsigned i = 1; i < primitives.size(); ++i)
+      best = std::min<T>(best, primitives.squared_distance(i, p, q));
+    EXPECT_EQ(primitives.squared_distance(primitive, p, q), best);
+    EXPECT_EQ((closest - p) * (closest - p), best);
+
+    CMTL::geo2d::Segment<T> segment(random_point(), random_point());
+    bvh.intersect(segment, result);
+    expected.clear();
+    T t, s, first(2);
+    for (unsigned i = 0; i < primitives.size(); ++i) {
+      if (!primitives.hit(i, segment.first(), segment.direction(), true,
+                          T(1), s))
+        continue;
+      expected.push_back(i);
+      first = std::min<T>(first, s);
+    }
+    std::sort(result.begin(), result.end());
+    EXPECT_EQ(result, expected);
+    EXPECT_EQ(bvh.first_hit(segment, primitive, t), !expected.empty());
+    if (!expected.empty()) {
+      EXPECT_EQ(t, first);
+      EXPECT_TRUE(primitives.hit(primitive, segment.first(),
+                                 segment.direction(), true, T(1), s));
+      EXPECT_EQ(s, t);
+    }
+  }
+}
+
+TEST(SpatialTest, SegmentBVH2DTest) {
+  std::mt19937 rng(7);
+  std::uniform_real_distribution<double> coord(0, 200), offset(-2, 2);
+  std::vector<Segment2d> segments;
+  for (unsigned i = 0; i < 6000; ++i) {
+    Point2d p(coord(rng), coord(rng));
+    segments.emplace_back(p, p + Point2d(offset(rng), offset(rng)));
+  }
+  // duplicated and degenerated segments
+  segments.push_back(segments[0]);
+  segments.emplace_back(Point2d(50, 50), Point2d(50, 50));
+
+  BVH2DSegments<double> primitives(segments);
+  SegmentBVH2D<double> bvh(segments, 1);
+  EXPECT_LE(bvh.n_nodes(), 2 * segments.size() - 1);
+  check_bvh(bvh, primitives, rng, 200);
+
+  // the parallel build gives the same tree
+  SegmentBVH2D<double> parallel(segments, 4);
+  ASSERT_EQ(parallel.n_nodes(), bvh.n_nodes());
+  for (unsigned i = 0; i < bvh.n_nodes(); ++i) {
+    EXPECT_EQ(parallel.nodes()[i].index, bvh.nodes()[i].index);
+    EXPECT_EQ(parallel.nodes()[i].count, bvh.nodes()[i].count);
+  }
+
+  // move the segments and refit
+  for (Segment2d& segment : segments) {
+    segment.first() = segment.first() * 0.5 + Point2d(offset(rng), 3);
+    segment.second() = segment.second() * 0.5 + Point2d(offset(rng), 3);
+  }
+  bvh.refit();
+  check_bvh(bvh, primitives, rng, 110);
+
+  // a ray does not stop at the end of its direction
+  std::vector<Segment2d> walls = {Segment2d(Point2d(5, -1), Point2d(5, 1)),
+                                  Segment2d(Point2d(3, -1), Point2d(3, 1)),
+                                  Segment2d(Point2d(-3, -1), Point2d(-3, 1))};
+  SegmentBVH2D<double> wall_bvh(walls);
+  unsigned primitive;
+  double t;
+  ASSERT_TRUE(wall_bvh.first_hit(Ray2d(Point2d(0, 0), Point2d(1, 0)),
+                                 primitive, t));
+  EXPECT_EQ(primitive, 1u);
+  EXPECT_EQ(t, 3);
+  EXPECT_FALSE(wall_bvh.first_hit(Segment2d(Point2d(0, 0), Point2d(2, 0)),
+                                  primitive, t));
+
+  std::vector<Segment2d> empty;
+  SegmentBVH2D<double> empty_bvh(empty);
+  Point2d closest;
+  EXPECT_EQ(empty_bvh.n_nodes(), 0u);
+  EXPECT_FALSE(empty_bvh.closest_point(Point2d(0, 0), primitive, closest));
+}
+
+TEST(SpatialTest, TriangleBVH2DTest) {
+  std::mt19937 rng(11);
+  std::uniform_int_distribution<int> coord(0, 40), offset(-3, 3);
+  std::vector<Triangle2R> triangles;
+  for (unsigned i = 0; i < 150; ++i) {
+    Point2R p(coord(rng), coord(rng));
+    triangles.emplace_back(p, p + Point2R(offset(rng), offset(rng)),
+                           p + Point2R(offset(rng), offset(rng)));
+  }
+  BVH2DTriangles<mpq_class> primitives(triangles);
+  TriangleBVH2D<mpq_class> bvh(triangles);
+  check_bvh(bvh, primitives, rng, 40);
+
+  // a point inside a triangle is its own closest point
+  std::vector<Triangle2R> single = {
+      Triangle2R(Point2R(0, 0), Point2R(4, 0), Point2R(0, 4))};
+  TriangleBVH2D<mpq_class> single_bvh(single);
+  unsigned primitive;
+  Point2R closest;
+  ASSERT_TRUE(single_bvh.closest_point(Point2R(1, 1), primitive, closest));
+  EXPECT_EQ(closest, Point2R(1, 1));
+  ASSERT_TRUE(single_bvh.closest_point(Point2R(3, 3), primitive, closest));
+  EXPECT_EQ(closest, Point2R(2, 2));
+  std::vector<unsigned> result;
+  single_bvh.overlap(Box2R(Point2R(mpq_class(1, 3), mpq_class(1, 3)),
+                           Point2R(mpq_class(2, 3), mpq_class(2, 3))),
+                     result);
+  EXPECT_EQ(result.size(), 1u);
+  single_bvh.overlap(Box2R(Point2R(3, 3), Point2R(4, 4)), result);
+  EXPECT_TRUE(result.empty());
+}
+
+TEST(SpatialTest, PolygonSoupBVH2DTest) {
+  // a grid of unit squares with every other square missing
+  CMTL::geo2d::PolygonSoup<double> soup;
+  for (unsigned i = 0; i <= 30; ++i)
+    for (unsigned j = 0; j <= 30; ++j) soup.add_point(Point2d(i, j));
+  for (unsigned i = 0; i < 30; ++i)
+    for (unsigned j = 0; j < 30; ++j)
+      if ((i + j) % 2 == 0)
+        soup.add_polygon({i * 31 + j, (i + 1) * 31 + j, (i + 1) * 31 + j + 1,
+                          i * 31 + j + 1});
+  BVH2DPolygonSoup<double> primitives(soup);
+  PolygonSoupBVH2D<double> bvh(soup);
+  std::mt19937 rng(13);
+  check_bvh(bvh, primitives, rng, 32);
+
+  unsigned primitive;
+  double t;
+  ASSERT_TRUE(bvh.first_hit(Segment2d(Point2d(0.5, 0.5), Point2d(0.5, 3.5)),
+                            primitive, t));
+  EXPECT_EQ(t, 0);
+  ASSERT_TRUE(bvh.first_hit(Segment2d(Point2d(-1, 1.5), Point2d(3, 1.5)),
+                            primitive, t));
+  EXPECT_EQ(t, 0.5);
+  EXPECT_EQ(soup.polygon(primitive)[0], 32u);
+}
+
+/* a height field of n * n quads over [0, n] x [0, n] */
+template <typename T>
+CMTL::geo3d::SurfaceMesh<T> height_field(unsigned n, std::mt19937& rng) {
+  typedef CMTL::geo3d::SurfaceMesh<T> Mesh;
+  std::uniform_int_distribution<int> height(-4, 4);
+  Mesh sm;
+  std::vector<typename Mesh::VertexHandle> vertices;
+  for (unsigned i = 0; i <= n; ++i)
+    for (unsigned j = 0; j <= n; ++j)
+      vertices.push_back(sm.add_vertex(CMTL::geo3d::Point<T>(
+          T(int(i)), T(int(j)), T(height(rng)) / T(4))));
+  for (unsigned i = 0; i < n; ++i)
+    for (unsigned j = 0; j < n; ++j)
+      sm.add_face(std::vector<typename Mesh::VertexHandle>{
+          vertices[i * (n + 1) + j], vertices[(i + 1) * (n + 1) + j],
+          vertices[(i + 1) * (n + 1) + j + 1], vertices[i * (n + 1) + j + 1]});
+  return sm;
+}
+
+/* compare ray casts and closest points of a tree with brute force over the
+ * fan triangles of the mesh */
+template <typename T>
+void check_aabb_tree(const CMTL::geo3d::SurfaceMesh<T>& sm,
+                     const AABBTree<T>& tree, std::mt19937& rng,
+                     unsigned n_rays) {
+  typedef CMTL::geo3d::Point<T> Point;
+  std::vector<Point> triangles;
+  std::vector<int> faces;
+  for (auto f_it = sm.faces_begin(); f_it != sm.faces_end(); ++f_it) {
+    std::vector<Point> polygon;
+    for (auto fv = sm.fv_begin(*f_it); fv != sm.fv_end(*f_it); ++fv)
+      polygon.push_back(sm.point(*fv));
+    for (unsigned k = 1; k + 1 < polygon.size(); ++k) {
+      triangles.insert(triangles.end(),
+                       {polygon[0], polygon[k], polygon[k + 1]});
+      faces.push_back(f_it->idx());
+    }
+  }
+  ASSERT_EQ(tree.n_triangles(), faces.size());
+
+  CMTL::geo3d::Box<T> box = tree.bounding_box();
+  std::uniform_real_distribution<double> unit(0, 1), dir(-1, 1);
+  auto random_point = [&]() {
+    Point p;
+    for (unsigned k = 0; k < 3; ++k)
+      p[k] = box.min_corner()[k] +
+             T(unit(rng)) * (box.max_corner()[k] - box.min_corner()[k]);
+    return p;
+  };
+  std::vector<Point> origins, directions;
+  for (unsigned i = 0; i < n_rays; ++i) {
+    origins.push_back(random_point());
+    directions.push_back(Point(T(dir(rng)), T(dir(rng)), T(dir(rng))));
+  }
+  std::vector<RayHit<T>> hits;
+  tree.ray_cast(origins, directions, hits);
+  ASSERT_EQ(hits.size(), n_rays);
+  for (unsigned i = 0; i < n_rays; ++i) {
+    CMTL::algorithm::internal::WatertightRay<T> ray(origins[i],
+                                                    directions[i]);
+    bool found = false;
+    T best(0), t;
+    for (unsigned k = 0; k < faces.size(); ++k) {
+      if (!ray.hit(triangles[3 * k], triangles[3 * k + 1],
+                   triangles[3 * k + 2], false, T(0), t))
+        continue;
+      if (!found || t < best) best = t;
+      found = true;
+    }
+    RayHit<T> hit;
+    EXPECT_EQ(tree.ray_cast(origins[i], directions[i], hit), found);
+    EXPECT_EQ(hits[i].face.is_valid(), found);
+    if (!found) continue;
+    EXPECT_EQ(hit.t, best);
+    EXPECT_EQ(hits[i].t, best);
+    // a bounded ray stops before the hit point
+    EXPECT_FALSE(
+        tree.ray_cast(origins[i], directions[i], T(best / T(2)), hit));
+  }
+
+  for (unsigned i = 0; i < 10; ++i) {
+    Point p = random_point(), closest;
+    p[2] += T(dir(rng)) * T(4);
+    CMTL::halfedge::FaceHandle face;
+    ASSERT_TRUE(tree.closest_point(p, face, closest));
+    T best(-1);
+    for (unsigned k = 0; k < faces.size(); ++k) {
+      Point q = CMTL::algorithm::internal::closest_on_triangle(
+          p, triangles[3 * k], triangles[3 * k + 1], triangles[3 * k + 2]);
+      T d = (q - p) * (q - p);
+      if (best < 0 || d < best) best = d;
+    }
+    EXPECT_EQ((closest - p) * (closest - p), best);
+  }
+}
+
+TEST(SpatialTest, AABBTreeTest) {
+  std::mt19937 rng(17);
+  CMTL::geo3d::SurfaceMesh<double> sm = height_field<double>(40, rng);
+  AABBTree<double> tree(sm, 1);
+  EXPECT_EQ(tree.n_triangles(), 2 * 40 * 40u);
+  EXPECT_LE(tree.n_nodes(), 2 * tree.n_triangles() - 1);
+  check_aabb_tree(sm, tree, rng, 200);
+
+  // the parallel build gives the same tree
+  AABBTree<double> parallel(sm, 4);
+  ASSERT_EQ(parallel.n_nodes(), tree.n_nodes());
+  for (unsigned i = 0; i < tree.n_nodes(); ++i) {
+    EXPECT_EQ(parallel.nodes()[i].index, tree.nodes()[i].index);
+    EXPECT_EQ(parallel.nodes()[i].count, tree.nodes()[i].count);
+  }
+
+  // rays through the vertices and edges of a flat grid never slip through
+  CMTL::geo3d::SurfaceMesh<double> flat;
+  std::vector<CMTL::geo3d::SurfaceMesh<double>::VertexHandle> vertices;
+  for (int i = 0; i <= 8; ++i)
+    for (int j = 0; j <= 8; ++j)
+      vertices.push_back(flat.add_vertex(Point3d(0.1 * i, 0.1 * j, 0)));
+  for (int i = 0; i < 8; ++i)
+    for (int j = 0; j < 8; ++j) {
+      flat.add_face(std::vector<CMTL::geo3d::SurfaceMesh<double>::VertexHandle>{
+          vertices[i * 9 + j], vertices[(i + 1) * 9 + j],
+          vertices[(i + 1) * 9 + j + 1]});
+      flat.add_face(std::vector<CMTL::geo3d::SurfaceMesh<double>::VertexHandle>{
+          vertices[i * 9 + j], vertices[(i + 1) * 9 + j + 1],
+          vertices[i * 9 + j + 1]});
+    }
+  AABBTree<double> flat_tree(flat);
+  std::vector<Point3d> origins, directions;
+  std::vector<RayHit<double>> hits;
+  for (int i = 1; i < 16; ++i)
+    for (int j = 1; j < 16; ++j) {
+      origins.push_back(Point3d(0.05 * i, 0.05 * j, 1));
+      directions.push_back(Point3d(0.013 * (i % 3), -0.007 * (j % 2), -1));
+    }
+  flat_tree.ray_cast(origins, directions, hits);
+  for (unsigned i = 0; i < hits.size(); ++i) {
+    EXPECT_TRUE(hits[i].face.is_valid()) << origins[i];
+    EXPECT_EQ(hits[i].t, 1);
+  }
+}
+
+TEST(SpatialTest, ExactAABBTreeTest) {
+  std::mt19937 rng(19);
+  CMTL::geo3d::SurfaceMesh<mpq_class> sm = height_field<mpq_class>(6, rng);
+  AABBTree<mpq_class> tree(sm);
+  check_aabb_tree(sm, tree, rng, 20);
+
+  // a ray through a shared vertex hits exactly there
+  RayHit<mpq_class> hit;
+  Point3R p = sm.point(CMTL::halfedge::VertexHandle(8));
+  ASSERT_TRUE(tree.ray_cast(p + Point3R(0, 0, 10), Point3R(0, 0, -1), hit));
+  EXPECT_EQ(hit.t, 10);
+
+  CMTL::geo3d::SurfaceMesh<mpq_class> empty;
+  AABBTree<mpq_class> empty_tree(empty);
+  CMTL::halfedge::FaceHandle face;
+  Point3R closest;
+  EXPECT_FALSE(empty_tree.ray_cast(Point3R(0, 0, 0), Point3R(1, 0, 0), hit));
+  EXPECT_FALSE(empty_tree.closest_point(Point3R(0, 0, 0), face, closest));
+}
+
+/* compare the queries of a k-d tree with brute force */
+template <typename Point>
+void check_kd_tree(const std::vector<Point>& points,
+                   const std::vector<Point>& queries, unsigned k,
+                   const typename Point::FT& r) {
+  typedef typename Point::FT T;
+  KDTree<Point> tree(points, 1);
+  ASSERT_EQ(tree.size(), points.size());
+  std::vector<unsigned> indices, result;
+  std::vector<T> distances;
+  tree.knn(queries, k, indices, &distances, 3);
+  for (unsigned q = 0; q < queries.size(); ++q) {
+    std::vector<std::pair<T, unsigned>> expected;
+    for (unsigned i = 0; i < points.size(); ++i)
+      expected.emplace_back((points[i] - queries[q]) * (points[i] - queries[q]),
+                            i);
+    std::sort(expected.begin(), expected.end());
+    for (unsigned j = 0; j < k; ++j) {
+      if (j >= points.size()) {
+        EXPECT_EQ(indices[q * k + j], points.size());
+        continue;
+      }
+      EXPECT_EQ(indices[q * k + j], expected[j].second);
+      EXPECT_EQ(distances[q * k + j], expected[j].first);
+    }
+
+    unsigned nearest;
+    T distance;
+    ASSERT_TRUE(tree.nearest(queries[q], nearest, &distance));
+    EXPECT_EQ(nearest, expected[0].second);
+    EXPECT_EQ(distance, expected[0].first);
+
+    tree.radius(queries[q], r, result);
+    std::vector<unsigned> inside;
+    for (const auto& e : expected)
+      if (!(r * r < e.first)) inside.push_back(e.second);
+    std::sort(inside.begin(), inside.end());
+    EXPECT_EQ(result, inside);
+  }
+  std::vector<std::vector<unsigned>> results;
+  tree.radius(queries, r, results, 2);
+  for (unsigned q = 0; q < queries.size(); ++q) {
+    tree.radius(queries[q], r, result);
+    EXPECT_EQ(results[q], result);
+  }
+}
+
+TEST(SpatialTest, KDTreeTest) {
+  std::mt19937 rng(23);
+  std::uniform_real_distribution<double> coord(-10, 10);
+  std::uniform_int_distribution<int> grid(-5, 5);
+
+  std::vector<Point3d> points, queries;
+  for (unsigned i = 0; i < 3000; ++i)
+    points.emplace_back(coord(rng), coord(rng), coord(rng));
+  // duplicated points and points on a grid have equal distances
+  for (unsigned i = 0; i < 500; ++i)
+    points.emplace_back(grid(rng), grid(rng), grid(rng));
+  points.push_back(points[0]);
+  for (unsigned i = 0; i < 50; ++i)
+    queries.emplace_back(coord(rng), coord(rng), coord(rng));
+  for (unsigned i = 0; i < 10; ++i)
+    queries.emplace_back(grid(rng), grid(rng), grid(rng));
+  check_kd_tree(points, queries, 8, 2.5);
+
+  std::vector<Point2R> exact, exact_queries;
+  for (unsigned i = 0; i < 300; ++i)
+    exact.emplace_back(mpq_class(grid(rng), 3), mpq_class(grid(rng), 7));
+  for (unsigned i = 0; i < 20; ++i)
+    exact_queries.emplace_back(mpq_class(grid(rng), 2), grid(rng));
+  check_kd_tree(exact, exact_queries, 5, mpq_class(1, 2));
+
+  // fewer points than neighbours
+  std::vector<Point2R> few = {Point2R(0, 0), Point2R(1, 1)};
+  check_kd_tree(few, exact_queries, 4, mpq_class(1));
+
+  // the parallel build answers the same
+  std::vector<Point3d> many;
+  for (unsigned i = 0; i < 40000; ++i)
+    many.emplace_back(coord(rng), coord(rng), coord(rng));
+  KDTree<Point3d> serial(many, 1), parallel(many, 4);
+  std::vector<unsigned> expected, result;
+  serial.knn(queries, 4, expected);
+  parallel.knn(queries, 4, result);
+  EXPECT_EQ(result, expected);
+
+  KDTree<Point3d> empty(std::vector<Point3d>{});
+  unsigned nearest;
+  EXPECT_FALSE(empty.nearest(Point3d(0, 0, 0), nearest));
+  empty.radius(Point3d(0, 0, 0), 1, result);
+  EXPECT_TRUE(result.empty());
+}
+
+/* compare the queries of a hash grid with brute force */
+template <typename Point>
+void check_hash_grid(const std::vector<Point>& points,
+                     const typename Point::FT& epsilon) {
+  typedef typename Point::FT T;
+  HashGrid<Point> grid(points, epsilon, 1);
+  ASSERT_EQ(grid.size(), points.size());
+  T squared_epsilon = epsilon * epsilon;
+  std::vector<std::pair<unsigned, unsigned>> expected;
+  for (unsigned i = 0; i < points.size(); ++i)
+    for (unsigned j = i + 1; j < points.size(); ++j)
+      if ((points[i] - points[j]) * (points[i] - points[j]) <= squared_epsilon)
+        expected.emplace_back(i, j);
+  std::vector<std::pair<unsigned, unsigned>> pairs, parallel_pairs;
+  grid.close_pairs(pairs, 1);
+  grid.close_pairs(parallel_pairs, 3);
+  EXPECT_EQ(parallel_pairs, pairs);
+  std::sort(pairs.begin(), pairs.end());
+  EXPECT_EQ(pairs, expected);
+
+  std::vector<unsigned> result;
+  for (unsigned i = 0; i < points.size(); i += 13) {
+    grid.neighbors(points[i], result);
+    std::vector<unsigned> close;
+    for (unsigned j = 0; j < points.size(); ++j)
+      if ((points[i] - points[j]) * (points[i] - points[j]) <= squared_epsilon)
+        close.push_back(j);
+    EXPECT_EQ(result, close);
+  }
+}
+
+TEST(SpatialTest, HashGridTest) {
+  std::mt19937 rng(29);
+  std::uniform_real_distribution<double> coord(-10, 10), jitter(-0.05, 0.05);
+
+  // near duplicates of random points
+  std::vector<Point3d> points;
+  for (unsigned i = 0; i < 600; ++i) {
+    points.emplace_back(coord(rng), coord(rng), coord(rng));
+    if (i % 3 == 0)
+      points.push_back(points.back() +
+                       Point3d(jitter(rng), jitter(rng), jitter(rng)));
+  }
+  check_hash_grid(points, 0.1);
+  check_hash_grid(points, 2.0);
+
+  // the default tolerance is far below the extent of the points
+  std::vector<Point3d> large;
+  for (unsigned i = 0; i < 500; ++i) {
+    large.emplace_back(1e3 * coord(rng), 1e3 * coord(rng), coord(rng));
+    if (i % 4 == 0) large.push_back(large.back());
+    if (i % 5 == 0) large.push_back(large.back() + Point3d(0, 0, 1e-14));
+  }
+  check_hash_grid(large, CMTL::numeric_comparator<double>::tolerance());
+
+  // exact equality and exact distances
+  std::uniform_int_distribution<int> grid(-6, 6);
+  std::vector<Point2R> exact;
+  for (unsigned i = 0; i < 200; ++i)
+    exact.emplace_back(mpq_class(grid(rng), 3), mpq_class(grid(rng), 4));
+  check_hash_grid(exact, mpq_class(0));
+  check_hash_grid(exact, mpq_class(1, 4));
+
+  // vertices of a polygon soup and of a surface mesh
+  CMTL::geo3d::PolygonSoup<double> soup;
+  for (unsigned i = 0; i < 300; ++i) {
+    unsigned v = soup.add_point(Point3d(grid(rng), grid(rng), 0));
+    soup.add_point(soup.point(v) + Point3d(0, 0, jitter(rng)));
+    soup.add_triangle(v, v + 1, v);
+  }
+  check_hash_grid(soup.points(), 0.05);
+  CMTL::geo3d::SurfaceMesh<double> sm = height_field<double>(20, rng);
+  check_hash_grid(sm.points(), 0.05);
+
+  HashGrid<Point2R> empty(std::vector<Point2R>{}, mpq_class(1));
+  std::vector<std::pair<unsigned, unsigned>> pairs;
+  empty.close_pairs(pairs);
+  EXPECT_TRUE(pairs.empty());
+}
@@ -1,9 +1,17 @@
 #include "CMTL/algorithm/triangulate_polygon.h"
 
 #include "CMTL/geo2d/polygon.h"
+#include "CMTL/geo2d/polygon_with_holes.h"
 #include "CMTL/io/polygon/write_obj.h"
 #include "CMTL/io/polygon_soup/write_obj.h"
 
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <map>
+#include <random>
 #include <set>
 
 void test1() {
@@ -89,10 +97,348 @@ void test5() {
   }
 }
 
-int main() {
+TEST(TriangulatePolygonTest, EarClippingTest) {
   test1();
   test2();
   test3();
   test4();
   test5();
-}
\ No newline at end of file
+}
+
+/* check that the triangles tile a counterclockwise polygon */
+template <typename T, typename Polygon>
+void check_triangulation(const Polygon& polygon,
+                         const std::vector<std::array<unsigned, 3>>& triangles,
+                         const T& tolerance = T(0)) {
+  ASSERT_EQ(triangles.size(), polygon.size() - 2);
+  T area(0), sum(0);
+  for (unsigned i = 0, j = polygon.size() - 1; i < polygon.size(); j = i++)
+    area += polygon[j] % polygon[i];
+  std::set<unsigned> corners;
+  for (const auto& triangle : triangles) {
+    T twice = (polygon[triangle[1]] - polygon[triangle[0]]) %
+              (polygon[triangle[2]] - polygon[triangle[0]]);
+    EXPECT_GE(twice, T(0));
+    sum += twice;
+    corners.insert(triangle.begin(), triangle.end());
+  }
+  EXPECT_EQ(corners.size(), polygon.size());
+  EXPECT_LE(CMTL::absolute(T(sum - area)), tolerance);
+}
+
+/* star-shaped polygon from random points sorted by angle around the origin */
+template <typename T>
+std::vector<CMTL::geo2d::Point<T>> star_polygon(unsigned n, std::mt19937& rng) {
+  std::uniform_int_distribution<int> coord(-1000, 1000);
+  std::vector<std::pair<double, CMTL::geo2d::Point<T>>> points;
+  for (unsigned i = 0; i < n; ++i) {
+    int x = coord(rng), y = coord(rng);
+    if (x == 0 && y == 0) continue;
+    points.emplace_back(std::atan2(y, x), CMTL::geo2d::Point<T>(x, y));
+  }
+  std::sort(points.begin(), points.end(),
+            [](const auto& p0, const auto& p1) { return p0.first < p1.first; });
+  std::vector<CMTL::geo2d::Point<T>> polygon;
+  for (const auto& p : points) {
+    // drop the points on the same ray from the origin
+    if (!polygon.empty() && polygon.back() % p.second == T(0) &&
+        polygon.back() * p.second > T(0))
+      continue;
+    polygon.push_back(p.second);
+  }
+  return polygon;
+}
+
+TEST(TriangulatePolygonTest, ZOrderEarClippingTest) {
+  typedef CMTL::geo2d::Point<mpq_class> Point2R;
+  CMTL::algorithm::ZOrderEarClippingTag tag;
+  std::vector<std::array<unsigned, 3>> triangles;
+
+  std::mt19937 rng(5);
+  std::vector<Point2R> star = star_polygon<mpq_class>(300, rng);
+  ASSERT_TRUE(CMTL::algorithm::triangulate_polygon_2d(star, triangles, tag));
+  check_triangulation(star, triangles, mpq_class(0));
+
+  // comb with collinear vertices along its base
+  std::vector<Point2R> comb;
+  for (int i = 0; i <= 20; ++i) comb.emplace_back(i, 0);
+  for (int i = 20; i > 0; i -= 2) {
+    comb.emplace_back(i, 10);
+    comb.emplace_back(i - 1, 10);
+    comb.emplace_back(i - 1, 1);
+    comb.emplace_back(i - 2, 1);
+  }
+  comb.back() = Point2R(0, 10);
+  ASSERT_TRUE(CMTL::algorithm::triangulate_polygon_2d(comb, triangles, tag));
+  check_triangulation(comb, triangles, mpq_class(0));
+
+  // square hole bridged to the outer square
+  std::vector<Point2R> bridged = {
+      Point2R(0, 0), Point2R(10, 0), Point2R(10, 10), Point2R(0, 10),
+      Point2R(0, 0), Point2R(3, 3),  Point2R(3, 7),   Point2R(7, 7),
+      Point2R(7, 3), Point2R(3, 3)};
+  ASSERT_TRUE(
+      CMTL::algorithm::triangulate_polygon_2d(bridged, triangles, tag));
+  check_triangulation(bridged, triangles, mpq_class(0));
+
+  std::vector<CMTL::geo2d::Point<double>> large =
+      star_polygon<double>(20000, rng);
+  CMTL::geo2d::Polygon<double> polygon(large);
+  ASSERT_TRUE(CMTL::algorithm::triangulate_polygon_2d(polygon, triangles, tag));
+  check_triangulation(large, triangles, 1e-6);
+}
+
+/* check that the triangles tile a polygon with holes, the constrained ones
+ * being locally Delaunay across the edges which are not on a ring */
+template <typename T>
+void check_triangulation(const CMTL::geo2d::PolygonWithHoles<T>& polygon,
+                         const std::vector<std::array<unsigned, 3>>& triangles,
+                         bool delaunay, const T& tolerance = T(0)) {
+  std::vector<CMTL::geo2d::Point<T>> points;
+  std::set<std::pair<unsigned, unsigned>> ring_edges;
+  for (unsigned r = 0; r <= polygon.n_holes(); ++r) {
+    const CMTL::geo2d::Polygon<T>& ring =
+        r == 0 ? polygon.outer() : polygon.hole(r - 1);
+    unsigned first = points.size();
+    for (unsigned i = 0; i < ring.size(); ++i) {
+      points.push_back(ring[i]);
+      unsigned a = first + i, b = first + (i + 1) % ring.size();
+      ring_edges.emplace(std::min(a, b), std::max(a, b));
+    }
+  }
+  ASSERT_EQ(triangles.size(), points.size() + 2 * polygon.n_holes() - 2);
+
+  T sum(0);
+  std::map<std::pair<unsigned, unsigned>, unsigned> opposite;
+  for (const auto& triangle : triangles) {
+    T twice = (points[triangle[1]] - points[triangle[0]]) %
+              (points[triangle[2]] - points[triangle[0]]);
+    EXPECT_GT(twice, T(0));
+    sum += twice;
+    for (unsigned k = 0; k < 3; ++k) {
+      // each directed edge once
+      auto edge = std::make_pair(triangle[k], triangle[(k + 1) % 3]);
+      EXPECT_TRUE(opposite.emplace(edge, triangle[(k + 2) % 3]).second);
+    }
+  }
+  EXPECT_LE(CMTL::absolute(T(sum - 2 * polygon.area())), tolerance);
+
+  for (const auto& item : opposite) {
+    unsigned a = item.first.first, b = item.first.second;
+    auto twin = opposite.find(std::make_pair(b, a));
+    if (ring_edges.count(std::make_pair(std::min(a, b), std::max(a, b)))) {
+      EXPECT_TRUE(twin == opposite.end());
+      continue;
+    }
+    ASSERT_TRUE(twin != opposite.end());
+    if (delaunay) {
+      EXPECT_TRUE(CMTL::algorithm::is_locally_delaunay(
+          points[a], points[b], points[item.second], points[twin->second]));
+    }
+  }
+}
+
+TEST(TriangulatePolygonTest, PolygonWithHolesTest) {
+  typedef CMTL::geo2d::Point<mpq_class> Point2R;
+  typedef CMTL::geo2d::Polygon<mpq_class> Polygon2R;
+  std::vector<std::array<unsigned, 3>> triangles;
+
+  // square with a clockwise and a counterclockwise hole
+  CMTL::geo2d::PolygonWithHoles<mpq_class> square(Polygon2R(
+      {Point2R(0, 0), Point2R(10, 0), Point2R(10, 10), Point2R(0, 10)}));
+  square.add_hole(Polygon2R(
+      {Point2R(2, 2), Point2R(2, 4), Point2R(4, 4), Point2R(4, 2)}));
+  square.add_hole(Polygon2R(
+      {Point2R(6, 6), Point2R(8, 6), Point2R(8, 8), Point2R(6, 8)}));
+  EXPECT_EQ(square.area(), mpq_class(92));
+  for (bool delaunay : {false, true}) {
+    ASSERT_TRUE(CMTL::algorithm::triangulate_polygon_with_holes_2d(
+        square, triangles, delaunay));
+    check_triangulation(square, triangles, delaunay);
+  }
+
+  // comb whose teeth cross most Delaunay edges, with collinear vertices
+  Polygon2R comb;
+  std::vector<Point2R> teeth;
+  for (int i = 0; i <= 20; ++i) teeth.emplace_back(i, 0);
+  for (int i = 20; i > 0; i -= 2) {
+    teeth.emplace_back(i, 10);
+    teeth.emplace_back(i - 1, 10);
+    teeth.emplace_back(i - 1, 1);
+    teeth.emplace_back(i - 2, 1);
+  }
+  teeth.back() = Point2R(0, 10);
+  CMTL::geo2d::PolygonWithHoles<mpq_class> combed{Polygon2R(teeth)};
+  for (bool delaunay : {false, true}) {
+    ASSERT_TRUE(CMTL::algorithm::triangulate_polygon_with_holes_2d(
+        combed, triangles, delaunay));
+    check_triangulation(combed, triangles, delaunay);
+  }
+
+  // ring of random radii around a grid of jittered square holes
+  std::mt19937 rng(7);
+  std::uniform_real_distribution<double> radius(900, 1000), jitter(-5, 5);
+  std::vector<CMTL::geo2d::Point<double>> ring;
+  for (unsigned i = 0; i < 2000; ++i) {
+    double angle = 2 * M_PI * i / 2000, r = radius(rng);
+    ring.emplace_back(r * std::cos(angle), r * std::sin(angle));
+  }
+  CMTL::geo2d::PolygonWithHoles<double> disk{
+      CMTL::geo2d::Polygon<double>(ring)};
+  for (int x = -500; x <= 500; x += 100) {
+    for (int y = -500; y <= 500; y += 100) {
+      std::vector<CMTL::geo2d::Point<double>> hole;
+      for (int k = 0; k < 4; ++k)
+        hole.emplace_back(x + (k == 1 || k == 2 ? 30 : -30) + jitter(rng),
+                          y + (k < 2 ? -30 : 30) + jitter(rng));
+      disk.add_hole(CMTL::geo2d::Polygon<double>(hole));
+    }
+  }
+  for (bool delaunay : {false, true}) {
+    ASSERT_TRUE(CMTL::algorithm::triangulate_polygon_with_holes_2d(
+        disk, triangles, delaunay));
+    check_triangulation(disk, triangles, delaunay, 1e-6);
+  }
+}
+
+/* best of three times of triangulating a ring of n random radii with a hole */
+double ring_with_hole_time(unsigned n) {
+  std::mt19937 rng(n);
+  std::uniform_real_distribution<double> radius(900, 1000);
+  std::vector<CMTL::geo2d::Point<double>> outer, inner;
+  for (unsigned i = 0; i < n; ++i) {
+    double angle = 2 * M_PI * i / n, r = radius(rng);
+    outer.emplace_back(r * std::cos(angle), r * std::sin(angle));
+    inner.emplace_back(0.5 * r * std::cos(angle), 0.5 * r * std::sin(angle));
+  }
+  CMTL::geo2d::PolygonWithHoles<double> ring(
+      CMTL::geo2d::Polygon<double>(outer),
+      {CMTL::geo2d::Polygon<double>(inner)});
+  std::vector<std::array<unsigned, 3>> triangles;
+  double best = 0;
+  for (int k = 0; k < 3; ++k) {
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_TRUE(
+        CMTL::algorithm::triangulate_polygon_with_holes_2d(ring, triangles));
+    std::chrono::duration<double> time =
+        std::chrono::steady_clock::now() - start;
+    if (k == 0 || time.count() < best) best = time.count();
+  }
+  EXPECT_EQ(triangles.size(), 2 * n);
+  return best;
+}
+
+TEST(TriangulatePolygonTest, PolygonWithHolesScalingTest) {
+  // four times the points cost about four times as much, not sixteen
+  double small = ring_with_hole_time(5000);
+  double large = ring_with_hole_time(20000);
+  EXPECT_LT(large, 8 * small);
+}
+
+/* check that the triangles tile a planar 3d-polygon, with its orientation */
+template <typename T>
+void check_triangulation(
+    const CMTL::geo3d::Polygon<T>& polygon,
+    const std::vector<std::array<unsigned, 3>>& triangles) {
+  ASSERT_EQ(triangles.size(), polygon.size() - 2);
+  CMTL::geo3d::Point<T> normal = polygon.normal(), sum(0, 0, 0);
+  for (const auto& triangle : triangles) {
+    CMTL::geo3d::Point<T> twice =
+        (polygon[triangle[1]] - polygon[triangle[0]]) %
+        (polygon[triangle[2]] - polygon[triangle[0]]);
+    EXPECT_GT(twice * normal, T(0));
+    sum += twice;
+  }
+  EXPECT_EQ(sum, normal);
+}
+
+TEST(TriangulatePolygonTest, MonotonePartitionTest) {
+  typedef CMTL::geo2d::Point<mpq_class> Point2R;
+  typedef CMTL::geo3d::Point<mpq_class> Point3R;
+  CMTL::algorithm::MonotonePartitionTag tag;
+  std::vector<std::array<unsigned, 3>> triangles;
+
+  std::mt19937 rng(11);
+  std::vector<Point2R> star = star_polygon<mpq_class>(300, rng);
+  ASSERT_TRUE(CMTL::algorithm::triangulate_polygon_2d(star, triangles, tag));
+  check_triangulation(star, triangles, mpq_class(0));
+
+  // comb with split and merge vertices, collinear and horizontal edges, then
+  // turned on its side and upside down
+  std::vector<Point2R> comb;
+  for (int i = 0; i <= 20; ++i) comb.emplace_back(i, 0);
+  for (int i = 20; i > 0; i -= 2) {
+    comb.emplace_back(i, 10);
+    comb.emplace_back(i - 1, 10);
+    comb.emplace_back(i - 1, 1);
+    comb.emplace_back(i - 2, 1);
+  }
+  comb.back() = Point2R(0, 10);
+  for (int turn = 0; turn < 4; ++turn) {
+    ASSERT_TRUE(CMTL::algorithm::triangulate_polygon_2d(comb, triangles, tag));
+    check_triangulation(comb, triangles, mpq_class(0));
+    for (Point2R& p : comb) p = Point2R(-p[1], p[0]);
+  }
+
+  // staircase in a tilted plane, clockwise seen from above
+  std::vector<Point3R> stairs;
+  for (int i = 0; i < 10; ++i) {
+    stairs.emplace_back(i, i, 0);
+    stairs.emplace_back(i, i + 1, 0);
+  }
+  stairs.emplace_back(10, 10, 0);
+  stairs.emplace_back(10, 0, 0);
+  for (Point3R& p : stairs) p[2] = p[0] + 2 * p[1];
+  CMTL::geo3d::Polygon<mpq_class> tilted(stairs);
+  ASSERT_TRUE(CMTL::algorithm::triangulate_polygon_3d(tilted, triangles, tag));
+  check_triangulation(tilted, triangles);
+
+  std::vector<CMTL::geo2d::Point<double>> large =
+      star_polygon<double>(20000, rng);
+  ASSERT_TRUE(CMTL::algorithm::triangulate_polygon_2d(large, triangles, tag));
+  check_triangulation(large, triangles, 1e-6);
+
+  // self-intersecting with a positive area, and clockwise, are rejected
+  std::vector<Point2R> crossed = {Point2R(4, 0), Point2R(2, 4), Point2R(0, 0),
+                                  Point2R(0, 3)};
+  EXPECT_FALSE(
+      CMTL::algorithm::triangulate_polygon_2d(crossed, triangles, tag));
+  std::reverse(comb.begin(), comb.end());
+  EXPECT_FALSE(CMTL::algorithm::triangulate_polygon_2d(comb, triangles, tag));
+}
+
+TEST(TriangulatePolygonTest, DominantAxisProjectionTest) {
+  typedef CMTL::geo3d::Point<mpq_class> Point3R;
+  std::vector<std::array<unsigned, 3>> triangles;
+
+  // L-shape in planes dominated by each axis, in both orientations
+  std::vector<std::array<int, 2>> shape = {{0, 0}, {4, 0}, {4, 1},
+                                           {1, 1}, {1, 3}, {0, 3}};
+  for (unsigned axis = 0; axis < 3; ++axis) {
+    for (int sign : {1, -1}) {
+      std::vector<Point3R> points;
+      for (const auto& p : shape) {
+        Point3R q;
+        q[(axis + 1) % 3] = sign * p[0];
+        q[(axis + 2) % 3] = p[1];
+        // tilt the plane without changing its dominant axis
+        q[axis] = mpq_class(p[0] + p[1], 3);
+        points.push_back(q);
+      }
+      CMTL::geo3d::Polygon<mpq_class> polygon(points);
+      ASSERT_TRUE(CMTL::algorithm::triangulate_polygon_3d(
+          polygon, triangles, CMTL::algorithm::EarClippingTag()));
+      check_triangulation(polygon, triangles);
+      ASSERT_TRUE(CMTL::algorithm::triangulate_polygon_3d(
+          polygon, triangles, CMTL::algorithm::ZOrderEarClippingTag()));
+      check_triangulation(polygon, triangles);
+    }
+  }
+
+  // point container
+  std::vector<std::array<double, 3>> square = {
+      {0, 0, 0}, {0, 1, 0}, {0, 1, 1}, {0, 0, 1}};
+  ASSERT_TRUE(CMTL::algorithm::triangulate_polygon_3d<double>(
+      square, triangles, CMTL::algorithm::EarClippingTag()));
+  EXPECT_EQ(triangles.size(), 2);
+}
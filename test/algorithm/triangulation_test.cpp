@@ -2,6 +2,9 @@
 
 #include "CMTL/io/triangulation/write_obj.h"
 
+#include <gtest/gtest.h>
+
+#include <array>
 #include <iostream>
 
 void test1() {
@@ -65,7 +68,7 @@ void test5() {
   CMTL::io::write_obj(T, "triangulation_test5.obj");
 }
 
-int main() {
+TEST(TriangulationTest, DelaunayTest) {
   srand(42);
 
   test1();
@@ -73,5 +76,84 @@ int main() {
   test3();
   test4();
   test5();
-  return 0;
-}
\ No newline at end of file
+}
+
+TEST(TriangulationTest, SegmentMarkTest) {
+  // the bottom segment is split at the point lying on it
+  typedef CMTL::geo2d::Point<double> Point;
+  CMTL::geo2d::PSLG<double> pslg;
+  pslg._points = std::vector<Point>{{0, 0}, {2, 0}, {2, 2}, {0, 2}, {1, 0}};
+  pslg._segments = {{0, 1}, {1, 2}};
+  pslg._segmentmarks = {7, 3};
+  CMTL::algorithm::Triangulation<double> T(pslg);
+  int mark = 0;
+  EXPECT_TRUE(T.segment_mark(0, 4, mark));
+  EXPECT_EQ(mark, 7);
+  EXPECT_TRUE(T.segment_mark(1, 4, mark));
+  EXPECT_EQ(mark, 7);
+  EXPECT_TRUE(T.segment_mark(2, 1, mark));
+  EXPECT_EQ(mark, 3);
+  EXPECT_FALSE(T.segment_mark(0, 1, mark));
+  EXPECT_FALSE(T.segment_mark(2, 3, mark));
+}
+
+/* check that the triangles tile the rectangle [0, 10] x [-2, 2] and that the
+ * segment 0-1 is one of their edges */
+template <typename T>
+void check_segment_recovery() {
+  typedef CMTL::geo2d::Point<T> Point;
+  CMTL::geo2d::PSLG<T> pslg;
+  // the segment crosses the Delaunay edges between the points near it
+  pslg._points = std::vector<Point>{
+      {0, 0},  {10, 0}, {0, -2},    {10, -2},  {10, 2},    {0, 2},
+      {5, 1},  {5, -1}, {3, 0.5},   {7, -0.5}, {2, -0.25}, {8, 0.25}};
+  pslg._segments = {{0, 1}};
+  pslg._segmentmarks = {1};
+  CMTL::algorithm::Triangulation<T> triangulation(pslg);
+  for (bool delaunay : {false, true}) {
+    if (delaunay) triangulation.restore_delaunay();
+    int mark = 0;
+    EXPECT_TRUE(triangulation.segment_mark(0, 1, mark));
+    std::vector<std::array<unsigned, 3>> triangles;
+    triangulation.triangles(triangles);
+    T area = 0;
+    bool has_segment = false;
+    for (const std::array<unsigned, 3>& tri : triangles) {
+      const Point& a = pslg._points[tri[0]];
+      const Point& b = pslg._points[tri[1]];
+      const Point& c = pslg._points[tri[2]];
+      T twice = (b[0] - a[0]) * (c[1] - a[1]) - (b[1] - a[1]) * (c[0] - a[0]);
+      EXPECT_GT(twice, 0);
+      area += twice;
+      for (unsigned i = 0; i < 3; ++i) {
+        if (tri[i] == 0 && tri[(i + 1) % 3] == 1) has_segment = true;
+        if (tri[i] == 1 && tri[(i + 1) % 3] == 0) has_segment = true;
+      }
+    }
+    EXPECT_TRUE(area == 80);
+    EXPECT_TRUE(has_segment);
+  }
+}
+
+TEST(TriangulationTest, SegmentRecoveryTest) {
+  check_segment_recovery<double>();
+#ifdef USE_GMP
+  check_segment_recovery<mpq_class>();
+#endif  // USE_GMP
+}
+
+TEST(TriangulationTest, OpenPolylineTest) {
+  // segments which do not enclose anything carve nothing out
+  typedef CMTL::geo2d::Point<double> Point;
+  CMTL::geo2d::PSLG<double> pslg;
+  pslg._points = std::vector<Point>{{0, 0}, {4, 0}, {4, 4}, {0, 4},
+                                    {1, 1}, {3, 2}, {1, 3}};
+  std::vector<std::array<unsigned, 3>> expected;
+  CMTL::algorithm::Triangulation<double>(pslg).triangles(expected);
+  pslg._segments = {{4, 5}, {5, 6}};
+  CMTL::algorithm::Triangulation<double> T(pslg);
+  std::vector<std::array<unsigned, 3>> triangles;
+  T.triangles(triangles);
+  EXPECT_EQ(triangles.size(), expected.size());
+  EXPECT_EQ(expected.size(), 8u);
+}
@@ -0,0 +1,43 @@
+#include "CMTL/common/z_order.h"
+
+#include <gtest/gtest.h>
+
+TEST(ZOrderTest, CodeTest) {
+  EXPECT_EQ(CMTL::z_order_2d(0, 0), 0u);
+  EXPECT_EQ(CMTL::z_order_2d(1, 0), 1u);
+  EXPECT_EQ(CMTL::z_order_2d(0, 1), 2u);
+  EXPECT_EQ(CMTL::z_order_2d(3, 5), 0x27u);
+  EXPECT_EQ(CMTL::z_order_2d(65535, 65535), 0xFFFFFFFFu);
+}
+
+/* coordinates of a code */
+static void decode(std::uint32_t code, std::uint32_t& x, std::uint32_t& y) {
+  x = y = 0;
+  for (unsigned bit = 0; bit < 16; ++bit) {
+    x |= ((code >> (2 * bit)) & 1) << bit;
+    y |= ((code >> (2 * bit + 1)) & 1) << bit;
+  }
+}
+
+TEST(ZOrderTest, NextInBoxTest) {
+  // from a code out of the box, the next code in it or 0 if none
+  for (std::uint32_t x0 : {0u, 3u, 5u}) {
+    for (std::uint32_t y0 : {0u, 2u, 7u}) {
+      std::uint32_t x1 = x0 + 6, y1 = y0 + 3;
+      auto in_box = [&](std::uint32_t code) {
+        std::uint32_t x, y;
+        decode(code, x, y);
+        return x0 <= x && x <= x1 && y0 <= y && y <= y1;
+      };
+      std::uint32_t lo = CMTL::z_order_2d(x0, y0);
+      std::uint32_t hi = CMTL::z_order_2d(x1, y1);
+      for (std::uint32_t code = lo; code < hi; ++code) {
+        if (in_box(code)) continue;
+        std::uint32_t expected = code + 1;
+        while (!in_box(expected)) ++expected;
+        EXPECT_EQ(CMTL::z_order_2d_next(code, lo, hi), expected) << code;
+      }
+      EXPECT_EQ(CMTL::z_order_2d_next(hi + 1, lo, hi), 0u);
+    }
+  }
+}
@@ -0,0 +1,33 @@
+#include "CMTL/geo3d/box.h"
+
+#include <gtest/gtest.h>
+
+typedef CMTL::geo3d::Point<mpq_class> PointR;
+typedef CMTL::geo3d::Box<mpq_class> BoxR;
+
+TEST(BoxTest, ConstructTest) {
+  BoxR box(PointR(1, -1, 2), PointR(0, 1, -2));
+  EXPECT_EQ(box.min_corner(), PointR(0, -1, -2));
+  EXPECT_EQ(box.max_corner(), PointR(1, 1, 2));
+  EXPECT_EQ(box.length(), 1);
+  EXPECT_EQ(box.width(), 2);
+  EXPECT_EQ(box.height(), 4);
+  EXPECT_EQ(box.volume(), 8);
+  EXPECT_EQ(box.area(), 28);
+  EXPECT_EQ(box.center(), PointR(mpq_class(1, 2), 0, 0));
+}
+
+TEST(BoxTest, ExtendTest) {
+  BoxR box(PointR(0, 0, 0), PointR(1, 1, 1));
+  EXPECT_TRUE(box.contains(PointR(1, 0, mpq_class(1, 2))));
+  EXPECT_FALSE(box.contains(PointR(2, 0, 0)));
+  box.extend(PointR(2, -1, 0));
+  EXPECT_TRUE(box.contains(PointR(2, 0, 0)));
+  EXPECT_EQ(box.min_corner(), PointR(0, -1, 0));
+
+  BoxR other(PointR(3, 3, 3), PointR(4, 4, 4));
+  EXPECT_FALSE(box.overlap(other));
+  box.extend(other);
+  EXPECT_TRUE(box.overlap(other));
+  EXPECT_EQ(box.max_corner(), PointR(4, 4, 4));
+}
@@ -16,4 +16,34 @@ void test1() {
             << other_polygon_soup.n_polygons() << std::endl;
 }
 
-int main() { test1(); }
\ No newline at end of file
+void test2() {
+  std::cout << "test2" << std::endl;
+  typedef CMTL::geo3d::Point<double> Point;
+  CMTL::geo3d::PolygonSoup<double> polygon_soup;
+  polygon_soup.reserve(5, 4, 13);
+  polygon_soup.add_point(Point(0, 0, 0));
+  polygon_soup.add_point(Point(1, 0, 0));
+  polygon_soup.add_point(Point(1, 1, 0));
+  polygon_soup.add_point(Point(0, 1, 0));
+  polygon_soup.add_point(Point(0.5, 0.5, 1));
+  polygon_soup.add_polygon({0, 3, 2, 1});
+  polygon_soup.add_triangle(0, 1, 4);
+  unsigned sides[] = {1, 2, 4, 2, 3, 4};
+  polygon_soup.add_polygons(sides, 2, 3);
+  // flat storage is visible through the polygon views
+  for (unsigned i = 0; i < polygon_soup.n_polygons(); ++i) {
+    auto polygon = polygon_soup.polygon(i);
+    std::cout << polygon.size() << ":";
+    for (unsigned v : polygon) std::cout << " " << v;
+    std::cout << std::endl;
+  }
+  polygon_soup.polygon(1)[2] = 3;
+  std::cout << polygon_soup.polygon(1)[2] << " "
+            << polygon_soup.offsets().back() << " "
+            << polygon_soup.indices().size() << std::endl;
+}
+
+int main() {
+  test1();
+  test2();
+}
\ No newline at end of file
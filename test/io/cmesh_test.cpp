@@ -0,0 +1,84 @@
+#include "CMTL/io/io.h"
+#include "same_mesh.h"
+
+void test1() {
+  typedef CMTL::geo3d::SurfaceMesh<double> Surface_mesh;
+  Surface_mesh sm;
+  CMTL::io::read_obj(sm, "../mesh_data/leaf.obj");
+  CMTL::io::write_cmesh(sm, "cmesh_test1.cmesh");
+  Surface_mesh sm2;
+  bool ok = CMTL::io::read_cmesh(sm2, "cmesh_test1.cmesh");
+  std::cout << "read " << ok << ", "
+            << (same_mesh(sm, sm2) ? "same" : "different") << " mesh"
+            << std::endl;
+
+  // a different number type is rejected
+  CMTL::geo3d::SurfaceMesh<float> sm3;
+  bool float_ok = CMTL::io::read_cmesh(sm3, "cmesh_test1.cmesh");
+  std::cout << "float mesh read " << float_ok << std::endl;
+}
+
+struct IntTraits : public CMTL::halfedge::DefaultTraits {};
+
+void test2() {
+  // trivially copyable attributes are stored too
+  typedef CMTL::geo2d::SurfaceMesh<int, IntTraits> Surface_mesh;
+  Surface_mesh sm;
+  auto v0 = sm.add_vertex(Surface_mesh::Point(0, 0));
+  auto v1 = sm.add_vertex(Surface_mesh::Point(1, 0));
+  auto v2 = sm.add_vertex(Surface_mesh::Point(0, 1));
+  auto fh = sm.add_face(v0, v1, v2);
+  for (unsigned i = 0; i < sm.n_vertices(); ++i)
+    sm.attribute(sm.vertex_handle(i)) = 10 * i;
+  sm.attribute(fh) = 7;
+  CMTL::io::write_cmesh(sm, "cmesh_test2.cmesh");
+  Surface_mesh sm2;
+  CMTL::io::read_cmesh(sm2, "cmesh_test2.cmesh");
+  std::cout << "same mesh " << same_mesh(sm, sm2) << ", attributes";
+  for (unsigned i = 0; i < sm2.n_vertices(); ++i)
+    std::cout << ' ' << sm2.attribute(sm2.vertex_handle(i));
+  std::cout << ' ' << sm2.attribute(sm2.face_handle(0)) << std::endl;
+}
+
+void test3() {
+  // scalar entries of the default Attributes<> are stored by name, the other
+  // value types are reported
+  typedef CMTL::geo3d::SurfaceMesh<double> Surface_mesh;
+  Surface_mesh sm;
+  auto v0 = sm.add_vertex(Surface_mesh::Point(0, 0, 0));
+  auto v1 = sm.add_vertex(Surface_mesh::Point(1, 0, 0));
+  auto v2 = sm.add_vertex(Surface_mesh::Point(0, 1, 0));
+  auto v3 = sm.add_vertex(Surface_mesh::Point(1, 1, 0));
+  auto f0 = sm.add_face(v0, v1, v2);
+  sm.add_face(v2, v1, v3);
+  for (unsigned i = 0; i < sm.n_vertices(); ++i)
+    sm.attribute(sm.vertex_handle(i)).set<unsigned>("id") = 10 * i;
+  sm.attribute(f0).set<double>("weight") = 0.5;
+  sm.attribute(sm.halfedge_handle(f0)).set<bool>("seam") = true;
+  sm.attribute(sm.edge_handle(0)).set<std::string>("name") = "first";
+  CMTL::io::write_cmesh(sm, "cmesh_test3.cmesh");
+  Surface_mesh sm2;
+  bool ok = CMTL::io::read_cmesh(sm2, "cmesh_test3.cmesh");
+  std::cout << "read " << ok << ", same mesh " << same_mesh(sm, sm2)
+            << ", ids";
+  for (unsigned i = 0; i < sm2.n_vertices(); ++i)
+    std::cout << ' ' << sm2.attribute(sm2.vertex_handle(i)).get<unsigned>("id");
+  auto f1 = sm2.face_handle(1);
+  std::cout << ", weight " << sm2.attribute(f0).get<double>("weight")
+            << ", second face weighted "
+            << (f1.idx() < int(sm2.face_attributes().size()) &&
+                sm2.attribute(f1).contain("weight"))
+            << ", seam "
+            << sm2.attribute(sm2.halfedge_handle(f0)).get<bool>("seam")
+            << ", name stored "
+            << (!sm2.edge_attributes().empty() &&
+                sm2.attribute(sm2.edge_handle(0)).contain("name"))
+            << std::endl;
+}
+
+int main() {
+  test1();
+  test2();
+  test3();
+  return 0;
+}
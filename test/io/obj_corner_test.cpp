@@ -0,0 +1,75 @@
+#include "CMTL/io/io.h"
+
+void test1() {
+  // a textured quad split into two triangles, with positive and negative
+  // corner indices
+  std::ofstream fout("obj_corner_test1.obj");
+  fout << "v 0 0 0\nv 1 0 0\nv 1 1 0\nv 0 1 0\n"
+       << "vt 0 0\nvt 1 0\nvt 1 1\nvt 0 1\n"
+       << "vn 0 0 1\n"
+       << "f 1/1/1 2/2/1 3/3/1\n"
+       << "f -4/-4/-1 -2/-2/-1 -1/-1/-1\n";
+  fout.close();
+
+  typedef CMTL::geo3d::SurfaceMesh<double> Surface_mesh;
+  Surface_mesh sm;
+  CMTL::io::ObjCornerAttributes corners;
+  bool ok = CMTL::io::read_obj(sm, "obj_corner_test1.obj", corners);
+  std::cout << "read " << ok << ": " << corners.uv.size() / 2 << " uv "
+            << corners.normal.size() / 3 << " normals" << std::endl;
+  // uv of a corner equals the position of its vertex
+  bool match = true;
+  for (auto fit = sm.faces_begin(); fit != sm.faces_end(); ++fit)
+    for (auto fh = sm.fh_begin(*fit); fh != sm.fh_end(*fit); ++fh) {
+      const auto& p = sm.point(sm.to_vertex_handle(*fh));
+      unsigned h = fh->idx();
+      match = match && corners.uv[2 * h] == p[0] &&
+              corners.uv[2 * h + 1] == p[1] && corners.normal[3 * h + 2] == 1;
+    }
+  std::cout << "uv " << (match ? "match" : "differ") << std::endl;
+
+  // write them back and read again
+  CMTL::io::write_obj(sm, "obj_corner_test1_1.obj", corners);
+  Surface_mesh sm2;
+  CMTL::io::ObjCornerAttributes corners2;
+  CMTL::io::read_obj(sm2, "obj_corner_test1_1.obj", corners2);
+  std::cout << "round trip "
+            << (corners2.uv == corners.uv && corners2.normal == corners.normal
+                    ? "keeps"
+                    : "changes")
+            << " the corners" << std::endl;
+}
+
+void test2() {
+  // files without corners give empty columns
+  CMTL::geo3d::SurfaceMesh<double> sm;
+  CMTL::io::ObjCornerAttributes corners;
+  CMTL::io::read_obj(sm, "../mesh_data/leaf.obj", corners);
+  std::cout << "leaf: " << corners.uv.size() << ' ' << corners.normal.size()
+            << std::endl;
+}
+
+void test3() {
+  // vt and vn ids must refer to records before the face, like v ids
+  const char* contents[] = {"v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1/1 2/2 3/3\n"
+                            "vt 0 0\nvt 1 0\nvt 0 1\n",
+                            "v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1//1 2//1 3//1\n"
+                            "vn 0 0 1\n"};
+  for (const char* content : contents) {
+    std::ofstream fout("obj_corner_test3.obj");
+    fout << content;
+    fout.close();
+    CMTL::geo3d::SurfaceMesh<double> sm;
+    CMTL::io::ObjCornerAttributes corners;
+    bool ok = CMTL::io::read_obj(sm, "obj_corner_test3.obj", corners);
+    std::cout << "forward reference " << (ok ? "accepted" : "rejected")
+              << std::endl;
+  }
+}
+
+int main() {
+  test1();
+  test2();
+  test3();
+  return 0;
+}
@@ -0,0 +1,108 @@
+#include "CMTL/io/io.h"
+#include "same_mesh.h"
+
+void test1() {
+  // binary and ascii round trip with properties
+  typedef CMTL::geo3d::SurfaceMesh<double> Surface_mesh;
+  Surface_mesh sm;
+  CMTL::io::read_obj(sm, "../mesh_data/leaf.obj");
+  CMTL::io::PlyProperties properties;
+  for (unsigned i = 0; i < sm.n_vertices(); ++i)
+    properties.vertex["quality"].push_back(0.5 * i);
+  for (unsigned i = 0; i < sm.n_faces(); ++i)
+    properties.face["label"].push_back(i % 7);
+
+  for (bool binary : {true, false}) {
+    const char* file = binary ? "ply_test1_binary.ply" : "ply_test1_ascii.ply";
+    CMTL::io::write_ply(sm, file, properties, binary);
+    Surface_mesh sm2;
+    CMTL::io::PlyProperties properties2;
+    bool ok = CMTL::io::read_ply(sm2, file, properties2);
+    bool same = ok && same_mesh(sm, sm2) &&
+                properties2.vertex == properties.vertex &&
+                properties2.face == properties.face;
+    std::cout << (binary ? "binary" : "ascii") << " round trip "
+              << (same ? "keeps" : "changes") << " the mesh" << std::endl;
+  }
+}
+
+void test2() {
+  // big endian file with an extra element and a float surface mesh
+  std::ofstream fout("ply_test2.ply", std::ofstream::binary);
+  fout << "ply\nformat binary_big_endian 1.0\ncomment square\n"
+       << "element vertex 4\nproperty float x\nproperty float y\n"
+       << "property float z\nelement face 1\n"
+       << "property list uchar int vertex_indices\n"
+       << "element edge 1\nproperty int vertex1\nproperty int vertex2\n"
+       << "end_header\n";
+  auto put = [&](const void* p, unsigned n) {
+    const char* bytes = static_cast<const char*>(p);
+    for (unsigned i = n; i > 0; --i)
+      fout.put(CMTL::io::internal::is_little_endian() ? bytes[i - 1]
+                                                      : bytes[n - i]);
+  };
+  float coords[] = {0, 0, 0, 1, 0, 0, 1, 1, 0, 0, 1, 0};
+  for (float c : coords) put(&c, 4);
+  fout.put(4);
+  for (int i : {0, 1, 2, 3}) put(&i, 4);
+  for (int i : {0, 1}) put(&i, 4);
+  fout.close();
+
+  CMTL::geo2d::SurfaceMesh<float> sm;
+  bool ok = CMTL::io::read_ply(sm, "ply_test2.ply");
+  std::cout << "big endian: " << ok << ' ' << sm.n_vertices() << " vertices "
+            << sm.n_faces() << " faces, v2 = " << sm.point(sm.vertex_handle(2))
+            << std::endl;
+}
+
+void test3() {
+  // polygon soup through an ascii stream
+  CMTL::geo3d::PolygonSoup<double> soup;
+  CMTL::io::read_obj(soup, "../mesh_data/cube.obj");
+  CMTL::io::write_ply(soup, "ply_test3.ply", CMTL::io::PlyProperties(), false);
+  CMTL::geo3d::PolygonSoup<double> soup2;
+  CMTL::io::read_ply(soup2, "ply_test3.ply");
+  bool same = soup.n_points() == soup2.n_points() &&
+              soup.n_polygons() == soup2.n_polygons();
+  for (unsigned i = 0; same && i < soup.n_points(); ++i)
+    same = soup.point(i) == soup2.point(i);
+  for (unsigned i = 0; same && i < soup.n_polygons(); ++i)
+    same = soup.polygon(i) == soup2.polygon(i);
+  std::cout << "polygon soup round trip " << (same ? "keeps" : "changes")
+            << " the soup" << std::endl;
+}
+
+void test4() {
+  // malformed counts and faces are rejected instead of throwing
+  const std::string header = "ply\nformat ascii 1.0\n";
+  const std::string triangle =
+      "element vertex 3\nproperty float x\nproperty float y\n"
+      "property float z\nelement face 1\n";
+  const std::string data = "end_header\n0 0 0\n1 0 0\n0 1 0\n";
+  const std::string contents[] = {
+      header + "element vertex x\nend_header\n",
+      header + "element vertex 99999999999999999999999\nend_header\n",
+      header + "element vertex 1000000\nproperty float x\nend_header\n0\n",
+      header + triangle + "property int label\n" + data + "7\n",
+      header + triangle + "property list uchar int vertex_indices\n" + data +
+          "3 0 1 2\n"};
+  std::cout << "ply accepted:";
+  for (const std::string& content : contents) {
+    std::vector<CMTL::geo3d::Point<double>> points;
+    std::vector<unsigned> offsets, indices;
+    CMTL::io::PlyProperties properties;
+    bool ok = CMTL::io::internal::parse_ply(
+        content.data(), content.data() + content.size(), points, offsets,
+        indices, properties);
+    std::cout << ' ' << ok;
+  }
+  std::cout << " (only the last one should be)" << std::endl;
+}
+
+int main() {
+  test1();
+  test2();
+  test3();
+  test4();
+  return 0;
+}
@@ -0,0 +1,89 @@
+#include "CMTL/io/io.h"
+#include "CMTL/io/triangulation/write_node.h"
+
+void test1() {
+  // a square with a square hole, 1-based with comments
+  std::ofstream fout("poly_off_test1.poly");
+  fout << "# square with a hole\n"
+       << "8 2 0 1\n"
+       << "1 0 0 1\n2 3 0 1\n3 3 3 1\n4 0 3 1\n"
+       << "5 1 1 2\n6 2 1 2\n7 2 2 2\n8 1 2 2\n"
+       << "\n8 1\n"
+       << "1 1 2 1\n2 2 3 1\n3 3 4 1\n4 4 1 1\n"
+       << "5 5 6 2\n6 6 7 2\n7 7 8 2\n8 8 5 2\n"
+       << "1\n1 1.5 1.5\n";
+  fout.close();
+  CMTL::geo2d::PSLG<double> pslg;
+  bool ok = CMTL::io::read_poly(pslg, "poly_off_test1.poly");
+  std::cout << "read " << ok << ": " << pslg._points.size() << " points "
+            << pslg._segments.size() << " segments " << pslg._holes.size()
+            << " holes, last segment " << pslg._segments.back().first << '-'
+            << pslg._segments.back().second << " mark "
+            << pslg._segmentmarks.back() << std::endl;
+}
+
+void test2() {
+  // triangulate the points of a .node file and write .node/.ele back
+  std::ofstream fout("poly_off_test2.node");
+  fout << "5 2 0 0\n0 0 0\n1 1 0\n2 1 1\n3 0 1\n4 0.5 0.5\n";
+  fout.close();
+  CMTL::geo2d::PSLG<double> pslg;
+  CMTL::io::read_node(pslg, "poly_off_test2.node");
+  CMTL::algorithm::Triangulation<double> T(pslg);
+  CMTL::io::write_node(T, "poly_off_test2_1.node");
+  CMTL::io::write_ele(T, "poly_off_test2_1.ele");
+  CMTL::geo2d::PSLG<double> pslg2;
+  CMTL::io::read_node(pslg2, "poly_off_test2_1.node");
+  bool same = pslg._points == pslg2._points;
+  std::ifstream fin("poly_off_test2_1.ele");
+  unsigned n_triangles;
+  fin >> n_triangles;
+  std::cout << "node round trip " << (same ? "keeps" : "changes")
+            << " the points, " << n_triangles << " triangles" << std::endl;
+}
+
+void test3() {
+  std::ofstream fout("poly_off_test3.off");
+  fout << "OFF\n# tetrahedron\n4 4 6\n"
+       << "0 0 0\n1 0 0\n0 1 0\n0 0 1\n"
+       << "3 0 2 1\n3 0 1 3\n3 1 2 3\n3 0 3 2 255 0 0\n";
+  fout.close();
+  CMTL::geo3d::SurfaceMesh<double> sm;
+  bool ok = CMTL::io::read_off(sm, "poly_off_test3.off");
+  CMTL::geo2d::PolygonSoup<double> soup;
+  CMTL::io::read_off(soup, "poly_off_test3.off");
+  std::cout << "off " << ok << ": " << sm.n_vertices() << " vertices "
+            << sm.n_edges() << " edges " << sm.n_faces() << " faces, soup "
+            << soup.n_points() << ' ' << soup.n_polygons() << std::endl;
+}
+
+void test4() {
+  // counts larger than the data are rejected before any allocation
+  const char* polys[] = {"4000000000 2 0 0\n1 0 0\n",
+                         "3 2 0 0\n1 0 0\n2 1 0\n3 0 1\n4000000000 0\n",
+                         "3 2 0 0\n1 0 0\n2 1 0\n3 0 1\n0 0\n4000000000\n"};
+  std::cout << "poly accepted:";
+  for (const char* content : polys) {
+    std::ofstream("poly_off_test4.poly") << content;
+    CMTL::geo2d::PSLG<double> pslg;
+    std::cout << ' ' << CMTL::io::read_poly(pslg, "poly_off_test4.poly");
+  }
+  const char* offs[] = {"OFF\n4000000000 1 0\n0 0 0\n",
+                        "OFF\n3 4000000000 0\n0 0 0\n1 0 0\n0 1 0\n",
+                        "OFF\n3 1 0\n0 0 0\n1 0 0\n0 1 0\n3 0 1 2"};
+  std::cout << ", off accepted:";
+  for (const char* content : offs) {
+    std::ofstream("poly_off_test4.off") << content;
+    CMTL::geo3d::SurfaceMesh<double> sm;
+    std::cout << ' ' << CMTL::io::read_off(sm, "poly_off_test4.off");
+  }
+  std::cout << std::endl;
+}
+
+int main() {
+  test1();
+  test2();
+  test3();
+  test4();
+  return 0;
+}
@@ -0,0 +1,48 @@
+#include "CMTL/io/io.h"
+#include "same_mesh.h"
+
+void test1() {
+  typedef CMTL::geo3d::SurfaceMesh<double> Surface_mesh;
+  Surface_mesh sm;
+  CMTL::io::read_obj(sm, "../mesh_data/leaf.obj");
+  for (unsigned n_threads = 1; n_threads <= 8; ++n_threads) {
+    Surface_mesh sm2;
+    CMTL::io::read_obj_parallel(sm2, "../mesh_data/leaf.obj", n_threads);
+    std::cout << n_threads << " threads "
+              << (same_mesh(sm, sm2) ? "equals" : "differs from")
+              << " serial reader" << std::endl;
+  }
+}
+
+void test2() {
+  // relative indices across chunks
+  std::ofstream fout("read_obj_parallel_test2.obj");
+  for (unsigned i = 0; i < 1000; ++i) {
+    fout << "v " << i << " 0 0\n";
+    fout << "v " << i << " 1 0\n";
+    if (i > 0) {
+      fout << "f -4 -3 -1\n";
+      fout << "f -4 -1 -2\n";
+    }
+  }
+  fout.close();
+  CMTL::geo3d::PolygonSoup<double> soup;
+  CMTL::io::read_obj(soup, "read_obj_parallel_test2.obj");
+  for (unsigned n_threads = 2; n_threads <= 8; n_threads *= 2) {
+    CMTL::geo3d::PolygonSoup<double> soup2;
+    CMTL::io::read_obj_parallel(soup2, "read_obj_parallel_test2.obj",
+                                n_threads);
+    bool same = soup.n_points() == soup2.n_points() &&
+                soup.n_polygons() == soup2.n_polygons();
+    for (unsigned i = 0; same && i < soup.n_polygons(); ++i)
+      same = soup.polygon(i) == soup2.polygon(i);
+    std::cout << n_threads << " threads "
+              << (same ? "equals" : "differs from") << " serial reader"
+              << std::endl;
+  }
+}
+
+int main() {
+  test1();
+  test2();
+}
@@ -18,7 +18,33 @@ void test2() {
   CMTL::io::write_obj(sm, "read_obj_test2.obj");
 }
 
+void test3() {
+  // the bulk built mesh should equal the one built face by face
+  typedef CMTL::geo3d::SurfaceMesh<double> Surface_mesh;
+  Surface_mesh sm;
+  CMTL::io::read_obj(sm, "../mesh_data/leaf.obj");
+  Surface_mesh sm2;
+  for (auto vit = sm.vertices_begin(); vit != sm.vertices_end(); ++vit)
+    sm2.add_vertex(sm.point(*vit));
+  for (auto fit = sm.faces_begin(); fit != sm.faces_end(); ++fit) {
+    std::vector<Surface_mesh::VertexHandle> fvhs;
+    for (auto fv = sm.fv_begin(*fit); fv != sm.fv_end(*fit); ++fv)
+      fvhs.push_back(*fv);
+    sm2.add_face(fvhs);
+  }
+  bool same = sm.n_edges() == sm2.n_edges() && sm.n_faces() == sm2.n_faces();
+  for (unsigned i = 0; same && i < sm.n_halfedges(); ++i) {
+    auto heh = sm.halfedge_handle(i);
+    same = sm.to_vertex_handle(heh) == sm2.to_vertex_handle(heh) &&
+           sm.next_halfedge_handle(heh) == sm2.next_halfedge_handle(heh) &&
+           sm.face_handle(heh) == sm2.face_handle(heh);
+  }
+  std::cout << "bulk build " << (same ? "equals" : "differs from")
+            << " add_face" << std::endl;
+}
+
 int main() {
   test1();
   test2();
+  test3();
 }
\ No newline at end of file
@@ -0,0 +1,27 @@
+#ifndef __test_io_same_mesh__
+#define __test_io_same_mesh__
+
+/* true if the two meshes have the same points and the same connectivity */
+template <typename SurfaceMesh>
+bool same_mesh(const SurfaceMesh& sm1, const SurfaceMesh& sm2) {
+  if (sm1.n_vertices() != sm2.n_vertices() || sm1.n_edges() != sm2.n_edges() ||
+      sm1.n_faces() != sm2.n_faces())
+    return false;
+  for (unsigned i = 0; i < sm1.n_vertices(); ++i) {
+    auto vh = sm1.vertex_handle(i);
+    if (!(sm1.point(vh) == sm2.point(vh)) ||
+        sm1.halfedge_handle(vh) != sm2.halfedge_handle(vh))
+      return false;
+  }
+  for (unsigned i = 0; i < sm1.n_halfedges(); ++i) {
+    auto heh = sm1.halfedge_handle(i);
+    if (sm1.to_vertex_handle(heh) != sm2.to_vertex_handle(heh) ||
+        sm1.next_halfedge_handle(heh) != sm2.next_halfedge_handle(heh) ||
+        sm1.prev_halfedge_handle(heh) != sm2.prev_halfedge_handle(heh) ||
+        sm1.face_handle(heh) != sm2.face_handle(heh))
+      return false;
+  }
+  return true;
+}
+
+#endif  // __test_io_same_mesh__
@@ -0,0 +1,54 @@
+#include "CMTL/io/io.h"
+
+void test1() {
+  // binary round trip, vertices are welded back
+  typedef CMTL::geo3d::SurfaceMesh<double> Surface_mesh;
+  Surface_mesh sm;
+  CMTL::io::read_obj(sm, "../mesh_data/leaf.obj");
+  CMTL::io::write_stl(sm, "stl_test1.stl");
+  Surface_mesh sm2;
+  bool ok = CMTL::io::read_stl(sm2, "stl_test1.stl");
+  std::cout << "read " << ok << ": " << sm.n_vertices() << ' '
+            << sm.n_faces() << " -> " << sm2.n_vertices() << ' '
+            << sm2.n_faces() << std::endl;
+}
+
+void test2() {
+  // ascii file with slightly perturbed shared vertices
+  std::ofstream fout("stl_test2.stl");
+  fout << "solid square\n"
+       << "facet normal 0 0 1\nouter loop\n"
+       << "vertex 0 0 0\nvertex 1 0 0\nvertex 1 1 0\n"
+       << "endloop\nendfacet\n"
+       << "facet normal 0 0 1\nouter loop\n"
+       << "vertex 0 0 0.000001\nvertex 1.000001 1 0\nvertex 0 1 0\n"
+       << "endloop\nendfacet\n"
+       << "endsolid square\n";
+  fout.close();
+  CMTL::geo3d::SurfaceMesh<double> sm;
+  CMTL::io::read_stl(sm, "stl_test2.stl");
+  std::cout << "exact weld: " << sm.n_vertices() << " vertices" << std::endl;
+  CMTL::io::read_stl(sm, "stl_test2.stl", 1e-4);
+  std::cout << "epsilon weld: " << sm.n_vertices() << " vertices "
+            << sm.n_edges() << " edges" << std::endl;
+}
+
+void test3() {
+  // a vertex close to two welded ones goes to the first inserted, even from
+  // a later cell scan, and huge or NaN coordinates get a cell too
+  CMTL::io::VertexWelder welder(1);
+  welder.insert(1.5, 0, 0);
+  welder.insert(0, 0, 0);
+  unsigned middle = welder.insert(0.75, 0, 0);
+  welder.insert(1e300, -1e300, 0);
+  welder.insert(std::nan(""), 0, 0);
+  std::cout << "welded into " << middle << ", " << welder.size()
+            << " vertices" << std::endl;
+}
+
+int main() {
+  test1();
+  test2();
+  test3();
+  return 0;
+}
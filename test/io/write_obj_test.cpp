@@ -52,8 +52,26 @@ void test2() {
   CMTL::io::write_obj(sm, "write_obj_test2_1.obj");
 }
 
+void test3() {
+  // round trip through a string stream
+  typedef CMTL::geo3d::SurfaceMesh<double> Surface_mesh;
+  Surface_mesh sm;
+  CMTL::io::read_obj(sm, "../mesh_data/leaf.obj");
+  std::stringstream stream;
+  CMTL::io::write_obj(sm, stream);
+  Surface_mesh sm2;
+  CMTL::io::read_surface_mesh(sm2, stream);
+  bool same = sm.n_vertices() == sm2.n_vertices() &&
+              sm.n_faces() == sm2.n_faces();
+  for (unsigned i = 0; same && i < sm.n_vertices(); ++i)
+    same = sm.point(sm.vertex_handle(i)) == sm2.point(sm2.vertex_handle(i));
+  std::cout << "round trip " << (same ? "keeps" : "changes") << " the mesh"
+            << std::endl;
+}
+
 int main() {
   test1();
   test2();
+  test3();
   return 0;
 }
\ No newline at end of file